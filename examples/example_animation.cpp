@@ -0,0 +1,42 @@
+/// @file example_animation.cpp
+/// @brief An example showing how to export an animated GIF, preparing the frames on worker threads.
+/// @copyright Copyright (c) 2025 Enrico Fraccaroli <enry.frak@gmail.com>
+
+#include <cmath>
+#include <gpcpp/animation.hpp>
+#include <gpcpp/gnuplot.hpp>
+#include <vector>
+
+/// @brief The data of a single frame.
+struct wave_t {
+    std::vector<double> x; ///< The x-coordinates.
+    std::vector<double> y; ///< The y-coordinates.
+};
+
+int main()
+{
+    using namespace gpcpp;
+
+    // Create a Gnuplot instance
+    Gnuplot gnuplot(true);
+    gnuplot.set_xrange(0, 10).set_yrange(-1.5, 1.5);
+
+    // A travelling wave, 100 frames long.
+    Animation animation(gnuplot, "example_animation.gif", animation_format_t::gif, 640, 480, 5);
+    animation.render(
+        100,
+        // Prepare the data of a frame, on a worker thread.
+        [](std::size_t frame) {
+            wave_t wave;
+            for (unsigned int i = 0; i < 500; i++) {
+                wave.x.push_back(static_cast<double>(i) * 0.02);
+                wave.y.push_back(std::sin(wave.x.back() - static_cast<double>(frame) * 0.1));
+            }
+            return wave;
+        },
+        // Draw the frame, on the main thread.
+        [](Gnuplot &gp, const wave_t &wave) { gp.plot_xy(wave.x, wave.y, "sin(x - t)"); });
+    animation.finish();
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+/// @file example_cancel_upload.cpp
+/// @brief An example showing how to follow the progress of a long upload, and how to cancel it.
+/// @copyright Copyright (c) 2025 Enrico Fraccaroli <enry.frak@gmail.com>
+
+#include <chrono>
+#include <cmath>
+#include <gpcpp/gnuplot.hpp>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    using namespace gpcpp;
+
+    // A fine grid, which takes a while to write.
+    const std::size_t n = 2000;
+    std::vector<double> x(n), y(n);
+    std::vector<std::vector<double>> z(n, std::vector<double>(n));
+    for (std::size_t i = 0; i < n; i++) {
+        x[i] = y[i] = -3.0 + 6.0 * static_cast<double>(i) / static_cast<double>(n - 1);
+    }
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = 0; j < n; j++) {
+            z[i][j] = std::sin(x[i] * y[j]) * std::exp(-0.1 * (x[i] * x[i] + y[j] * y[j]));
+        }
+    }
+
+    Gnuplot gnuplot;
+    gnuplot.set_title("Cancelled upload");
+
+    // Report the progress, once every 10%.
+    std::size_t last = 0;
+    gnuplot.set_upload_progress([&last](std::size_t written, std::size_t total) {
+        const std::size_t percent = (total > 0) ? (100 * written / total) : 0;
+        if ((written == 0) || (percent >= last + 10)) {
+            last = percent;
+            std::cout << "Uploaded " << percent << "%\n";
+        }
+    });
+
+    // Another thread (e.g., the UI one) cancels the plot once it is superseded.
+    cancel_token_t superseded;
+    gnuplot.set_cancel_token(superseded);
+    std::thread ui([superseded]() mutable {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        superseded.cancel();
+    });
+    gnuplot.plot_3d_grid(x, y, z, "full grid");
+    ui.join();
+    std::cout << "Cancelled: " << (superseded.is_cancelled() ? "yes" : "no")
+              << ", temporary files left: " << gnuplot.get_storage_metrics().resident_files << "\n";
+
+    // The next plot gets a new token, and the session goes on as if nothing happened.
+    std::vector<double> xs, ys;
+    std::vector<std::vector<double>> zs;
+    for (std::size_t i = 0; i < n; i += 20) {
+        xs.push_back(x[i]);
+        ys.push_back(y[i]);
+    }
+    for (std::size_t i = 0; i < n; i += 20) {
+        zs.push_back(std::vector<double>());
+        for (std::size_t j = 0; j < n; j += 20) {
+            zs.back().push_back(z[i][j]);
+        }
+    }
+    last = 0;
+    gnuplot.set_cancel_token(cancel_token_t());
+    gnuplot.set_title("Coarse grid");
+    gnuplot.plot_3d_grid(xs, ys, zs, "coarse grid");
+    gnuplot.show();
+
+    return 0;
+}
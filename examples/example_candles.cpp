@@ -0,0 +1,57 @@
+/// @file example_candles.cpp
+/// @brief An example showing how price ticks are aggregated into candlesticks, at once or while streaming.
+/// @copyright Copyright (c) 2025 Enrico Fraccaroli <enry.frak@gmail.com>
+
+#include <cmath>
+#include <gpcpp/gnuplot.hpp>
+#include <random>
+#include <vector>
+
+int main()
+{
+    using namespace gpcpp;
+
+    // A trading session of 6.5 hours, with two million ticks following a random walk.
+    const std::size_t ticks = 2000000;
+    std::mt19937 generator(42);
+    std::normal_distribution<double> step(0.0, 0.01);
+    std::vector<double> timestamps(ticks), prices(ticks);
+    double price = 100.0;
+    for (std::size_t i = 0; i < ticks; i++) {
+        timestamps[i] = 23400.0 * static_cast<double>(i) / static_cast<double>(ticks);
+        price += step(generator);
+        prices[i] = price;
+    }
+
+    // Five-minute candlesticks: only 78 bars are uploaded.
+    Gnuplot gnuplot;
+    gnuplot.set_title("Session (5 minutes bars)");
+    gnuplot.set_xlabel("Seconds");
+    gnuplot.set_ylabel("Price");
+    gnuplot.plot_candles(timestamps, prices, 300.0, "price");
+    gnuplot.show();
+
+    // The same session as finance bars, one per half hour.
+    Gnuplot bars;
+    bars.set_title("Session (30 minutes bars)");
+    bars.plot_candles(timestamps, prices, 1800.0, "price", candle_style_t::financebars);
+    bars.show();
+
+    // Streaming: the ticks arrive one at a time, and the plot is refreshed every 20000 ticks.
+    // Each refresh rewrites only the newest bar of the file, and appends the new ones, once the
+    // previous refresh has been sent to gnuplot.
+    Gnuplot live;
+    live.set_title("Live session (1 minute bars)");
+    ohlc_stream_t stream(60.0);
+    for (std::size_t i = 0; i < ticks; i++) {
+        stream.push(timestamps[i], prices[i]);
+        if ((i + 1) % 20000 == 0) {
+            live.reset_plot();
+            live.plot_candles(stream, "price");
+            live.flush();
+        }
+    }
+    live.show();
+
+    return 0;
+}
@@ -0,0 +1,39 @@
+/// @file example_frame_budget.cpp
+/// @brief An example showing how a frame budget keeps a live plot responsive as the data grows.
+/// @copyright Copyright (c) 2025 Enrico Fraccaroli <enry.frak@gmail.com>
+
+#include <cmath>
+#include <gpcpp/gnuplot.hpp>
+#include <iostream>
+#include <vector>
+
+int main()
+{
+    gpcpp::Gnuplot gnuplot;
+    gnuplot.set_title("Live signal");
+    gnuplot.set_plot_type(gpcpp::plot_type_t::lines);
+
+    // Each frame should take at most 30 ms, from the first plot until gnuplot has drawn it.
+    gnuplot.set_frame_budget(30.0);
+
+    std::vector<double> x, y;
+    for (unsigned int frame = 0; frame < 60; frame++) {
+        // The signal keeps growing, the level of detail follows.
+        for (unsigned int i = 0; i < 20000; i++) {
+            x.push_back(static_cast<double>(x.size()) * 1e-3);
+            y.push_back(std::sin(x.back()) + 0.1 * std::sin(x.back() * 50.0));
+        }
+        gnuplot.begin_frame();
+        gnuplot.plot_xy(x, y, "signal");
+        gnuplot.end_frame();
+
+        if ((frame % 10) == 9) {
+            const gpcpp::frame_timing_t timing = gnuplot.get_frame_timing();
+            std::cout << x.size() << " samples: " << timing.total_ms() << " ms per frame (serialize "
+                      << timing.serialize_ms << ", transfer " << timing.transfer_ms << ", render " << timing.render_ms
+                      << "), detail " << gnuplot.get_detail_scale() << "\n";
+        }
+    }
+    gnuplot.sync();
+    return 0;
+}
@@ -0,0 +1,51 @@
+/// @file example_multiplot_layout.cpp
+/// @brief An example showing how to arrange several panels with a layout, sharing the uploaded data.
+/// @copyright Copyright (c) 2025 Enrico Fraccaroli <enry.frak@gmail.com>
+
+#include <cmath>
+#include <gpcpp/gnuplot.hpp>
+#include <vector>
+
+int main()
+{
+    using namespace gpcpp;
+
+    // Create a Gnuplot instance
+    Gnuplot gnuplot(true);
+
+    // Prepare data for plotting
+    std::vector<double> x, s, c;
+    for (unsigned int i = 0; i < 200; i++) {
+        x.push_back(static_cast<double>(i) * 0.05); // x[i] = i * 0.05
+        s.push_back(std::sin(x[i]));                // s[i] = sin(x[i])
+        c.push_back(std::cos(x[i]));                // c[i] = cos(x[i])
+    }
+
+    // Upload the data once, every panel references the same file.
+    dataset_t data = gnuplot.upload(x, s, c);
+
+    // A 2x2 grid, where the first panel spans the whole top row.
+    multiplot_layout_t layout(2, 2);
+    layout.set_title("Layout Example").set_shared_x().set_yrange(-1.2, 1.2);
+
+    multiplot_panel_t both(0, 0, 1, 2);
+    both.set_title("Sine and Cosine")
+        .add_series(data, "1:2", "sin(x)", plot_type_t::lines, Color("red"), 2.0)
+        .add_series(data, "1:3", "cos(x)", plot_type_t::lines, Color("blue"), 2.0);
+    layout.add_panel(both);
+
+    multiplot_panel_t sine(1, 0);
+    sine.set_xlabel("x").set_ylabel("sin(x)").add_series(data, "1:2", "", plot_type_t::lines, Color("red"));
+    layout.add_panel(sine);
+
+    multiplot_panel_t cosine(1, 1);
+    cosine.set_xlabel("x").set_ylabel("cos(x)").add_series(data, "1:3", "", plot_type_t::points, Color("blue"));
+    layout.add_panel(cosine);
+
+    // Draw all the panels at once.
+    gnuplot.plot_layout(layout);
+
+    gnuplot.show();
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+/// @file example_nearest_point.cpp
+/// @brief An example showing how to find the sample closest to a position, e.g., the mouse.
+/// @copyright Copyright (c) 2025 Enrico Fraccaroli <enry.frak@gmail.com>
+
+#include <cmath>
+#include <gpcpp/gnuplot.hpp>
+#include <iostream>
+#include <vector>
+
+int main()
+{
+    gpcpp::Gnuplot gnuplot;
+    gnuplot.set_title("Nearest sample");
+    gnuplot.set_xrange(0.0, 100.0).set_yrange(-1.5, 1.5);
+
+    // The series plotted from now on are indexed in the background.
+    gnuplot.set_spatial_index();
+
+    std::vector<double> x, y1, y2;
+    for (unsigned int i = 0; i < 1000000; i++) {
+        x.push_back(static_cast<double>(i) * 1e-4);
+        y1.push_back(std::sin(x.back()));
+        y2.push_back(std::cos(x.back()));
+    }
+    gnuplot.set_plot_type(gpcpp::plot_type_t::lines);
+    gnuplot.plot_xy(x, y1, "sin(x)");
+    gnuplot.plot_xy(x, y2, "cos(x)");
+
+    // With an 800x600 canvas, the size of a pixel scales the distances so that they are measured on screen.
+    const double pixel_x = 100.0 / 800.0;
+    const double pixel_y = 3.0 / 600.0;
+
+    // A position read back from gnuplot (e.g., MOUSE_X and MOUSE_Y), here a fixed one.
+    for (std::size_t series = 0; series < 2; series++) {
+        const gpcpp::nearest_t sample = gnuplot.nearest(series, 42.0, 0.5, pixel_x, pixel_y);
+        if (sample.found) {
+            std::cout << "Series " << series << ": sample " << sample.index << " at (" << sample.x << ", " << sample.y
+                      << "), " << sample.distance << " pixels away.\n";
+        }
+    }
+
+    gnuplot.show();
+    return 0;
+}
@@ -0,0 +1,41 @@
+/// @file example_nonfinite.cpp
+/// @brief An example showing how the missing samples (NaN) of a series are plotted as gaps, or filtered out.
+/// @copyright Copyright (c) 2025 Enrico Fraccaroli <enry.frak@gmail.com>
+
+#include <cmath>
+#include <gpcpp/gnuplot.hpp>
+#include <limits>
+#include <vector>
+
+int main()
+{
+    using namespace gpcpp;
+
+    // A telemetry signal, with some missing samples.
+    std::vector<double> t, v;
+    for (std::size_t i = 0; i < 1000; i++) {
+        const double time = 0.01 * static_cast<double>(i);
+        t.push_back(time);
+        const bool missing = ((i >= 200) && (i < 260)) || ((i >= 610) && (i < 640)) || (i % 97 == 0);
+        v.push_back(missing ? std::numeric_limits<double>::quiet_NaN() : std::sin(time));
+    }
+
+    Gnuplot gnuplot;
+    gnuplot.set_title("Missing samples");
+    gnuplot.set_plot_type(plot_type_t::lines);
+
+    // The default policy breaks the line where the samples are missing.
+    gnuplot.set_nonfinite_policy(nonfinite_policy_t::gap);
+    gnuplot.plot_dataset(gnuplot.upload(t, v), "1:2", "gap");
+
+    // The filter policy joins the samples around the missing ones.
+    std::vector<double> shifted(v.size());
+    for (std::size_t i = 0; i < v.size(); i++) {
+        shifted[i] = v[i] - 0.5;
+    }
+    gnuplot.set_nonfinite_policy(nonfinite_policy_t::filter);
+    gnuplot.plot_xy(t, shifted, "filter (shifted)");
+    gnuplot.show();
+
+    return 0;
+}
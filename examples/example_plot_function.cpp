@@ -0,0 +1,29 @@
+/// @file example_plot_function.cpp
+/// @brief An example showing how to plot C++ functions, sampled adaptively or on evenly spaced points.
+/// @copyright Copyright (c) 2025 Enrico Fraccaroli <enry.frak@gmail.com>
+
+#include <cmath>
+#include <gpcpp/gnuplot.hpp>
+#include <iostream>
+
+int main()
+{
+    using namespace gpcpp;
+
+    // A function which oscillates faster and faster towards zero.
+    auto chirp = [](double x) { return std::sin(1.0 / x); };
+
+    // The adaptive sampler places the points where the function bends.
+    const sampled_function_t adaptive = sample_adaptive(chirp, 0.01, 1.0, 1e-3);
+    std::cout << "Adaptive sampling used " << adaptive.x.size() << " points.\n";
+
+    Gnuplot gnuplot;
+    gnuplot.set_title("sin(1/x)");
+    gnuplot.set_plot_type(plot_type_t::lines);
+    gnuplot.plot_function(chirp, 0.01, 1.0, 1e-3, "adaptive");
+    // The same number of evenly spaced points, for comparison.
+    gnuplot.plot_function_samples([](double x) { return std::sin(1.0 / x) - 2.5; }, 0.01, 1.0, adaptive.x.size(), "uniform (shifted)");
+    gnuplot.show();
+
+    return 0;
+}
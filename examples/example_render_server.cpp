@@ -0,0 +1,39 @@
+/// @file example_render_server.cpp
+/// @brief An example showing how to render figures through a local render server.
+/// @copyright Copyright (c) 2025 Enrico Fraccaroli <enry.frak@gmail.com>
+
+#include <cmath>
+#include <gpcpp/render_server.hpp>
+#include <string>
+#include <vector>
+
+int main()
+{
+    using namespace gpcpp;
+
+    // Usually the server runs in its own long-lived process, here it shares the process of the client.
+    RenderServer server(RenderServer::default_socket_path(), 2);
+    if (!server.start()) {
+        return 1;
+    }
+
+    // The client does not start gnuplot, it only shares its data and sends the commands.
+    RenderClient client(server.get_socket_path());
+    std::vector<double> x, y;
+    for (unsigned int i = 0; i < 1000; i++) {
+        x.push_back(static_cast<double>(i) * 0.01);
+        y.push_back(std::sin(x.back()));
+    }
+    for (unsigned int figure = 0; figure < 3; figure++) {
+        for (std::size_t i = 0; i < x.size(); i++) {
+            y[i] = std::sin(x[i] + static_cast<double>(figure));
+        }
+        const dataset_t data = client.share(x, y);
+        client.send_cmd("set terminal pngcairo size 640,480");
+        client.send_cmd("set output \"example_render_server_" + std::to_string(figure) + ".png\"");
+        client.send_cmd("plot " + data.get_declaration() + " using 1:2 with lines title \"sin(x + t)\"");
+        client.render();
+    }
+
+    return 0;
+}
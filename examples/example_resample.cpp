@@ -0,0 +1,37 @@
+/// @file example_resample.cpp
+/// @brief An example showing how to align series sampled at different rates, and plot them from a single dataset.
+/// @copyright Copyright (c) 2025 Enrico Fraccaroli <enry.frak@gmail.com>
+
+#include <cmath>
+#include <gpcpp/gnuplot.hpp>
+#include <vector>
+
+int main()
+{
+    using namespace gpcpp;
+
+    // Three signals sampled at different rates, over different intervals.
+    std::vector<std::vector<double>> t(3), v(3);
+    const double periods[] = {0.01, 0.037, 0.25};
+    for (std::size_t k = 0; k < 3; k++) {
+        for (double time = 0.1 * static_cast<double>(k); time <= 10.0; time += periods[k]) {
+            t[k].push_back(time);
+            v[k].push_back(std::sin(time + static_cast<double>(k)) * (1.0 + 0.1 * static_cast<double>(k)));
+        }
+    }
+
+    // Align them on an evenly spaced grid (union_grid(t) would keep every original sample instead).
+    aligned_series_t aligned(linear_grid(0.0, 10.0, 2000));
+    aligned.add(t[0], v[0], interpolation_t::linear);
+    aligned.add(t[1], v[1], interpolation_t::linear);
+    aligned.add(t[2], v[2], interpolation_t::nearest);
+
+    // The three series are uploaded once, as a four-column dataset.
+    Gnuplot gnuplot;
+    gnuplot.set_title("Aligned series");
+    gnuplot.set_plot_type(plot_type_t::lines);
+    gnuplot.plot_aligned(aligned, {"10 ms, linear", "37 ms, linear", "250 ms, nearest"});
+    gnuplot.show();
+
+    return 0;
+}
@@ -0,0 +1,43 @@
+/// @file example_scatter_plot_variable.cpp
+/// @brief An example demonstrating how to plot a scatter plot where each point
+/// has its own color and size, using a single series.
+/// @copyright Copyright (c) 2025 Enrico Fraccaroli <enry.frak@gmail.com>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <gpcpp/gnuplot.hpp>
+
+int main()
+{
+    using namespace gpcpp;
+
+    // Create a Gnuplot instance
+    Gnuplot gnuplot(true);
+
+    // One color for each category.
+    const std::vector<Color> palette = {
+        Color("red"), Color("green"), Color("blue"), Color("magenta"), Color("cyan"),
+    };
+
+    // Prepare data for plotting
+    std::vector<double> x, y, sizes;
+    std::vector<unsigned int> colors;
+    for (unsigned int i = 0; i < 200; i++) {
+        x.push_back(static_cast<double>(i) * 0.1);                  // x[i] = i * 0.1
+        y.push_back(std::sin(x[i]) + 0.1 * std::cos(7.0 * x[i]));   // y[i] = sin(x[i]) + noise
+        sizes.push_back(0.5 + std::fabs(y[i]));                     // Bigger points for bigger values
+        colors.push_back(palette[i % palette.size()].to_integer()); // Category of the point
+    }
+
+    // Plot all the categories as a single series.
+    gnuplot
+        .set_grid()                                  // Show the grid.
+        .set_plot_type(plot_type_t::points)          // Set the plot type to points.
+        .set_point_type(point_type_t::filled_circle) // Set filled circle for points
+        .plot_xy_color_size(x, y, colors, sizes)     // Plot the points with their colors and sizes
+        .show();
+
+    return 0;
+}
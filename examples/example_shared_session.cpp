@@ -0,0 +1,61 @@
+/// @file example_shared_session.cpp
+/// @brief An example showing how several threads can plot on the same gnuplot session.
+/// @copyright Copyright (c) 2025 Enrico Fraccaroli <enry.frak@gmail.com>
+
+#include <cmath>
+#include <gpcpp/shared_session.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    using namespace gpcpp;
+
+    SharedSession session;
+    session.send_cmd("set title \"Curves computed by different threads\"");
+    session.send_cmd("set grid");
+
+    // Each thread computes its own curve, the owner thread of the session writes them to gnuplot.
+    std::vector<std::vector<double>> curves(4);
+    std::vector<double> x;
+    for (unsigned int i = 0; i < 200; i++) {
+        x.push_back(static_cast<double>(i) * 0.05);
+    }
+    std::vector<std::thread> producers;
+    for (std::size_t t = 0; t < curves.size(); t++) {
+        producers.emplace_back([&curves, &x, t]() {
+            for (double value : x) {
+                curves[t].push_back(std::sin(value + static_cast<double>(t) * 0.5));
+            }
+        });
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+
+    // All the curves of the figure are plotted by a single frame, which other threads cannot split.
+    session.submit_frame([curves, x](Gnuplot &gp) {
+        for (std::size_t t = 0; t < curves.size(); t++) {
+            gp.set_line_width(2).plot_xy(x, curves[t], "thread " + std::to_string(t));
+        }
+        gp.show();
+    });
+
+    // Several threads can also send operations at the same time, each keeping its own order.
+    producers.clear();
+    for (std::size_t t = 0; t < 4; t++) {
+        producers.emplace_back([&session, t]() {
+            for (unsigned int i = 0; i < 10; i++) {
+                session.send_cmd("# thread " + std::to_string(t) + ", command " + std::to_string(i));
+            }
+        });
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+    session.wait();
+
+    std::cout << "Executed " << session.operations() << " operations in " << session.batches() << " batches.\n";
+    return 0;
+}
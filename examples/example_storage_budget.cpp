@@ -0,0 +1,51 @@
+/// @file example_storage_budget.cpp
+/// @brief An example showing how to bound the storage used by the data of a long-running session.
+/// @copyright Copyright (c) 2025 Enrico Fraccaroli <enry.frak@gmail.com>
+
+#include <cmath>
+#include <gpcpp/gnuplot.hpp>
+#include <iostream>
+#include <vector>
+
+int main()
+{
+    using namespace gpcpp;
+
+    Gnuplot gnuplot;
+    gnuplot.set_plot_type(plot_type_t::lines);
+
+    // At most 4 MiB of temporary files; the data that does not fit is written with fewer records.
+    gnuplot.set_storage_budget(4U << 20U, storage_policy_t::degrade);
+
+    // A dataset uploaded once, and plotted again later.
+    std::vector<double> x(100000), y(100000);
+    for (std::size_t i = 0; i < x.size(); i++) {
+        x[i] = 0.0001 * static_cast<double>(i);
+        y[i] = std::sin(x[i]);
+    }
+    const dataset_t reference = gnuplot.upload(x, y);
+
+    // Many figures, each one with new data: the files of the previous figures are evicted, least
+    // recently used first, while those of the current figure are kept.
+    for (int figure = 0; figure < 100; figure++) {
+        for (std::size_t i = 0; i < y.size(); i++) {
+            y[i] = std::sin(x[i] + 0.1 * figure);
+        }
+        gnuplot.reset_plot();
+        gnuplot.set_title("Figure " + std::to_string(figure));
+        gnuplot.plot_xy(x, y, "signal");
+        gnuplot.plot_dataset(gnuplot.upload(x, y), "1:2", "copy");
+    }
+
+    // The reference dataset has been evicted long ago, so it must be uploaded again.
+    gnuplot.plot_dataset(reference, "1:2", "reference");
+    gnuplot.show();
+
+    const storage_metrics_t metrics = gnuplot.get_storage_metrics();
+    std::cout << "Resident: " << metrics.resident_files << " files, " << metrics.resident_bytes << " bytes\n";
+    std::cout << "Peak:     " << metrics.peak_resident_bytes << " bytes\n";
+    std::cout << "Evicted:  " << metrics.evicted_files << " files, " << metrics.evicted_bytes << " bytes\n";
+    std::cout << "Degraded: " << metrics.degraded << " writes\n";
+
+    return 0;
+}
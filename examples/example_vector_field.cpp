@@ -0,0 +1,77 @@
+/// @file example_vector_field.cpp
+/// @brief An example showing how a large vector field is plotted with a readable number of arrows.
+/// @copyright Copyright (c) 2025 Enrico Fraccaroli <enry.frak@gmail.com>
+
+#include <cmath>
+#include <gpcpp/gnuplot.hpp>
+#include <vector>
+
+int main()
+{
+    using namespace gpcpp;
+
+    // The velocity field of two counter-rotating vortices, sampled on a fine grid.
+    const std::size_t n = 1000;
+    std::vector<double> x, y, u, v;
+    x.reserve(n * n);
+    y.reserve(n * n);
+    u.reserve(n * n);
+    v.reserve(n * n);
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = 0; j < n; j++) {
+            const double px = -2.0 + 4.0 * static_cast<double>(i) / static_cast<double>(n - 1);
+            const double py = -2.0 + 4.0 * static_cast<double>(j) / static_cast<double>(n - 1);
+            double vx = 0.0, vy = 0.0;
+            const double centers[] = {-0.8, 0.8};
+            for (std::size_t k = 0; k < 2; k++) {
+                const double rx = px - centers[k], ry = py;
+                const double r2 = rx * rx + ry * ry + 0.05;
+                const double s  = (k == 0) ? 1.0 : -1.0;
+                vx += -s * ry / r2;
+                vy += s * rx / r2;
+            }
+            x.push_back(px);
+            y.push_back(py);
+            u.push_back(0.05 * vx);
+            v.push_back(0.05 * vy);
+        }
+    }
+
+    // A million arrows would be unreadable: keep about 900 of them, one per cell of a regular grid.
+    Gnuplot gnuplot;
+    gnuplot.set_title("Two vortices (grid subsampling)");
+    gnuplot.set_line_color("blue");
+    gnuplot.plot_vectors(x, y, u, v, "velocity", 900, vector_sampling_t::grid);
+    gnuplot.show();
+
+    // Keeping the longest arrow of each cell highlights the cores of the vortices.
+    Gnuplot strongest;
+    strongest.set_title("Two vortices (magnitude-aware subsampling)");
+    strongest.set_line_color("red");
+    strongest.plot_vectors(x, y, u, v, "velocity", 900, vector_sampling_t::magnitude);
+    strongest.show();
+
+    // A 3D swirl, rising along the z axis.
+    std::vector<double> x3, y3, z3, u3, v3, w3;
+    for (std::size_t i = 0; i < 40; i++) {
+        for (std::size_t j = 0; j < 40; j++) {
+            for (std::size_t k = 0; k < 40; k++) {
+                const double px = -1.0 + 2.0 * static_cast<double>(i) / 39.0;
+                const double py = -1.0 + 2.0 * static_cast<double>(j) / 39.0;
+                const double pz = static_cast<double>(k) / 39.0;
+                x3.push_back(px);
+                y3.push_back(py);
+                z3.push_back(pz);
+                u3.push_back(-0.1 * py);
+                v3.push_back(0.1 * px);
+                w3.push_back(0.05 * (1.0 - px * px - py * py));
+            }
+        }
+    }
+    Gnuplot swirl;
+    swirl.set_title("Swirl");
+    swirl.plot_vectors_3d(x3, y3, z3, u3, v3, w3, "velocity", 1000);
+    swirl.show();
+
+    return 0;
+}
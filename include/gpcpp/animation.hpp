@@ -0,0 +1,183 @@
+/// @file animation.hpp
+/// @brief Exports animations as animated GIFs or as sequences of PNG files.
+
+#pragma once
+
+#include "gpcpp/gnuplot.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace gpcpp
+{
+
+/// @brief The kind of file produced by an animation.
+enum class animation_format_t : unsigned char {
+    gif,          ///< A single animated GIF.
+    png_sequence, ///< One numbered PNG file per frame.
+};
+
+/// @brief Renders a sequence of frames to an animated GIF or to numbered PNG files.
+/// @details The terminal is configured once, and every frame goes through the frame pipeline of
+/// the Gnuplot session (see Gnuplot::begin_frame), so the data files are overwritten in place
+/// instead of being created for each frame. The terminal of the session is restored by finish.
+class Animation
+{
+public:
+    /// @brief Constructor.
+    /// @param _gnuplot The session used to draw the frames.
+    /// @param _output The GIF file, or the prefix of the PNG files (e.g., "frames/frame_").
+    /// @param _format The kind of file to produce (default is gif).
+    /// @param _width The width of the frames, in pixels (default is 640).
+    /// @param _height The height of the frames, in pixels (default is 480).
+    /// @param _delay The delay between two frames of a GIF, in hundredths of a second (default is 10).
+    Animation(
+        Gnuplot &_gnuplot,
+        const std::string &_output,
+        animation_format_t _format = animation_format_t::gif,
+        unsigned _width            = 640,
+        unsigned _height           = 480,
+        unsigned _delay            = 10)
+        : gnuplot(_gnuplot)
+        , output(_output)
+        , format(_format)
+        , width(_width)
+        , height(_height)
+        , delay(_delay)
+    {
+        if (output.empty()) {
+            throw std::invalid_argument("The output of the animation must not be empty.");
+        }
+    }
+
+    /// @brief Destructor, completes the animation if needed.
+    ~Animation() { this->finish(); }
+
+    /// @brief Animations cannot be copied, they own the output of the session.
+    Animation(const Animation &) = delete;
+
+    /// @brief Animations cannot be copied, they own the output of the session.
+    /// @return A reference to the animation.
+    auto operator=(const Animation &) -> Animation & = delete;
+
+    /// @brief Adds a frame to the animation.
+    /// @param draw The function drawing the frame, it should issue a single plot (or multiplot).
+    /// @return A reference to the animation.
+    auto add_frame(const std::function<void(Gnuplot &)> &draw) -> Animation &
+    {
+        if (!gnuplot.is_ready()) {
+            std::cerr << "Error: Invalid Gnuplot session. Cannot add the frame.\n";
+            return *this;
+        }
+        if (finished) {
+            std::cerr << "Error: The animation is already complete. Cannot add the frame.\n";
+            return *this;
+        }
+        // Configure the terminal only once.
+        if (!started) {
+            this->start();
+        }
+        // Each PNG frame goes to its own file.
+        if (format == animation_format_t::png_sequence) {
+            std::ostringstream oss;
+            oss << output << std::setw(5) << std::setfill('0') << count << ".png";
+            gnuplot.send_cmd("set output \"" + oss.str() + "\"");
+        }
+        gnuplot.begin_frame();
+        draw(gnuplot);
+        gnuplot.end_frame();
+        ++count;
+        return *this;
+    }
+
+    /// @brief Renders a sequence of frames, preparing their data on worker threads.
+    /// @details The data of the next frames is prepared concurrently, while the current frame is
+    /// drawn. Frames are always drawn in order, on the calling thread.
+    /// @tparam Prepare The type of the function preparing the data of a frame.
+    /// @tparam Draw The type of the function drawing a frame.
+    /// @param nframes The number of frames.
+    /// @param prepare Called as `prepare(index)` on a worker thread, it returns the data of a frame. It
+    /// must be thread-safe.
+    /// @param draw Called as `draw(gnuplot, data)` on the calling thread, it draws a frame.
+    /// @param workers The number of frames prepared ahead (default is the number of hardware threads).
+    /// @return A reference to the animation.
+    template <typename Prepare, typename Draw>
+    auto render(std::size_t nframes, Prepare prepare, Draw draw, std::size_t workers = 0) -> Animation &
+    {
+        using data_t = typename std::result_of<Prepare(std::size_t)>::type;
+
+        if (workers == 0) {
+            workers = (std::max)(1U, std::thread::hardware_concurrency());
+        }
+
+        // Keep up to `workers` frames in preparation.
+        std::deque<std::future<data_t>> pending;
+        std::size_t next = 0;
+        while ((next < nframes) && (pending.size() < workers)) {
+            pending.push_back(std::async(std::launch::async, std::ref(prepare), next++));
+        }
+        while (!pending.empty()) {
+            data_t data = pending.front().get();
+            pending.pop_front();
+            if (next < nframes) {
+                pending.push_back(std::async(std::launch::async, std::ref(prepare), next++));
+            }
+            this->add_frame([&draw, &data](Gnuplot &gp) { draw(gp, data); });
+        }
+        return *this;
+    }
+
+    /// @brief Completes the animation, closing the output file and restoring the terminal of the session.
+    /// @return A reference to the animation.
+    auto finish() -> Animation &
+    {
+        if (started && !finished && gnuplot.is_ready()) {
+            gnuplot.send_cmd("set output");
+            gnuplot.send_cmd("set terminal pop");
+            gnuplot.flush();
+        }
+        finished = true;
+        return *this;
+    }
+
+    /// @brief Returns the number of frames added so far.
+    /// @return The number of frames.
+    auto frames() const -> std::size_t { return count; }
+
+private:
+    /// @brief Configures the terminal of the animation, saving the one of the session.
+    void start()
+    {
+        gnuplot.send_cmd("set terminal push");
+        std::ostringstream oss;
+        if (format == animation_format_t::gif) {
+            oss << "set terminal gif animate delay " << delay << " size " << width << "," << height;
+            gnuplot.send_cmd(oss.str());
+            gnuplot.send_cmd("set output \"" + output + "\"");
+        } else {
+            oss << "set terminal pngcairo size " << width << "," << height;
+            gnuplot.send_cmd(oss.str());
+        }
+        started = true;
+    }
+
+    Gnuplot &gnuplot;          ///< The session used to draw the frames.
+    std::string output;        ///< The GIF file, or the prefix of the PNG files.
+    animation_format_t format; ///< The kind of file to produce.
+    unsigned width;            ///< The width of the frames, in pixels.
+    unsigned height;           ///< The height of the frames, in pixels.
+    unsigned delay;            ///< The delay between two frames of a GIF.
+    std::size_t count{0};      ///< The number of frames added so far.
+    bool started{false};       ///< Whether the terminal has been configured.
+    bool finished{false};      ///< Whether the animation is complete.
+};
+
+} // namespace gpcpp
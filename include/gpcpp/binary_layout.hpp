@@ -0,0 +1,151 @@
+/// @file binary_layout.hpp
+/// @brief Describes the layout of the records of a binary data file.
+
+#pragma once
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace gpcpp
+{
+
+/// @brief The types of the fields of a binary record, as understood by gnuplot.
+enum class binary_type_t : unsigned char {
+    int8,    ///< 8-bit signed integer.
+    uint8,   ///< 8-bit unsigned integer.
+    int16,   ///< 16-bit signed integer.
+    uint16,  ///< 16-bit unsigned integer.
+    int32,   ///< 32-bit signed integer.
+    uint32,  ///< 32-bit unsigned integer.
+    int64,   ///< 64-bit signed integer.
+    uint64,  ///< 64-bit unsigned integer.
+    float32, ///< Single precision floating point.
+    float64, ///< Double precision floating point.
+};
+
+/// @brief Converts a binary_type_t value to the corresponding gnuplot format specifier.
+/// @param type The type of the field.
+/// @return The gnuplot format specifier (e.g., "%float64").
+static inline auto binary_type_to_string(binary_type_t type) -> std::string
+{
+    switch (type) {
+    case binary_type_t::int8:
+        return "%int8";
+    case binary_type_t::uint8:
+        return "%uint8";
+    case binary_type_t::int16:
+        return "%int16";
+    case binary_type_t::uint16:
+        return "%uint16";
+    case binary_type_t::int32:
+        return "%int32";
+    case binary_type_t::uint32:
+        return "%uint32";
+    case binary_type_t::int64:
+        return "%int64";
+    case binary_type_t::uint64:
+        return "%uint64";
+    case binary_type_t::float32:
+        return "%float32";
+    case binary_type_t::float64:
+        return "%float64";
+    default:
+        return "%float64";
+    }
+}
+
+/// @brief Returns the size in bytes of a field of the given type.
+/// @param type The type of the field.
+/// @return The size of the field in bytes.
+static inline auto binary_type_size(binary_type_t type) -> std::size_t
+{
+    switch (type) {
+    case binary_type_t::int8:
+    case binary_type_t::uint8:
+        return 1;
+    case binary_type_t::int16:
+    case binary_type_t::uint16:
+        return 2;
+    case binary_type_t::int32:
+    case binary_type_t::uint32:
+    case binary_type_t::float32:
+        return 4;
+    case binary_type_t::int64:
+    case binary_type_t::uint64:
+    case binary_type_t::float64:
+        return 8;
+    default:
+        return 8;
+    }
+}
+
+/// @brief The byte order of a binary file.
+enum class endianness_t : unsigned char {
+    native, ///< The byte order of the machine running gnuplot.
+    little, ///< Little endian.
+    big,    ///< Big endian.
+};
+
+/// @brief Describes the layout of the records of a binary data file.
+struct binary_layout_t {
+    std::vector<binary_type_t> fields; ///< The type of each field of a record.
+    std::size_t skip;                  ///< The number of bytes to skip at the beginning of the file (e.g., a header).
+    std::size_t records;               ///< The number of records, 0 means all the records in the file.
+    endianness_t endian;               ///< The byte order of the file.
+
+    /// @brief Constructor.
+    /// @param _fields The type of each field of a record.
+    /// @param _skip The number of bytes to skip at the beginning of the file.
+    /// @param _records The number of records, 0 means all the records in the file.
+    /// @param _endian The byte order of the file.
+    binary_layout_t(
+        const std::vector<binary_type_t> &_fields = std::vector<binary_type_t>(),
+        std::size_t _skip                         = 0,
+        std::size_t _records                      = 0,
+        endianness_t _endian                      = endianness_t::native)
+        : fields(_fields)
+        , skip(_skip)
+        , records(_records)
+        , endian(_endian)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the size of a single record.
+    /// @return The size of a record in bytes.
+    auto record_size() const -> std::size_t
+    {
+        std::size_t size = 0;
+        for (const auto &field : fields) {
+            size += binary_type_size(field);
+        }
+        return size;
+    }
+
+    /// @brief Returns the binary specification to append to the filename inside a plot command.
+    /// @param nrecords The number of records to declare.
+    /// @return the string representation of the layout.
+    auto get_declaration(std::size_t nrecords) const -> std::string
+    {
+        std::ostringstream oss;
+        oss << "binary";
+        if (skip > 0) {
+            oss << " skip=" << skip;
+        }
+        oss << " record=" << nrecords << " format=\"";
+        for (const auto &field : fields) {
+            oss << binary_type_to_string(field);
+        }
+        oss << "\"";
+        if (endian == endianness_t::little) {
+            oss << " endian=little";
+        } else if (endian == endianness_t::big) {
+            oss << " endian=big";
+        }
+        return oss.str();
+    }
+};
+
+} // namespace gpcpp
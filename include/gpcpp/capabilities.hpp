@@ -0,0 +1,151 @@
+/// @file capabilities.hpp
+/// @brief Describes what the installed gnuplot supports, and how the data is handed to it.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace gpcpp
+{
+
+/// @brief How the data of the plots is handed to gnuplot.
+enum class transport_t : unsigned char {
+    text_file,   ///< Temporary files, with the values written as text.
+    binary_file, ///< Temporary files, with the values written as raw doubles.
+    memfd,       ///< Anonymous memory files holding raw doubles, never written to disk (Linux only).
+};
+
+/// @brief Converts a transport_t value to its name.
+/// @param transport The transport.
+/// @return The name of the transport.
+static inline auto transport_to_string(transport_t transport) -> std::string
+{
+    switch (transport) {
+    case transport_t::text_file:
+        return "text_file";
+    case transport_t::binary_file:
+        return "binary_file";
+    case transport_t::memfd:
+        return "memfd";
+    default:
+        return "binary_file";
+    }
+}
+
+/// @brief The features supported by a gnuplot executable, as detected by a probe.
+/// @details Until the probe succeeds, the features are assumed to be available, as the library
+/// always did.
+struct capabilities_t {
+    bool probed{false};                 ///< Whether the values come from a successful probe.
+    std::string version;                ///< The version, including the patch level (e.g., "5.4.2").
+    unsigned major{0};                  ///< The major version.
+    unsigned minor{0};                  ///< The minor version.
+    std::vector<std::string> terminals; ///< The available terminals.
+    bool binary{true};                  ///< Whether binary data files can be read.
+    bool datablock{true};               ///< Whether datablocks (e.g., `$data << EOD`) are supported.
+    bool memfd{false};                  ///< Whether memory files of other processes can be read.
+    bool remultiplot{false};            ///< Whether the `remultiplot` command is available.
+
+    /// @brief Checks if a terminal is available.
+    /// @param name The name of the terminal (e.g., "pngcairo").
+    /// @return true if the terminal is available, or if the terminals are unknown.
+    auto has_terminal(const std::string &name) const -> bool
+    {
+        return !probed || (std::find(terminals.begin(), terminals.end(), name) != terminals.end());
+    }
+
+    /// @brief Checks if a transport can be used.
+    /// @param transport The transport.
+    /// @return true if the transport is supported, false otherwise.
+    auto supports(transport_t transport) const -> bool
+    {
+        switch (transport) {
+        case transport_t::text_file:
+            return true;
+        case transport_t::binary_file:
+            return binary;
+        case transport_t::memfd:
+            return binary && memfd;
+        default:
+            return false;
+        }
+    }
+
+    /// @brief Returns the fastest supported transport.
+    /// @return The transport.
+    auto best_transport() const -> transport_t
+    {
+        if (this->supports(transport_t::memfd)) {
+            return transport_t::memfd;
+        }
+        return this->supports(transport_t::binary_file) ? transport_t::binary_file : transport_t::text_file;
+    }
+
+    /// @brief Writes the capabilities as `key=value` lines.
+    /// @return The serialized capabilities.
+    auto serialize() const -> std::string
+    {
+        std::ostringstream oss;
+        oss << "version=" << version << "\n";
+        oss << "terminals=";
+        for (std::size_t i = 0; i < terminals.size(); ++i) {
+            oss << ((i > 0) ? " " : "") << terminals[i];
+        }
+        oss << "\n";
+        oss << "binary=" << binary << "\n";
+        oss << "datablock=" << datablock << "\n";
+        oss << "memfd=" << memfd << "\n";
+        oss << "remultiplot=" << remultiplot << "\n";
+        return oss.str();
+    }
+
+    /// @brief Reads a single `key=value` line, as written by serialize().
+    /// @param line The line.
+    /// @return true if the key is known, false otherwise.
+    auto parse_line(const std::string &line) -> bool
+    {
+        const std::size_t equal = line.find('=');
+        if (equal == std::string::npos) {
+            return false;
+        }
+        const std::string key   = line.substr(0, equal);
+        const std::string value = line.substr(equal + 1);
+        if (key == "version") {
+            this->set_version(value);
+        } else if (key == "terminals") {
+            std::istringstream iss(value);
+            std::string terminal;
+            terminals.clear();
+            while (iss >> terminal) {
+                terminals.push_back(terminal);
+            }
+        } else if (key == "binary") {
+            binary = (value == "1");
+        } else if (key == "datablock") {
+            datablock = (value == "1");
+        } else if (key == "memfd") {
+            memfd = (value == "1");
+        } else if (key == "remultiplot") {
+            remultiplot = (value == "1");
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Sets the version, and extracts its major and minor numbers.
+    /// @param _version The version (e.g., "5.4.2").
+    void set_version(const std::string &_version)
+    {
+        version = _version;
+        char *end = nullptr;
+        major     = static_cast<unsigned>(std::strtoul(version.c_str(), &end, 10));
+        minor     = ((end != nullptr) && (*end == '.')) ? static_cast<unsigned>(std::strtoul(end + 1, nullptr, 10)) : 0;
+    }
+};
+
+} // namespace gpcpp
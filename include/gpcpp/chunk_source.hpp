@@ -0,0 +1,216 @@
+/// @file chunk_source.hpp
+/// @brief Sources that provide data in chunks, for datasets that do not fit in memory.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace gpcpp
+{
+
+/// @brief A source of records, pulled one chunk at a time.
+/// @details Each record is made of `columns()` values, and chunks contain whole records stored
+/// one after the other (i.e., row-major). Only one chunk needs to be in memory at any time.
+class chunk_source_t
+{
+public:
+    /// @brief Destructor.
+    virtual ~chunk_source_t() = default;
+
+    /// @brief Returns the number of values of each record.
+    /// @return The number of columns.
+    virtual auto columns() const -> std::size_t = 0;
+
+    /// @brief Fills the buffer with the next chunk of records.
+    /// @param buffer The buffer to fill, its previous content is discarded.
+    /// @return true if the buffer contains records, false when the source is exhausted.
+    virtual auto next_chunk(std::vector<double> &buffer) -> bool = 0;
+
+    /// @brief Starts again from the first record.
+    /// @details Called when an upload is cancelled before the source is exhausted, so that the next
+    /// upload gets all the records. Sources that cannot start again do nothing.
+    virtual void rewind()
+    {
+        // Nothing to do.
+    }
+};
+
+/// @brief A source that pulls its chunks from a callback.
+class callback_source_t : public chunk_source_t
+{
+public:
+    /// @brief The type of the callback, it behaves like chunk_source_t::next_chunk.
+    using callback_t = std::function<bool(std::vector<double> &)>;
+
+    /// @brief Constructor.
+    /// @param _columns The number of values of each record.
+    /// @param _callback The callback filling each chunk.
+    callback_source_t(std::size_t _columns, callback_t _callback)
+        : ncolumns(_columns)
+        , callback(std::move(_callback))
+    {
+        // Nothing to do.
+    }
+
+    auto columns() const -> std::size_t override { return ncolumns; }
+
+    auto next_chunk(std::vector<double> &buffer) -> bool override
+    {
+        buffer.clear();
+        return callback(buffer) && !buffer.empty();
+    }
+
+private:
+    std::size_t ncolumns; ///< The number of values of each record.
+    callback_t callback;  ///< The callback filling each chunk.
+};
+
+/// @brief Keeps one record every `stride` records of another source.
+class stride_reducer_t : public chunk_source_t
+{
+public:
+    /// @brief Constructor.
+    /// @param _source The source to reduce.
+    /// @param _stride The distance between two kept records (0 and 1 keep every record).
+    stride_reducer_t(chunk_source_t &_source, std::size_t _stride)
+        : source(_source)
+        , stride((_stride > 0) ? _stride : 1)
+    {
+        // Nothing to do.
+    }
+
+    auto columns() const -> std::size_t override { return source.columns(); }
+
+    auto next_chunk(std::vector<double> &buffer) -> bool override
+    {
+        const std::size_t ncolumns = source.columns();
+        buffer.clear();
+        // The records of the source must have at least one column.
+        if (ncolumns == 0) {
+            std::cerr << "Error: The source has no columns. Cannot reduce.\n";
+            return false;
+        }
+        // Keep pulling until at least one record survives, or the source is exhausted.
+        while (buffer.empty() && source.next_chunk(input)) {
+            const std::size_t records = input.size() / ncolumns;
+            for (std::size_t i = 0; i < records; ++i, ++position) {
+                if ((position % stride) == 0) {
+                    const double *record = input.data() + i * ncolumns;
+                    buffer.insert(buffer.end(), record, record + ncolumns);
+                }
+            }
+        }
+        return !buffer.empty();
+    }
+
+    void rewind() override
+    {
+        source.rewind();
+        position = 0;
+    }
+
+private:
+    chunk_source_t &source;    ///< The source to reduce.
+    std::size_t stride;        ///< The distance between two kept records.
+    std::size_t position{0};   ///< The index of the next record of the source.
+    std::vector<double> input; ///< The chunk pulled from the source.
+};
+
+/// @brief Replaces each bucket of consecutive records with the records holding its minimum and maximum.
+/// @details This keeps the envelope of the signal, including spikes, while bounding the number
+/// of records to two per bucket. The records are kept in their original order.
+class minmax_reducer_t : public chunk_source_t
+{
+public:
+    /// @brief Constructor.
+    /// @param _source The source to reduce.
+    /// @param _bucket The number of records of each bucket.
+    /// @param _column The column holding the value to compare (default is 1, i.e., y), it must be
+    /// smaller than the number of columns of the source.
+    minmax_reducer_t(chunk_source_t &_source, std::size_t _bucket, std::size_t _column = 1)
+        : source(_source)
+        , bucket((_bucket > 0) ? _bucket : 1)
+        , column(_column)
+    {
+        // Nothing to do.
+    }
+
+    auto columns() const -> std::size_t override { return source.columns(); }
+
+    auto next_chunk(std::vector<double> &buffer) -> bool override
+    {
+        const std::size_t ncolumns = source.columns();
+        buffer.clear();
+        // The compared column must be part of the records of the source.
+        if (column >= ncolumns) {
+            std::cerr << "Error: Column " << column << " is out of range for a source with " << ncolumns
+                      << " columns. Cannot reduce.\n";
+            return false;
+        }
+        while (buffer.empty() && !exhausted) {
+            if (!source.next_chunk(input)) {
+                // Flush the last, partial, bucket.
+                exhausted = true;
+                this->flush(buffer);
+                break;
+            }
+            const std::size_t records = input.size() / ncolumns;
+            for (std::size_t i = 0; i < records; ++i) {
+                const double *record = input.data() + i * ncolumns;
+                if ((count == 0) || (record[column] < min_record[column])) {
+                    min_record.assign(record, record + ncolumns);
+                    min_index = count;
+                }
+                if ((count == 0) || (record[column] > max_record[column])) {
+                    max_record.assign(record, record + ncolumns);
+                    max_index = count;
+                }
+                if (++count == bucket) {
+                    this->flush(buffer);
+                }
+            }
+        }
+        return !buffer.empty();
+    }
+
+    void rewind() override
+    {
+        source.rewind();
+        count     = 0;
+        exhausted = false;
+    }
+
+private:
+    /// @brief Appends the records of the current bucket to the buffer, and starts a new bucket.
+    /// @param buffer The buffer receiving the records.
+    void flush(std::vector<double> &buffer)
+    {
+        if (count == 0) {
+            return;
+        }
+        const std::vector<double> &first  = (min_index <= max_index) ? min_record : max_record;
+        const std::vector<double> &second = (min_index <= max_index) ? max_record : min_record;
+        buffer.insert(buffer.end(), first.begin(), first.end());
+        if (min_index != max_index) {
+            buffer.insert(buffer.end(), second.begin(), second.end());
+        }
+        count = 0;
+    }
+
+    chunk_source_t &source;         ///< The source to reduce.
+    std::size_t bucket;             ///< The number of records of each bucket.
+    std::size_t column;             ///< The column holding the value to compare.
+    std::size_t count{0};           ///< The number of records in the current bucket.
+    std::size_t min_index{0};       ///< The position of the minimum inside the current bucket.
+    std::size_t max_index{0};       ///< The position of the maximum inside the current bucket.
+    bool exhausted{false};          ///< Whether the source is exhausted.
+    std::vector<double> min_record; ///< The record holding the minimum of the current bucket.
+    std::vector<double> max_record; ///< The record holding the maximum of the current bucket.
+    std::vector<double> input;      ///< The chunk pulled from the source.
+};
+
+} // namespace gpcpp
@@ -145,6 +145,18 @@ struct Color {
         return oss.str();
     }
 
+    /// @brief Returns the color packed in a single integer.
+    /// @return The color as 0xAARRGGBB, with the alpha inverted as gnuplot expects, or 0 if unset.
+    /// @details This is the value expected by gnuplot for per-point colors (`lc rgb variable`).
+    auto to_integer() const -> unsigned int
+    {
+        if (!is_set()) {
+            return 0U;
+        }
+        return (static_cast<unsigned int>(255 - a) << 24U) | (static_cast<unsigned int>(r) << 16U) |
+               (static_cast<unsigned int>(g) << 8U) | static_cast<unsigned int>(b);
+    }
+
 private:
     int r; ///< Color red.
     int g; ///< Color green.
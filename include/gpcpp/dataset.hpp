@@ -0,0 +1,67 @@
+/// @file dataset.hpp
+/// @brief Describes a dataset uploaded to gnuplot.
+
+#pragma once
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace gpcpp
+{
+
+/// @brief Describes a dataset stored in a temporary file, ready to be referenced by a plot command.
+struct dataset_t {
+    std::string filename;              ///< The name of the file containing the data.
+    std::size_t columns;               ///< The number of columns of each record.
+    std::size_t rows;                  ///< The number of records.
+    bool binary;                       ///< Whether the records are stored as raw doubles (true) or as text (false).
+    std::vector<std::size_t> segments; ///< The number of records between two gaps, empty if there are no gaps.
+
+    /// @brief Constructor.
+    /// @param _filename The name of the file containing the data.
+    /// @param _columns The number of columns of each record.
+    /// @param _rows The number of records.
+    /// @param _binary Whether the records are stored as raw doubles.
+    dataset_t(const std::string &_filename = "", std::size_t _columns = 0, std::size_t _rows = 0, bool _binary = false)
+        : filename(_filename)
+        , columns(_columns)
+        , rows(_rows)
+        , binary(_binary)
+        , segments()
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Checks if the dataset refers to an actual file.
+    /// @return true if the dataset is valid, false otherwise.
+    auto is_valid() const -> bool { return !filename.empty(); }
+
+    /// @brief Returns the data source as it should appear inside a plot command.
+    /// @details For binary datasets this includes the record count and the format of the columns.
+    /// A binary dataset with gaps is split into several records, one per segment.
+    /// @return the quoted filename, followed by the binary specification if needed.
+    auto get_declaration() const -> std::string
+    {
+        std::ostringstream oss;
+        oss << "\"" << filename << "\"";
+        if (binary) {
+            oss << " binary record=";
+            if (segments.empty()) {
+                oss << rows;
+            }
+            for (std::size_t i = 0; i < segments.size(); ++i) {
+                oss << ((i > 0) ? ":" : "") << segments[i];
+            }
+            oss << " format=\"";
+            for (std::size_t i = 0; i < columns; ++i) {
+                oss << "%double";
+            }
+            oss << "\"";
+        }
+        return oss.str();
+    }
+};
+
+} // namespace gpcpp
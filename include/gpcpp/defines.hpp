@@ -57,6 +57,25 @@ static inline auto plot_type_to_string(plot_type_t style) -> std::string
     }
 }
 
+/// @brief Checks if the specified style is a line style.
+/// @param style The plot style to check.
+/// @return true if the style is a line style, false otherwise.
+static inline auto is_line_type(plot_type_t style) -> bool
+{
+    return (
+        style == plot_type_t::lines || style == plot_type_t::lines_points || style == plot_type_t::steps ||
+        style == plot_type_t::fsteps || style == plot_type_t::histeps || style == plot_type_t::filled_curves ||
+        style == plot_type_t::impulses);
+}
+
+/// @brief Checks if the specified style is a point style.
+/// @param style The plot style to check.
+/// @return true if the style is a point style, false otherwise.
+static inline auto is_point_type(plot_type_t style) -> bool
+{
+    return (style == plot_type_t::points || style == plot_type_t::lines_points);
+}
+
 /// @brief The style of error bars.
 enum class erorrbar_type_t : unsigned char {
     yerrorbars, ///< Error bars along the y-axis.
@@ -78,6 +97,12 @@ static inline auto errorbars_to_string(erorrbar_type_t style = erorrbar_type_t::
     }
 }
 
+/// @brief How per-point color values are interpreted by gnuplot.
+enum class color_mode_t : unsigned char {
+    rgb,     ///< Packed 0xAARRGGBB integers (`lc rgb variable`).
+    palette, ///< Values mapped through the current palette (`lc palette`).
+};
+
 /// @brief Enum representing the smoothing styles available in Gnuplot.
 enum class smooth_type_t : unsigned char {
     none,      ///< No smoothing (default).
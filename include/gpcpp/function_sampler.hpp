@@ -0,0 +1,230 @@
+/// @file function_sampler.hpp
+/// @brief Sampling of C++ functions of one variable, uniformly or adaptively, on worker threads.
+
+#pragma once
+
+#include "gpcpp/workers.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <limits>
+#include <queue>
+#include <vector>
+
+namespace gpcpp
+{
+
+/// @brief The samples of a function, sorted by x.
+struct sampled_function_t {
+    std::vector<double> x; ///< The points where the function has been evaluated.
+    std::vector<double> y; ///< The values of the function on the points.
+};
+
+/// @brief Evaluates a function on evenly spaced points, splitting them among worker threads.
+/// @tparam F The type of the function, called as `f(x)` and returning a number. It must be thread-safe.
+/// @param f The function.
+/// @param xmin The first point.
+/// @param xmax The last point.
+/// @param count The number of points.
+/// @param workers The number of worker threads, 0 for the number of hardware threads.
+/// @return The samples.
+template <typename F>
+inline auto sample_uniform(F f, double xmin, double xmax, std::size_t count, std::size_t workers = 0)
+    -> sampled_function_t
+{
+    // Below this number of points per worker, starting a thread costs more than it saves.
+    const std::size_t min_block = 256;
+
+    sampled_function_t samples;
+    samples.x.resize(count);
+    samples.y.resize(count);
+    const double step = (count > 1) ? (xmax - xmin) / static_cast<double>(count - 1) : 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        samples.x[i] = xmin + step * static_cast<double>(i);
+    }
+
+    // Each worker evaluates a contiguous block of points, the calling thread takes the first one.
+    const std::size_t nworkers = worker_count(workers, (count + min_block - 1) / min_block);
+    const std::size_t block    = (count + nworkers - 1) / nworkers;
+    auto evaluate              = [&f, &samples](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            samples.y[i] = static_cast<double>(f(samples.x[i]));
+        }
+    };
+    std::vector<std::future<void>> pending;
+    for (std::size_t begin = block; begin < count; begin += block) {
+        pending.push_back(std::async(std::launch::async, evaluate, begin, (std::min)(begin + block, count)));
+    }
+    evaluate(0, (std::min)(block, count));
+    for (std::future<void> &worker : pending) {
+        worker.get();
+    }
+    return samples;
+}
+
+/// @brief An interval of a function being refined, with the value at its midpoint.
+/// @details The values are the ones used to measure the error, possibly clipped.
+struct sampled_interval_t {
+    double a;       ///< The start of the interval.
+    double fa;      ///< The value at the start.
+    double b;       ///< The end of the interval.
+    double fb;      ///< The value at the end.
+    double fm;      ///< The value at the midpoint.
+    double error;   ///< How far the segment joining the ends is from the value at the midpoint.
+    unsigned depth; ///< The number of times the initial interval has been halved.
+
+    /// @brief Constructor, computes the error from the values.
+    /// @details Where the function is not finite on only some of the three points, the error is
+    /// infinite, so that poles and holes are located before anything else.
+    /// @param _a The start of the interval.
+    /// @param _fa The value at the start.
+    /// @param _b The end of the interval.
+    /// @param _fb The value at the end.
+    /// @param _fm The value at the midpoint.
+    /// @param _depth The number of times the initial interval has been halved.
+    sampled_interval_t(double _a, double _fa, double _b, double _fb, double _fm, unsigned _depth)
+        : a(_a)
+        , fa(_fa)
+        , b(_b)
+        , fb(_fb)
+        , fm(_fm)
+        , error(0.0)
+        , depth(_depth)
+    {
+        const int finite = int(std::isfinite(fa)) + int(std::isfinite(fm)) + int(std::isfinite(fb));
+        if (finite == 3) {
+            error = std::fabs(fm - 0.5 * (fa + fb));
+        } else if (finite > 0) {
+            error = std::numeric_limits<double>::infinity();
+        }
+    }
+
+    /// @brief Returns the midpoint of the interval.
+    /// @return The midpoint.
+    auto middle() const -> double { return a + 0.5 * (b - a); }
+
+    /// @brief Orders the intervals by error, for a max-heap.
+    /// @param other The other interval.
+    /// @return true if this interval has a smaller error.
+    auto operator<(const sampled_interval_t &other) const -> bool { return error < other.error; }
+};
+
+/// @brief Evaluates a function on points chosen adaptively, more densely where it bends.
+/// @details The function is first evaluated on an even grid, whose intervals are then refined
+/// by worker threads, each one taking a contiguous group of intervals.
+/// The tolerance is relative to the range of the values on the initial grid, so it is roughly a
+/// fraction of the height of the plot: 1e-3 keeps the error within a pixel on a 1000-pixel plot.
+/// @tparam F The type of the function, called as `f(x)` and returning a number. It must be thread-safe.
+/// @param f The function.
+/// @param xmin The start of the interval.
+/// @param xmax The end of the interval.
+/// @param tolerance The largest acceptable error, relative to the range of the values.
+/// @param max_points The largest number of points.
+/// @param workers The number of worker threads, 0 for the number of hardware threads.
+/// @return The samples.
+template <typename F>
+inline auto sample_adaptive(
+    F f,
+    double xmin,
+    double xmax,
+    double tolerance,
+    std::size_t max_points = 100000,
+    std::size_t workers    = 0) -> sampled_function_t
+{
+    // The initial grid, fine enough not to miss most features between its points.
+    const std::size_t intervals = 128;
+    // The number of times an initial interval can be halved.
+    const unsigned max_depth = 20;
+
+    const sampled_function_t grid = sample_uniform(std::ref(f), xmin, xmax, intervals + 1, workers);
+
+    // Convert the tolerance to the units of the values.
+    double ymin = 0.0, ymax = 0.0;
+    bool found  = false;
+    for (double value : grid.y) {
+        if (std::isfinite(value)) {
+            ymin  = found ? (std::min)(ymin, value) : value;
+            ymax  = found ? (std::max)(ymax, value) : value;
+            found = true;
+        }
+    }
+    const double range = (ymax > ymin) ? (ymax - ymin) : (std::max)(std::fabs(ymax), 1.0);
+    const double error = tolerance * range;
+    // The errors are measured on the values clipped to a band around that range, so that the
+    // samples far outside the plot (e.g., next to a pole) do not keep asking for more points.
+    const double lower = ymin - range, upper = ymax + range;
+    auto clip          = [lower, upper](double value) {
+        return std::isfinite(value) ? (std::min)((std::max)(value, lower), upper) : value;
+    };
+
+    // Each worker refines a contiguous group of intervals, with its share of the points. The
+    // interval with the largest error is always split first, so a small budget is not spent on
+    // the first intervals only. Every value computed is kept, and sorted by x at the end.
+    const std::size_t nworkers = worker_count(workers, intervals);
+    const std::size_t group    = (intervals + nworkers - 1) / nworkers;
+    const std::size_t share    = ((max_points > grid.x.size()) ? (max_points - grid.x.size()) : 0) / nworkers;
+    auto refine                = [&f, &grid, &clip, error, share](std::size_t begin, std::size_t end) {
+        sampled_function_t part;
+        std::priority_queue<sampled_interval_t> queue;
+        std::size_t budget = share;
+        auto evaluate      = [&f, &part, &budget, &clip](double x) {
+            const double y = static_cast<double>(f(x));
+            part.x.push_back(x);
+            part.y.push_back(y);
+            --budget;
+            return clip(y);
+        };
+        for (std::size_t i = begin; (i < end) && (budget > 0); ++i) {
+            const double m = grid.x[i] + 0.5 * (grid.x[i + 1] - grid.x[i]);
+            queue.push(
+                sampled_interval_t(grid.x[i], clip(grid.y[i]), grid.x[i + 1], clip(grid.y[i + 1]), evaluate(m), 0));
+        }
+        while (!queue.empty() && (queue.top().error > error) && (budget >= 2)) {
+            const sampled_interval_t interval = queue.top();
+            queue.pop();
+            if (interval.depth >= max_depth) {
+                continue;
+            }
+            const double m = interval.middle();
+            const double l = interval.a + 0.5 * (m - interval.a);
+            const double r = m + 0.5 * (interval.b - m);
+            queue.push(sampled_interval_t(interval.a, interval.fa, m, interval.fm, evaluate(l), interval.depth + 1));
+            queue.push(sampled_interval_t(m, interval.fm, interval.b, interval.fb, evaluate(r), interval.depth + 1));
+        }
+        return part;
+    };
+    std::vector<std::future<sampled_function_t>> pending;
+    for (std::size_t begin = group; begin < intervals; begin += group) {
+        pending.push_back(std::async(std::launch::async, refine, begin, (std::min)(begin + group, intervals)));
+    }
+    sampled_function_t refined = refine(0, (std::min)(group, intervals));
+    for (std::future<sampled_function_t> &worker : pending) {
+        const sampled_function_t part = worker.get();
+        refined.x.insert(refined.x.end(), part.x.begin(), part.x.end());
+        refined.y.insert(refined.y.end(), part.y.begin(), part.y.end());
+    }
+    refined.x.insert(refined.x.end(), grid.x.begin(), grid.x.end());
+    refined.y.insert(refined.y.end(), grid.y.begin(), grid.y.end());
+
+    // Sort the points by x.
+    std::vector<std::size_t> order(refined.x.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&refined](std::size_t l, std::size_t r) {
+        return refined.x[l] < refined.x[r];
+    });
+    sampled_function_t samples;
+    samples.x.reserve(order.size());
+    samples.y.reserve(order.size());
+    for (std::size_t i : order) {
+        samples.x.push_back(refined.x[i]);
+        samples.y.push_back(refined.y[i]);
+    }
+    return samples;
+}
+
+} // namespace gpcpp
@@ -6,15 +6,34 @@
 
 #pragma once
 
+// When GPCPP_COMPILED_LIB is defined, the non-template functions are compiled once into the
+// gpcpp_static or gpcpp_shared library, instead of being defined inline in every translation unit.
+#if defined(GPCPP_COMPILED_LIB)
+#define GPCPP_INLINE
+#else
+#define GPCPP_INLINE inline
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <deque>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 enum : unsigned char {
@@ -29,16 +48,38 @@ enum : unsigned char {
 
 #elif defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
 //all UNIX-like OSs (Linux, *BSD, MacOSX, Solaris, ...)
-#include <unistd.h> // for access(), mkstemp()
+#include <fcntl.h>    // for open()
+#include <poll.h>     // for poll()
+#include <signal.h>   // for pthread_sigmask()
+#include <sys/mman.h> // for memfd_create()
+#include <sys/stat.h> // for mkfifo()
+#include <sys/wait.h> // for waitpid()
+#include <unistd.h>   // for access(), mkstemp(), fork()
 
 #else
 #error unsupported or unknown operating system
 #endif
 
+#include "gpcpp/binary_layout.hpp"
 #include "gpcpp/box_style.hpp"
+#include "gpcpp/capabilities.hpp"
+#include "gpcpp/chunk_source.hpp"
 #include "gpcpp/color.hpp"
+#include "gpcpp/dataset.hpp"
 #include "gpcpp/defines.hpp"
+#include "gpcpp/function_sampler.hpp"
 #include "gpcpp/id_manager.hpp"
+#include "gpcpp/latency_budget.hpp"
+#include "gpcpp/mapped_array.hpp"
+#include "gpcpp/multiplot.hpp"
+#include "gpcpp/nonfinite.hpp"
+#include "gpcpp/ohlc.hpp"
+#include "gpcpp/outbound.hpp"
+#include "gpcpp/resample.hpp"
+#include "gpcpp/spatial_index.hpp"
+#include "gpcpp/storage_budget.hpp"
+#include "gpcpp/upload_control.hpp"
+#include "gpcpp/vector_field.hpp"
 
 namespace gpcpp
 {
@@ -201,11 +242,14 @@ public:
         -> Gnuplot &;
 
     /// @brief Disables the grid for plots.
-    /// @details The grid is not enabled by default.
+    /// @details The grid is not enabled by default. The custom grid line styles are released.
     /// @return A reference to the current Gnuplot object.
     auto unset_grid() -> Gnuplot &;
 
     /// @brief Enables multiplot mode for displaying multiple plots in one session.
+    /// @details While in multiplot mode, each call to set_origin_and_size starts a new panel, and
+    /// the commands drawing each panel are cached so that the multiplot can be updated with
+    /// update_panel and refresh_multiplot.
     /// @return A reference to the current Gnuplot object.
     auto set_multiplot() -> Gnuplot &;
 
@@ -225,6 +269,22 @@ public:
     /// @return A reference to the current Gnuplot object, allowing for method chaining.
     auto set_origin_and_size(double x_origin, double y_origin, double width, double height) -> Gnuplot &;
 
+    /// @brief Replaces the content of a panel of the last multiplot.
+    /// @details The commands issued by `draw` are cached instead of being sent, and only the data
+    /// plotted by `draw` is uploaded. The other panels keep referencing their already uploaded
+    /// data. The files written for the old content of the panel are released, unless another
+    /// panel still reads them. The change becomes visible with refresh_multiplot.
+    /// @param index The index of the panel, in the order in which the panels were created.
+    /// @param draw The function drawing the new content of the panel.
+    /// @return A reference to the current Gnuplot object.
+    auto update_panel(std::size_t index, const std::function<void(Gnuplot &)> &draw) -> Gnuplot &;
+
+    /// @brief Redraws the last multiplot, if any of its panels has been updated.
+    /// @details gnuplot redraws the whole canvas, but the unchanged panels are replayed from
+    /// their cached commands, so only the data of the updated panels is serialized again.
+    /// @return A reference to the current Gnuplot object.
+    auto refresh_multiplot() -> Gnuplot &;
+
     /// @brief Sets the sampling rate for plotting functions or interpolating data.
     /// @param samples The number of samples (default is 100).
     /// @return A reference to the current Gnuplot object.
@@ -370,6 +430,17 @@ public:
     /// @return A reference to the current Gnuplot object.
     auto set_zautoscale() -> Gnuplot &;
 
+    /// @brief Turns the x-axis into a time axis.
+    /// @details Timestamps are read as seconds since the Unix epoch (`set timefmt "%s"`), so no
+    /// string parsing is involved on the gnuplot side.
+    /// @param format The format used to print the tic labels (default is "%H:%M:%S").
+    /// @return A reference to the current Gnuplot object.
+    auto set_xtime(const std::string &format = "%H:%M:%S") -> Gnuplot &;
+
+    /// @brief Turns the x-axis back into a numeric axis.
+    /// @return A reference to the current Gnuplot object.
+    auto unset_xtime() -> Gnuplot &;
+
     /// @brief Enables logarithmic scaling for the x-axis.
     /// @details Logarithmic scaling is not enabled by default.
     /// @param base The base of the logarithm (default is 10).
@@ -459,6 +530,11 @@ public:
         bool point_type               = false,
         const box_style_t &box_style  = box_style_t()) -> Gnuplot &;
 
+    /// @brief Removes all the labels from the plot.
+    /// @details The textbox styles created for the labels are released, so their IDs can be reused.
+    /// @return Reference to the Gnuplot object for chaining.
+    auto remove_labels() -> Gnuplot &;
+
     /// @brief Plots a single vector of data.
     /// @tparam X The type of the data in the vector.
     /// @param x The data to plot.
@@ -503,6 +579,72 @@ public:
         erorrbar_type_t style    = erorrbar_type_t::yerrorbars,
         const std::string &title = "") -> Gnuplot &;
 
+    /// @brief Plots x, y pairs, coloring each point with its own color.
+    /// @details The data is uploaded as a single binary dataset and rendered as a single series.
+    /// @tparam X The type of the x data.
+    /// @tparam Y The type of the y data.
+    /// @tparam C The type of the color data.
+    /// @param x The x values.
+    /// @param y The y values.
+    /// @param colors The color of each point, either packed RGB values (see Color::to_integer) or palette values.
+    /// @param mode How the color values are interpreted (default is rgb).
+    /// @param title The title of the plot (default is an empty string).
+    /// @return A reference to the current Gnuplot object.
+    template <typename X, typename Y, typename C>
+    auto plot_xy_color(
+        const X &x,
+        const Y &y,
+        const C &colors,
+        color_mode_t mode        = color_mode_t::rgb,
+        const std::string &title = "") -> Gnuplot &;
+
+    /// @brief Plots x, y pairs, drawing each point with its own size.
+    /// @details The data is uploaded as a single binary dataset and rendered as a single series.
+    /// @tparam X The type of the x data.
+    /// @tparam Y The type of the y data.
+    /// @tparam S The type of the size data.
+    /// @param x The x values.
+    /// @param y The y values.
+    /// @param sizes The size of each point.
+    /// @param title The title of the plot (default is an empty string).
+    /// @return A reference to the current Gnuplot object.
+    template <typename X, typename Y, typename S>
+    auto plot_xy_size(const X &x, const Y &y, const S &sizes, const std::string &title = "") -> Gnuplot &;
+
+    /// @brief Plots x, y pairs, drawing each point with its own color and size.
+    /// @details The data is uploaded as a single binary dataset and rendered as a single series.
+    /// @tparam X The type of the x data.
+    /// @tparam Y The type of the y data.
+    /// @tparam C The type of the color data.
+    /// @tparam S The type of the size data.
+    /// @param x The x values.
+    /// @param y The y values.
+    /// @param colors The color of each point, either packed RGB values (see Color::to_integer) or palette values.
+    /// @param sizes The size of each point.
+    /// @param mode How the color values are interpreted (default is rgb).
+    /// @param title The title of the plot (default is an empty string).
+    /// @return A reference to the current Gnuplot object.
+    template <typename X, typename Y, typename C, typename S>
+    auto plot_xy_color_size(
+        const X &x,
+        const Y &y,
+        const C &colors,
+        const S &sizes,
+        color_mode_t mode        = color_mode_t::rgb,
+        const std::string &title = "") -> Gnuplot &;
+
+    /// @brief Plots a time series.
+    /// @details The timestamps are uploaded as binary numbers (seconds since the Unix epoch), and the
+    /// x-axis is configured as a time axis the first time this function is called (see set_xtime).
+    /// @tparam T The type of the timestamps, either `std::chrono::time_point` values or numbers of seconds.
+    /// @tparam Y The type of the y data.
+    /// @param t The timestamps.
+    /// @param y The y values.
+    /// @param title The title of the plot (default is an empty string).
+    /// @return A reference to the current Gnuplot object.
+    template <typename T, typename Y>
+    auto plot_time_xy(const T &t, const Y &y, const std::string &title = "") -> Gnuplot &;
+
     /// @brief Plots x, y, z triples of data.
     /// @tparam X The type of the x data.
     /// @tparam Y The type of the y data.
@@ -524,6 +666,213 @@ public:
     template <typename X, typename Y, typename Z>
     auto plot_3d_grid(const X &x, const Y &y, const Z &z, const std::string &title = "") -> Gnuplot &;
 
+    /// @brief Uploads the given columns to a binary temporary file, so that they can be plotted many times.
+    /// @details The returned dataset can be plotted with plot_dataset, or referenced by the panels
+    /// of a multiplot_layout_t, without uploading the data again.
+    /// @param x The first column.
+    /// @param columns The other columns, they must have the same size of the first one.
+    /// @return The description of the dataset, invalid if the data could not be uploaded.
+    template <typename X, typename... Columns>
+    auto upload(const X &x, const Columns &...columns) -> dataset_t;
+
+    /// @brief Uploads the records of a chunked source to a binary temporary file.
+    /// @param source The source of the records.
+    /// @return The description of the dataset, invalid if the data could not be uploaded or the source is empty.
+    auto upload(chunk_source_t &source) -> dataset_t;
+
+    /// @brief Plots a dataset that has already been uploaded.
+    /// @param dataset The dataset to plot.
+    /// @param using_spec The columns to plot, as in gnuplot's `using` (default is "1:2").
+    /// @param title The title of the plot (default is an empty string).
+    /// @return A reference to the current Gnuplot object.
+    auto plot_dataset(const dataset_t &dataset, const std::string &using_spec = "1:2", const std::string &title = "")
+        -> Gnuplot &;
+
+    /// @brief Plots all the panels of a layout.
+    /// @details The whole multiplot is sent as a single batch of commands. Afterwards the plot
+    /// state is reset, so the next plot starts a new figure instead of replotting.
+    /// @param layout The layout to plot.
+    /// @return A reference to the current Gnuplot object.
+    auto plot_layout(const multiplot_layout_t &layout) -> Gnuplot &;
+
+    /// @brief Plots the records provided by a chunked source.
+    /// @details The chunks are pulled one at a time and streamed to a binary temporary file, so
+    /// the memory used is bounded by the size of a chunk. Sources can be wrapped in a
+    /// stride_reducer_t or a minmax_reducer_t to reduce them while streaming.
+    /// @param source The source of the records.
+    /// @param using_spec The columns to plot, as in gnuplot's `using` (default is "1:2").
+    /// @param title The title of the plot (default is an empty string).
+    /// @return A reference to the current Gnuplot object.
+    auto plot_source(chunk_source_t &source, const std::string &using_spec = "1:2", const std::string &title = "")
+        -> Gnuplot &;
+
+    /// @brief Plots several series aligned onto the same x grid.
+    /// @details The series are uploaded as a single dataset, with one column each, and every
+    /// series is rendered from its column of the same file. The values outside the range of a
+    /// series are written as NaN whatever the non-finite policy, and gnuplot skips them in that
+    /// series only.
+    /// @param aligned The aligned series.
+    /// @param titles The title of each series (default is no title).
+    /// @return A reference to the current Gnuplot object.
+    auto plot_aligned(aligned_series_t &aligned, const std::vector<std::string> &titles = {}) -> Gnuplot &;
+
+    /// @brief Plots a C++ function, sampled adaptively.
+    /// @details The function is evaluated more densely where it bends, until the straight segments
+    /// between the samples are within the tolerance (see sample_adaptive), so that smooth regions
+    /// cost a few points and sharp ones get all the detail. Only the resulting points are uploaded.
+    /// @tparam F The type of the function, called as `f(x)` and returning a number. It must be thread-safe.
+    /// @param f The function.
+    /// @param xmin The start of the interval.
+    /// @param xmax The end of the interval, greater than the start.
+    /// @param tolerance The largest acceptable error, relative to the range of the values (default is 1e-3).
+    /// @param title The title of the plot (default is an empty string).
+    /// @param max_points The largest number of points (default is 100000).
+    /// @return A reference to the current Gnuplot object.
+    template <typename F>
+    auto plot_function(
+        F f,
+        double xmin,
+        double xmax,
+        double tolerance         = 1e-3,
+        const std::string &title = "",
+        std::size_t max_points   = 100000) -> Gnuplot &;
+
+    /// @brief Plots a C++ function, sampled on evenly spaced points.
+    /// @details The points are split among worker threads (see sample_uniform).
+    /// @tparam F The type of the function, called as `f(x)` and returning a number. It must be thread-safe.
+    /// @param f The function.
+    /// @param xmin The start of the interval.
+    /// @param xmax The end of the interval, greater than the start.
+    /// @param samples The number of points, at least 2.
+    /// @param title The title of the plot (default is an empty string).
+    /// @return A reference to the current Gnuplot object.
+    template <typename F>
+    auto plot_function_samples(F f, double xmin, double xmax, std::size_t samples, const std::string &title = "")
+        -> Gnuplot &;
+
+    /// @brief Plots a 2D vector field, as arrows.
+    /// @details Each arrow starts at (x, y) and ends at (x + dx, y + dy). The arrows are uploaded with
+    /// the binary transport when gnuplot supports it. With a limit on the number of arrows, a large
+    /// field is subsampled before it is uploaded (see subsample_vectors), so the plot stays readable
+    /// and only the arrows drawn are written.
+    /// @param x The x coordinates of the arrows.
+    /// @param y The y coordinates of the arrows.
+    /// @param dx The x components of the arrows.
+    /// @param dy The y components of the arrows.
+    /// @param title The title of the plot (default is an empty string).
+    /// @param max_arrows The largest number of arrows, 0 for no limit (default is 0).
+    /// @param sampling How the arrows are chosen, when there are too many of them (default is grid).
+    /// @return A reference to the current Gnuplot object.
+    template <typename X, typename Y, typename DX, typename DY>
+    auto plot_vectors(
+        const X &x,
+        const Y &y,
+        const DX &dx,
+        const DY &dy,
+        const std::string &title   = "",
+        std::size_t max_arrows     = 0,
+        vector_sampling_t sampling = vector_sampling_t::grid) -> Gnuplot &;
+
+    /// @brief Plots a 3D vector field, as arrows.
+    /// @details Each arrow starts at (x, y, z) and ends at (x + dx, y + dy, z + dz). See plot_vectors().
+    /// @param x The x coordinates of the arrows.
+    /// @param y The y coordinates of the arrows.
+    /// @param z The z coordinates of the arrows.
+    /// @param dx The x components of the arrows.
+    /// @param dy The y components of the arrows.
+    /// @param dz The z components of the arrows.
+    /// @param title The title of the plot (default is an empty string).
+    /// @param max_arrows The largest number of arrows, 0 for no limit (default is 0).
+    /// @param sampling How the arrows are chosen, when there are too many of them (default is grid).
+    /// @return A reference to the current Gnuplot object.
+    template <typename X, typename Y, typename Z, typename DX, typename DY, typename DZ>
+    auto plot_vectors_3d(
+        const X &x,
+        const Y &y,
+        const Z &z,
+        const DX &dx,
+        const DY &dy,
+        const DZ &dz,
+        const std::string &title   = "",
+        std::size_t max_arrows     = 0,
+        vector_sampling_t sampling = vector_sampling_t::grid) -> Gnuplot &;
+
+    /// @brief Plots price ticks as financial bars, aggregated over a fixed interval.
+    /// @details The ticks are aggregated into open/high/low/close bars in a single pass split among
+    /// worker threads (see aggregate_ohlc), and only the bars are uploaded, five values each.
+    /// @param timestamps The time of each tick, in ascending order.
+    /// @param prices The price of each tick.
+    /// @param bar_interval The length of a bar, in the units of the timestamps.
+    /// @param title The title of the plot (default is an empty string).
+    /// @param style How the bars are drawn (default is candlesticks).
+    /// @return A reference to the current Gnuplot object.
+    template <typename T, typename P>
+    auto plot_candles(
+        const T &timestamps,
+        const P &prices,
+        double bar_interval,
+        const std::string &title = "",
+        candle_style_t style     = candle_style_t::candlesticks) -> Gnuplot &;
+
+    /// @brief Plots the bars of a stream of ticks, rewriting only the newest bar.
+    /// @details The first call uploads all the bars. As the bars before the newest one never change,
+    /// the following calls with the same stream only rewrite the newest bar of the file in place, and
+    /// append the new ones. Inside a frame, with the text transport, if the file has been evicted, or
+    /// while gnuplot may not have read it for the previous plot yet, all the bars are uploaded to a
+    /// new file. Call it after some new ticks, starting a new plot (see
+    /// reset_plot and begin_frame) to replace the previous one.
+    /// @param stream The stream of ticks.
+    /// @param title The title of the plot (default is an empty string).
+    /// @param style How the bars are drawn (default is candlesticks).
+    /// @return A reference to the current Gnuplot object.
+    auto plot_candles(
+        const ohlc_stream_t &stream,
+        const std::string &title = "",
+        candle_style_t style     = candle_style_t::candlesticks) -> Gnuplot &;
+
+    /// @brief Plots the content of an existing text data file, without copying it.
+    /// @param filename The name of the data file.
+    /// @param using_spec The columns to plot, as in gnuplot's `using` (default is "1:2").
+    /// @param format The scanf-like format used to read each line (e.g., "%lf,%lf"), empty to use the default one.
+    /// @param title The title of the plot (default is an empty string).
+    /// @param checksum The expected checksum of the file (see file_checksum), 0 to skip the check.
+    /// @return A reference to the current Gnuplot object.
+    auto plot_file(
+        const std::string &filename,
+        const std::string &using_spec = "1:2",
+        const std::string &format     = "",
+        const std::string &title      = "",
+        std::uint64_t checksum        = 0) -> Gnuplot &;
+
+    /// @brief Plots the content of an existing binary data file, without copying it.
+    /// @param filename The name of the data file.
+    /// @param layout The layout of the records in the file.
+    /// @param using_spec The columns to plot, as in gnuplot's `using` (default is "1:2").
+    /// @param title The title of the plot (default is an empty string).
+    /// @param checksum The expected checksum of the file (see file_checksum), 0 to skip the check.
+    /// @return A reference to the current Gnuplot object.
+    auto plot_binary_file(
+        const std::string &filename,
+        const binary_layout_t &layout,
+        const std::string &using_spec = "1:2",
+        const std::string &title      = "",
+        std::uint64_t checksum        = 0) -> Gnuplot &;
+
+    /// @brief Plots a memory-mapped array, letting gnuplot read its file directly.
+    /// @details Each row of the array is a record, and the header of the file is skipped, so the
+    /// data is neither parsed nor copied on the C++ side.
+    /// @param array The mapped array (one or two dimensional, row-major).
+    /// @param using_spec The columns to plot, as in gnuplot's `using` (default is "1:2").
+    /// @param title The title of the plot (default is an empty string).
+    /// @return A reference to the current Gnuplot object.
+    auto plot_mapped(const mapped_array_t &array, const std::string &using_spec = "1:2", const std::string &title = "")
+        -> Gnuplot &;
+
+    /// @brief Computes the checksum (64-bit FNV-1a) of a file.
+    /// @param filename The name of the file.
+    /// @return The checksum of the file, 0 if the file cannot be read.
+    static auto file_checksum(const std::string &filename) -> std::uint64_t;
+
     /// @brief Plots a linear equation of the form y = ax + b.
     /// @param a The slope of the line.
     /// @param b The y-intercept of the line.
@@ -553,6 +902,176 @@ public:
     plot_image(const unsigned char *ucPicBuf, unsigned int iWidth, unsigned int iHeight, const std::string &title = "")
         -> Gnuplot &;
 
+    /// @brief Enables the automatic restart of gnuplot, if it terminates unexpectedly.
+    /// @details The settings (terminal, ranges, styles, ...) and the last plot are recorded, and
+    /// they are replayed on the new gnuplot process. The plotted data files are still in place,
+    /// so they do not need to be uploaded again. The commands are only recorded while the restart is
+    /// enabled, so it should be enabled before configuring the session. At most 256 untagged labels,
+    /// arrows or objects are replayed, the most recent ones.
+    /// @param enable Whether gnuplot is restarted (default is true).
+    /// @return A reference to the current Gnuplot object.
+    auto set_auto_respawn(bool enable = true) -> Gnuplot &;
+
+    /// @brief Configures what happens when gnuplot cannot keep up with the commands.
+    /// @details Commands are queued and written without blocking. When the queue exceeds its limit,
+    /// the policy decides whether to wait (up to the timeout), to drop or coalesce the frames that
+    /// have not been sent yet (see begin_frame), or to reject the new commands. Only frames are
+    /// ever dropped; the other commands are only rejected by the fail_fast policy, or after a timeout.
+    /// On Windows, writes are always blocking.
+    /// @param policy The overload policy (default is block).
+    /// @param max_bytes The maximum number of bytes in the queue (default is 4 MiB).
+    /// @param timeout_ms The write timeout, in milliseconds (default is 1000).
+    /// @return A reference to the current Gnuplot object.
+    auto set_overload_policy(
+        overload_policy_t policy = overload_policy_t::block,
+        std::size_t max_bytes    = 4U << 20U,
+        unsigned timeout_ms      = 1000) -> Gnuplot &;
+
+    /// @brief Returns the statistics about the data written to gnuplot.
+    /// @return The metrics of the pipe.
+    auto get_pipe_metrics() const -> pipe_metrics_t;
+
+    /// @brief Limits the bytes held by the temporary files of the data, on disk or in memory.
+    /// @details Before a file is written, the least recently used files are evicted until the new
+    /// data fits; the files referenced by the current figure or by the cached multiplot panels, or
+    /// recycled by the frames in flight, are never evicted. If the data still does not fit, the
+    /// policy decides whether it is written with fewer records or rejected. The same eviction keeps
+    /// the number of files under its cap.
+    /// An evicted dataset (see upload) cannot be plotted anymore, and must be uploaded again.
+    /// @param max_bytes The maximum number of bytes, 0 for no limit (the default).
+    /// @param policy What happens to the data that does not fit (default is degrade).
+    /// @return A reference to the current Gnuplot object.
+    auto set_storage_budget(std::size_t max_bytes, storage_policy_t policy = storage_policy_t::degrade) -> Gnuplot &;
+
+    /// @brief Returns the statistics about the temporary files of the data.
+    /// @return The metrics of the storage.
+    auto get_storage_metrics() const -> storage_metrics_t;
+
+    /// @brief Sets a time budget for each frame, lowering the level of detail to stay within it.
+    /// @details The time spent building, transferring and rendering each frame (see begin_frame)
+    /// is measured, and smoothed over the recent frames. While it exceeds the budget, plot_xy()
+    /// writes only the envelope of long series, plot_xyz() keeps one record every few, and the
+    /// values given to set_samples() and set_isosamples() are scaled down; text data files are
+    /// replaced by faster transports, if gnuplot supports them. The full detail comes back as the
+    /// frames get cheaper.
+    /// @param budget_ms The budget of a frame in milliseconds, 0 to disable it.
+    /// @return A reference to the current Gnuplot object.
+    auto set_frame_budget(double budget_ms) -> Gnuplot &;
+
+    /// @brief Returns the time spent on the recent frames, smoothed.
+    /// @return The average timings of the frames.
+    auto get_frame_timing() const -> frame_timing_t;
+
+    /// @brief Returns the level of detail chosen by the frame budget.
+    /// @return The fraction of the full detail used, 1 for full detail.
+    auto get_detail_scale() const -> double;
+
+    /// @brief Returns the features supported by gnuplot.
+    /// @details gnuplot is probed when the first session starts, and the result is cached on disk
+    /// (in $XDG_CACHE_HOME/gpcpp, or ~/.cache/gpcpp), per executable path and modification time.
+    /// @return The capabilities of gnuplot.
+    auto get_capabilities() const -> const capabilities_t &;
+
+    /// @brief Returns how the data of the plots is handed to gnuplot.
+    /// @return The transport, by default the fastest one supported by gnuplot.
+    auto get_transport() const -> transport_t;
+
+    /// @brief Sets how the data of the plots is handed to gnuplot.
+    /// @param transport The transport, it must be supported by gnuplot (see get_capabilities).
+    /// @return A reference to the current Gnuplot object.
+    auto set_transport(transport_t transport) -> Gnuplot &;
+
+    /// @brief Returns what happens to the records holding a non-finite value.
+    /// @return The policy.
+    auto get_nonfinite_policy() const -> nonfinite_policy_t;
+
+    /// @brief Sets what happens to the records holding a non-finite value (NaN, or an infinity).
+    /// @details With gap (the default), the records are dropped and the line is broken where they
+    /// were: text data gets an empty line, binary data is split into several records. With
+    /// filter, the records are dropped and the line joins the records around them. The data is
+    /// checked with a branch-free scan, so finite data costs a single pass.
+    /// @param policy The policy.
+    /// @return A reference to the current Gnuplot object.
+    auto set_nonfinite_policy(nonfinite_policy_t policy) -> Gnuplot &;
+
+    /// @brief Sets the callback reporting the progress of the uploads.
+    /// @details The callback is called by the thread running the plot, when an upload starts, every
+    /// few thousand records, and when it is complete (see upload_progress_t).
+    /// @param progress The callback, empty to disable it.
+    /// @return A reference to the current Gnuplot object.
+    auto set_upload_progress(upload_progress_t progress) -> Gnuplot &;
+
+    /// @brief Returns the token cancelling the uploads.
+    /// @return A copy of the token, sharing its state with the one of the session.
+    auto get_cancel_token() const -> cancel_token_t;
+
+    /// @brief Sets the token cancelling the uploads.
+    /// @details The token can be cancelled from any thread. A cancelled upload stops at the next
+    /// chunk of records, removes its partial temporary file, rewinds its chunked source (see
+    /// chunk_source_t::rewind), and the plot sends no command, so the session is left as it was
+    /// before the plot. Call it from the thread running the plots, e.g., with a new token for each
+    /// plot, so that cancelling a superseded plot does not cancel the next one.
+    /// @param token The token.
+    /// @return A reference to the current Gnuplot object.
+    auto set_cancel_token(cancel_token_t token) -> Gnuplot &;
+
+    /// @brief Enables the spatial index of the series plotted by plot_xy() and plot_xyz().
+    /// @details The values of each series are copied, and a k-d tree over their x and y values is
+    /// built by a background task, so that nearest() can map a position (e.g., the mouse) to a
+    /// sample without scanning the whole series.
+    /// @param enable Whether the series are indexed (default is true).
+    /// @return A reference to the current Gnuplot object.
+    auto set_spatial_index(bool enable = true) -> Gnuplot &;
+
+    /// @brief Finds the sample of an indexed series closest to a position.
+    /// @details Waits for the index of the series, if it is still being built. The distance along
+    /// each axis is divided by the scale of the axis: passing the size of a pixel, in data units,
+    /// finds the sample that is the closest on screen.
+    /// @param series The index of the series, among the indexed series of the current plot, in plotting order.
+    /// @param x The x coordinate of the position.
+    /// @param y The y coordinate of the position.
+    /// @param x_scale The scale of the x axis (default is 1).
+    /// @param y_scale The scale of the y axis (default is 1).
+    /// @return The closest sample, not found if the series does not exist or is empty.
+    auto nearest(std::size_t series, double x, double y, double x_scale = 1.0, double y_scale = 1.0) -> nearest_t;
+
+    /// @brief Checks if the index of a series has been built.
+    /// @param series The index of the series, as for nearest().
+    /// @return `true` if nearest() can answer without waiting, `false` otherwise.
+    auto is_index_ready(std::size_t series) const -> bool;
+
+    /// @brief Checks if the gnuplot process is still running.
+    /// @return `true` if gnuplot is running, `false` otherwise.
+    auto is_alive() -> bool;
+
+    /// @brief Sends the pending commands to gnuplot, without waiting for them to be executed.
+    /// @return A reference to the current Gnuplot object.
+    auto flush() -> Gnuplot &;
+
+    /// @brief Waits until gnuplot has drawn every frame sent so far.
+    /// @return `true` if all the frames have been drawn, `false` on timeout or if gnuplot cannot acknowledge them.
+    auto sync() -> bool;
+
+    /// @brief Sets how many frames can be in flight at the same time.
+    /// @details With a depth of 2 or 3, the data of the next frame is written while gnuplot is
+    /// still rendering the previous ones. Each frame slot has its own temporary files, which are
+    /// overwritten only once gnuplot has confirmed that it consumed the frame that used them.
+    /// @param depth The number of frames in flight, between 1 (no overlap) and 3.
+    /// @return A reference to the current Gnuplot object.
+    auto set_frame_depth(std::size_t depth) -> Gnuplot &;
+
+    /// @brief Starts a new frame.
+    /// @details Waits until gnuplot has consumed the frame that last used the same slot, then
+    /// resets the plot state. The plots of the frame reuse the temporary files of the slot.
+    /// With the drop_oldest and coalesce overload policies, a frame that has not been sent yet is
+    /// dropped instead, so a slow gnuplot lowers the frame rate without slowing down the caller.
+    /// @return A reference to the current Gnuplot object.
+    auto begin_frame() -> Gnuplot &;
+
+    /// @brief Ends the current frame, and sends it to gnuplot without waiting for the rendering.
+    /// @return A reference to the current Gnuplot object.
+    auto end_frame() -> Gnuplot &;
+
     /// @brief Repeats the last plot or splot command.
     /// @details Useful for viewing the same plot with different settings or generating it for multiple devices (e.g., screen or file).
     /// @return A reference to the current Gnuplot object.
@@ -587,22 +1106,254 @@ private:
     /// The file is opened for writing, and its name is stored for cleanup.
     ///
     /// @param tmp A reference to an `std::ofstream` object where the file will be opened.
+    /// @param binary Whether the file should be opened in binary mode.
     ///
     /// @return The name of the created temporary file.
     ///
     /// @throws GnuplotException If the maximum number of temporary files is reached
     ///         or if the temporary file cannot be created or opened.
-    auto create_tmpfile(std::ofstream &tmp) -> std::string;
+    auto create_tmpfile(std::ofstream &tmp, bool binary = false) -> std::string;
+
+    /// @brief Makes room for some data within the storage budget, evicting the least recently used files.
+    /// @param bytes The estimated size of the data.
+    /// @return The fraction of the data that fits (1 if all of it), 0 if the data is rejected.
+    auto reserve_storage(std::size_t bytes) -> double;
+
+    /// @brief Evicts the least recently used files, until the resident bytes and the new ones fit within the budget.
+    /// @param bytes The bytes about to be written.
+    /// @return `true` if the bytes fit, `false` otherwise.
+    auto evict_storage(std::size_t bytes) -> bool;
+
+    /// @brief Evicts the least recently used file that is not in use.
+    /// @return `true` if a file has been evicted, `false` if every file is in use.
+    auto evict_tmpfile() -> bool;
+
+    /// @brief Removes a temporary file, and forgets it.
+    /// @param file The file.
+    void release_tmpfile(const resident_file_t &file);
+
+    /// @brief Removes the partial temporary file of a cancelled upload.
+    /// @details The files of the frame slots are kept, the next frames overwrite them.
+    /// @param filename The name of the file.
+    void discard_tmpfile(const std::string &filename);
+
+    /// @brief Reports the progress of an upload, and checks if it has been cancelled.
+    /// @details The writers call it with 0 records before creating their file, then for each record
+    /// or chunk of records; the callback is only called every few thousand records, and at the end.
+    /// @param written The number of records written so far.
+    /// @param total The total number of records, 0 if it is not known.
+    /// @return `false` if the upload has been cancelled, `true` otherwise.
+    auto report_upload(std::size_t written, std::size_t total) -> bool;
+
+    /// @brief Measures the temporary files written since they were last measured.
+    void measure_storage();
+
+    /// @brief Records that a temporary file is referenced by the commands about to be sent.
+    /// @param filename The name of the file.
+    /// @return `false` if the file has been evicted, `true` otherwise.
+    auto use_tmpfile(const std::string &filename) -> bool;
+
+    /// @brief Writes the given columns to a binary temporary file.
+    /// @details Each record is stored as a sequence of doubles, one per column, so that
+    /// gnuplot can read it without parsing any text.
+    /// @tparam Columns The types of the columns.
+    /// @param rows The number of records to write.
+    /// @param columns The columns to write, each one must contain at least `rows` values.
+    /// @return The description of the dataset, invalid if the file could not be written.
+    template <typename... Columns>
+    auto write_dataset(std::size_t rows, const Columns &...columns) -> dataset_t;
+
+    /// @brief Copies a series, and starts building its spatial index in the background.
+    /// @param x The x values.
+    /// @param y The y values.
+    /// @param z The z values, nullptr for 2D series.
+    template <typename X, typename Y, typename Z>
+    void index_series(const X &x, const Y &y, const Z *z);
+
+    /// @brief Streams the records of a chunked source to a binary temporary file.
+    /// @param source The source of the records.
+    /// @param policy What happens to the records holding a non-finite value.
+    /// @return The description of the dataset, invalid if the file could not be written or the source is empty.
+    auto write_source(chunk_source_t &source, nonfinite_policy_t policy) -> dataset_t;
+
+    /// @brief Uploads the samples of a function, and plots them.
+    /// @param samples The samples.
+    /// @param title The title of the plot.
+    /// @return A reference to the current Gnuplot object.
+    auto plot_samples(const sampled_function_t &samples, const std::string &title) -> Gnuplot &;
+
+    /// @brief Plots an uploaded vector field, as arrows.
+    /// @param dataset The dataset, with the coordinates of the arrows followed by their components.
+    /// @param three_d Whether the field is 3D.
+    /// @param title The title of the plot.
+    /// @return A reference to the current Gnuplot object.
+    auto plot_vector_dataset(const dataset_t &dataset, bool three_d, const std::string &title) -> Gnuplot &;
+
+    /// @brief Plots uploaded open/high/low/close bars.
+    /// @param dataset The dataset, with the time, open, low, high and close of each bar.
+    /// @param bar_interval The length of a bar.
+    /// @param title The title of the plot.
+    /// @param style How the bars are drawn.
+    /// @return A reference to the current Gnuplot object.
+    auto plot_candle_dataset(
+        const dataset_t &dataset,
+        double bar_interval,
+        const std::string &title,
+        candle_style_t style) -> Gnuplot &;
+
+    /// @brief Rewrites the bars of the streamed candles file, from a given bar to the end.
+    /// @param bars The bars.
+    /// @param first The first bar to write.
+    /// @return The description of the dataset, invalid if the file could not be written.
+    auto rewrite_candles(const ohlc_bars_t &bars, std::size_t first) -> dataset_t;
+
+    /// @brief Starts the gnuplot process, and opens the pipe used to send the commands.
+    /// @return `true` if gnuplot has been started, `false` otherwise.
+    auto spawn() -> bool;
+
+    /// @brief Closes the pipe to gnuplot, and waits for the process to terminate.
+    void close_pipe();
+
+    /// @brief Writes raw data to the gnuplot pipe.
+    /// @details On POSIX systems, the data is buffered and queued, then written without blocking
+    /// (see set_overload_policy). SIGPIPE is blocked during the write, so that writing to a
+    /// terminated gnuplot fails instead of killing the process.
+    /// @param data The data to write.
+    /// @param flush Whether the pipe should also be flushed.
+    /// @return `true` if the data has been written, `false` otherwise.
+    auto write_pipe(const std::string &data, bool flush = false) -> bool;
+
+    /// @brief Flushes the gnuplot pipe, restarting gnuplot if it has terminated.
+    /// @details Waits up to the write timeout for the queued commands to be written.
+    /// @return `true` if the pipe has been flushed, `false` otherwise.
+    auto flush_pipe() -> bool;
+
+    /// @brief Moves the buffered commands into the outbound queue, applying the overload policy.
+    /// @param frame The frame the commands belong to, 0 if they cannot be dropped.
+    /// @return `true` if the commands have been queued, `false` if they have been rejected.
+    auto seal_outbound(std::size_t frame) -> bool;
+
+    /// @brief Writes the queued commands to gnuplot, without blocking longer than the given time.
+    /// @param timeout_ms The maximum time to wait for gnuplot to read, in milliseconds.
+    /// @return `true` unless writing failed (e.g., gnuplot terminated).
+    auto drain_outbound(unsigned timeout_ms) -> bool;
+
+    /// @brief Drops queued frames that have not been sent yet, oldest first.
+    /// @param limit The maximum number of frames to drop.
+    /// @param frame The only frame to drop, 0 to drop any frame.
+    /// @return The number of dropped frames.
+    auto drop_outbound_frames(std::size_t limit, std::size_t frame = 0) -> std::size_t;
+
+    /// @brief Records a command that must be replayed if gnuplot is restarted.
+    /// @details Settings are coalesced by their name, so only the last value of each one is kept.
+    /// Plot commands are kept since the last command that started a new figure, and only the most
+    /// recent untagged elements (labels, arrows, objects) are kept.
+    /// @param cmdstr The command.
+    /// @return `true` if the command has been recorded, `false` if it is not replayed.
+    auto journal_cmd(const std::string &cmdstr) -> bool;
+
+    /// @brief Handles the termination of gnuplot, restarting it if enabled.
+    /// @return `true` if gnuplot has been restarted and its state restored, `false` otherwise.
+    auto recover() -> bool;
+
+    /// @brief Opens the channel used by gnuplot to acknowledge the frames.
+    /// @return `true` if the channel is open, `false` if it is not supported or cannot be created.
+    auto open_frame_channel() -> bool;
+
+    /// @brief Closes the channel used by gnuplot to acknowledge the frames.
+    void close_frame_channel();
+
+    /// @brief Reads the acknowledgements of the frames sent by gnuplot.
+    /// @param timeout_ms The maximum time to wait for an acknowledgement, in milliseconds.
+    /// @return `true` unless the channel has been closed.
+    auto read_frame_acks(int timeout_ms) -> bool;
+
+    /// @brief Waits until gnuplot has acknowledged a frame.
+    /// @param frame The number of the frame.
+    /// @return `true` if the frame has been acknowledged, `false` on timeout or if the channel is closed.
+    auto wait_frame(std::size_t frame) -> bool;
+
+    /// @brief Records that the commands of a frame have been completely written to the pipe.
+    /// @param frame The number of the frame.
+    void frame_transferred(std::size_t frame);
+
+    /// @brief Accounts for the timings of an acknowledged frame, under a frame budget.
+    /// @param frame The number of the frame.
+    /// @param stamp The rest of the acknowledgement, holding the time at which gnuplot drew the frame.
+    void frame_rendered(std::size_t frame, const char *stamp);
+
+    /// @brief Applies the detail scale chosen by the frame budget to the samples and the transport.
+    void apply_detail();
+
+    /// @brief Scales a number of samples (or isolines) by a detail scale.
+    /// @param samples The number of samples at full detail.
+    /// @param scale The detail scale.
+    /// @param grid Whether the samples are taken along both axes, as isolines are.
+    /// @return The number of samples, at least 2.
+    static auto scale_samples(int samples, double scale, bool grid) -> int;
+
+    /// @brief Selects the records written at the current level of detail.
+    /// @details With the y values, the minimum and the maximum of each bucket of records are kept,
+    /// so the envelope of the series survives; without them, the records are kept at a fixed stride.
+    /// @param n The number of records.
+    /// @param y The y values, nullptr to use a stride.
+    /// @param room The fraction of the records that fits within the storage budget (see reserve_storage).
+    /// @return The indices of the records to write, empty to write all of them.
+    template <typename Y>
+    auto detail_indices(std::size_t n, const Y *y, double room = 1.0) const -> std::vector<std::size_t>;
+
+    /// @brief Removes the records holding a non-finite value, following the non-finite policy.
+    /// @param rows The number of records.
+    /// @param selected The records to write, empty for all of them. Receives the records left.
+    /// @param breaks Receives the positions in `selected` before which an empty line breaks the data.
+    /// @param columns The columns of the records.
+    /// @return `true` if some records are left, `false` otherwise.
+    template <typename... Columns>
+    auto select_finite(
+        std::size_t rows,
+        std::vector<std::size_t> &selected,
+        std::vector<std::size_t> &breaks,
+        const Columns &...columns) const -> bool;
 
     /// @brief Checks if the Gnuplot executable path is valid.
     /// @return `true` if the Gnuplot path is found, `false` otherwise.
     static auto get_program_path() -> bool;
 
+    /// @brief Returns the capabilities of a gnuplot executable, probing it only if they are not cached.
+    /// @param program The path of the executable.
+    /// @return The capabilities, assumed from the previous versions of the library if the probe fails.
+    static auto load_capabilities(const std::string &program) -> capabilities_t;
+
+    /// @brief Runs a gnuplot executable on a test script, to detect its capabilities.
+    /// @param program The path of the executable.
+    /// @return The capabilities, with `probed` set only if the probe completed.
+    static auto probe_capabilities(const std::string &program) -> capabilities_t;
+
+    /// @brief Writes a chunk of records to a data file, as raw doubles or as text.
+    /// @param file The data file.
+    /// @param records The values of the records, one record after the other.
+    /// @param ncolumns The number of values of each record.
+    /// @param binary Whether the values are written as raw doubles.
+    /// @param breaks The records before which a blank line breaks the data, as text only (binary
+    /// gaps are declared as separate records, see dataset_t::segments).
+    /// @return `true` if the records have been written, `false` otherwise.
+    static auto write_records(
+        std::ofstream &file,
+        const std::vector<double> &records,
+        std::size_t ncolumns,
+        bool binary,
+        const std::vector<std::size_t> &breaks) -> bool;
+
     /// @brief Checks if a file is available for use.
     /// @param filename The name of the file to check.
     /// @return `true` if the file exists and is accessible, `false` otherwise.
     static auto file_ready(const std::string &filename) -> bool;
 
+    /// @brief Returns the size of a file.
+    /// @param filename The name of the file.
+    /// @return The size of the file in bytes, 0 if the file cannot be opened.
+    static auto file_size(const std::string &filename) -> std::size_t;
+
     /// @brief Checks if a file exists and satisfies the specified mode.
     /// @param filename The name of the file to check.
     /// @param mode The access mode to check (e.g., read, write, execute). Defaults to 0 (existence only).
@@ -614,6 +1365,24 @@ private:
 
     /// @brief pointer to the stream that can be used to write to the pipe
     FILE *gnuplot_pipe{nullptr};
+    /// @brief The process ID of gnuplot, -1 if unknown.
+    int gnuplot_pid{-1};
+    /// @brief Whether gnuplot is restarted if it terminates unexpectedly.
+    bool auto_respawn{false};
+    /// @brief The settings to replay on a restarted gnuplot, as pairs of name and command.
+    std::vector<std::pair<std::string, std::string>> state_journal;
+    /// @brief The plot commands to replay on a restarted gnuplot.
+    std::vector<std::string> plot_journal;
+
+    struct {
+        overload_policy_t policy = overload_policy_t::block; ///< What to do when the queue is full.
+        std::size_t max_bytes    = 4U << 20U;                ///< The maximum number of bytes in the queue.
+        unsigned timeout_ms      = 1000;                     ///< The write timeout, in milliseconds.
+        std::string buffer;                                  ///< The commands not yet moved into the queue.
+        std::deque<outbound_chunk_t> chunks;                 ///< The queue of chunks to write.
+        std::size_t offset = 0;                              ///< The bytes of the first chunk already written.
+        pipe_metrics_t metrics;                              ///< The statistics about the written data.
+    } outbound;
 
     /// @brief standart terminal, used by show.
     terminal_type_t terminal_type{terminal_type_t::wxt};
@@ -623,6 +1392,8 @@ private:
     bool two_dim{true};
     /// @brief number of plots in session
     int nplots{0};
+    /// @brief true if the x-axis is configured as a time axis.
+    bool xtime{false};
 
     /// The line width for plotted lines.
     double line_width{1.0};
@@ -651,6 +1422,32 @@ private:
 
     /// @brief list of created tmpfiles.
     std::vector<std::string> tmpfile_list;
+    /// @brief The memory files backing the temporary files, with the memfd transport.
+    std::vector<int> memfd_list;
+    /// @brief The features supported by gnuplot.
+    capabilities_t capabilities;
+    /// @brief How the data of the plots is handed to gnuplot.
+    transport_t transport{transport_t::binary_file};
+    /// @brief What happens to the records holding a non-finite value.
+    nonfinite_policy_t nonfinite{nonfinite_policy_t::gap};
+
+    struct {
+        upload_progress_t progress; ///< Called while the uploads are written, may be empty.
+        cancel_token_t cancel;      ///< The token cancelling the uploads.
+        std::size_t reported = 0;   ///< The records written when the progress was last reported.
+    } uploads;
+
+    struct {
+        std::uint64_t source = 0; ///< The identifier of the stream whose bars are in the file, 0 for none.
+        std::string filename;     ///< The file holding the bars, as raw doubles.
+        std::size_t written = 0;  ///< The number of bars in the file.
+        std::size_t frame   = 0;  ///< The last frame begun when the file was plotted.
+    } candles;
+
+    struct {
+        bool enabled = false;                                               ///< Whether the series are indexed.
+        std::vector<std::shared_future<std::shared_ptr<const kd_tree_t>>> series; ///< The indexes of the current plot.
+    } spatial;
 
     /// @brief ID for major grid style.
     int grid_major_style_id{-1};
@@ -661,17 +1458,79 @@ private:
     id_manager_t id_manager_line_style;
     /// @brief Keeps track of the used IDs for the textbox styles.
     id_manager_t id_manager_textbox_style;
+    /// @brief IDs of the textbox styles used by the current labels.
+    std::vector<int> label_box_style_ids;
+
+    struct {
+        std::size_t depth        = 2;                ///< The number of frames in flight.
+        std::size_t count        = 0;                ///< The number of frames started.
+        std::size_t acknowledged = 0;                ///< The last frame consumed by gnuplot.
+        bool active              = false;            ///< Whether a frame is being built.
+        std::size_t slot         = 0;                ///< The slot of the current frame.
+        std::size_t next_file    = 0;                ///< The next temporary file of the current slot.
+        std::vector<std::vector<std::string>> files; ///< The temporary files of each slot.
+        std::vector<std::size_t> owners;             ///< The last frame of each slot, 0 if none.
+        std::string channel;                         ///< The FIFO receiving the acknowledgements.
+        int fd = -1;                                 ///< The read end of the FIFO, -1 if closed.
+        std::string received;                        ///< Text received and not yet parsed.
+        std::unordered_set<std::size_t> dropped;     ///< The frames dropped before being sent.
+        std::deque<std::size_t> sent;                ///< The frames sent and not acknowledged yet.
+    } frames;
+
+    struct {
+        lod_controller_t controller;                   ///< Chooses the detail from the timings.
+        double applied = 1.0;                          ///< The detail scale applied to the settings.
+        int samples    = -1;                           ///< The samples requested by the user, -1 if none.
+        int isosamples = -1;                           ///< The isosamples requested by the user, -1 if none.
+        std::chrono::steady_clock::time_point started; ///< When the current frame was started.
+        std::map<std::size_t, frame_timing_t> timings; ///< The timings of the frames not acknowledged yet.
+        /// @brief When the transfer of each of those frames started, then ended.
+        std::map<std::size_t, std::chrono::steady_clock::time_point> marks;
+    } budget;
+
+    struct {
+        std::size_t max_bytes   = 0;                         ///< The budget, 0 for no limit.
+        storage_policy_t policy = storage_policy_t::degrade; ///< What happens to the data that does not fit.
+        resident_set_t files;                                ///< The temporary files, by order of use.
+        std::unordered_set<std::string> figure;              ///< The files referenced by the current figure.
+        std::unordered_set<std::string> pending;             ///< The files used since the last command.
+        std::unordered_set<std::string> evicted;             ///< The files evicted, which cannot be plotted.
+        storage_metrics_t metrics;                           ///< The statistics.
+    } storage;
+
+    struct {
+        bool active    = false;               ///< Whether multiplot mode is enabled.
+        bool capturing = false;               ///< Whether commands are cached without being sent.
+        int panel      = -1;                  ///< The panel receiving the commands, -1 if none.
+        std::string prologue;                 ///< The commands entering multiplot mode.
+        std::string epilogue;                 ///< The commands leaving multiplot mode.
+        std::vector<panel_commands_t> panels; ///< The cached commands of each panel.
+    } multiplot;
 
     /// @brief number of all tmpfiles (number of tmpfiles restricted)
-    static std::size_t m_tmpfile_num;
+    /// @details The counter is shared by the sessions of all the threads, hence atomic.
+    /// @return A reference to the number of temporary files.
+    static auto m_tmpfile_num() -> std::atomic<std::size_t> &;
+    /// @brief Removes some files from the number of all tmpfiles.
+    /// @param count The number of files removed.
+    /// @return `false` if fewer files were counted, in which case the number is reset to 0.
+    static auto uncount_tmpfiles(std::size_t count) -> bool;
     /// @brief Maximum number of opened files.
-    static const std::size_t m_tmpfile_max;
+    /// @return The maximum number of temporary files.
+    static auto m_tmpfile_max() -> std::size_t;
     /// @brief name of executed GNUPlot file
-    static std::string m_gnuplot_filename;
+    /// @return A reference to the name of the executable.
+    static auto m_gnuplot_filename() -> std::string &;
     /// @brief gnuplot path
-    static std::string m_gnuplot_path;
+    /// @return A reference to the directory of the executable.
+    static auto m_gnuplot_path() -> std::string &;
 };
 
 } // namespace gpcpp
 
-#include "gnuplot.i.hpp"
\ No newline at end of file
+#include "gnuplot.t.hpp"
+
+// With the compiled library, the other definitions are in gpcpp_static or gpcpp_shared.
+#if !defined(GPCPP_COMPILED_LIB)
+#include "gnuplot.i.hpp"
+#endif
\ No newline at end of file
@@ -5,65 +5,118 @@
 
 #include "gnuplot.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstring>
+#include <iomanip>
+#include <iterator>
+#include <limits>
 #include <type_traits>
 
 namespace gpcpp
 {
 
-/// @brief Checks if the specified style is a line style.
-/// @param style The plot style to check.
-/// @return true if the style is a line style, false otherwise.
-static auto is_line_type(plot_type_t style) -> bool
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+/// @brief Blocks SIGPIPE in the calling thread, for as long as the guard exists.
+/// @details Writing to a terminated gnuplot then fails with EPIPE, instead of killing the
+/// process. A SIGPIPE raised while the guard exists is discarded.
+class sigpipe_guard_t
+{
+public:
+    /// @brief Constructor, blocks SIGPIPE.
+    sigpipe_guard_t()
+        : mask()
+        , old_mask()
+        , was_pending(false)
+    {
+        sigset_t pending;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGPIPE);
+        sigpending(&pending);
+        was_pending = (sigismember(&pending, SIGPIPE) == 1);
+        pthread_sigmask(SIG_BLOCK, &mask, &old_mask);
+    }
+
+    /// @brief Destructor, discards our own SIGPIPE and restores the signal mask.
+    ~sigpipe_guard_t()
+    {
+        sigset_t pending;
+        sigpending(&pending);
+        if (!was_pending && (sigismember(&pending, SIGPIPE) == 1)) {
+            int sig = 0;
+            sigwait(&mask, &sig);
+        }
+        pthread_sigmask(SIG_SETMASK, &old_mask, nullptr);
+    }
+
+    /// @brief The guard cannot be copied.
+    sigpipe_guard_t(const sigpipe_guard_t &) = delete;
+
+    /// @brief The guard cannot be copied.
+    /// @return A reference to the guard.
+    auto operator=(const sigpipe_guard_t &) -> sigpipe_guard_t & = delete;
+
+private:
+    sigset_t mask;     ///< The mask containing only SIGPIPE.
+    sigset_t old_mask; ///< The mask in place before the guard.
+    bool was_pending;  ///< Whether a SIGPIPE was already pending before the guard.
+};
+#endif
+
+// The static variables are function-local, so that they are defined once even when this file is
+// included by several translation units.
+GPCPP_INLINE auto Gnuplot::m_tmpfile_num() -> std::atomic<std::size_t> &
 {
-    return (
-        style == plot_type_t::lines || style == plot_type_t::lines_points || style == plot_type_t::steps ||
-        style == plot_type_t::fsteps || style == plot_type_t::histeps || style == plot_type_t::filled_curves ||
-        style == plot_type_t::impulses);
+    static std::atomic<std::size_t> tmpfile_num{0};
+    return tmpfile_num;
+}
+
+GPCPP_INLINE auto Gnuplot::uncount_tmpfiles(std::size_t count) -> bool
+{
+    std::size_t current = Gnuplot::m_tmpfile_num().load();
+    while (!Gnuplot::m_tmpfile_num().compare_exchange_weak(current, (current >= count) ? current - count : 0)) {
+    }
+    return current >= count;
 }
 
-/// @brief Checks if the specified style is a point style.
-/// @param style The plot style to check.
-/// @return true if the style is a point style, false otherwise.
-static auto is_point_type(plot_type_t style) -> bool
+GPCPP_INLINE auto Gnuplot::m_tmpfile_max() -> std::size_t
 {
-    return (style == plot_type_t::points || style == plot_type_t::lines_points);
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__TOS_WIN__)
+    return 27;
+#else
+    return 64;
+#endif
 }
 
-/// @brief Checks if the difference between two floating-point values exceeds a tolerance.
-/// @param a The first value.
-/// @param b The second value.
-/// @param tolerance The allowable difference (default is 1e-6).
-/// @returns True if the difference exceeds the tolerance, false otherwise.
-template <typename T>
-inline auto are_equal(T a, T b, T tolerance = 1e-6) -> bool
+GPCPP_INLINE auto Gnuplot::m_gnuplot_filename() -> std::string &
 {
-    static_assert(std::is_floating_point<T>::value, "exceeds_tolerance requires floating-point types.");
-    return std::abs(a - b) > tolerance;
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__TOS_WIN__)
+    static std::string gnuplot_filename = "pgnuplot.exe";
+#else
+    static std::string gnuplot_filename = "gnuplot";
+#endif
+    return gnuplot_filename;
 }
 
+GPCPP_INLINE auto Gnuplot::m_gnuplot_path() -> std::string &
+{
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__TOS_WIN__)
-// Windows-specific static variable initializations
-std::string Gnuplot::m_gnuplot_filename  = "pgnuplot.exe";
-std::string Gnuplot::m_gnuplot_path      = "C:/program files/gnuplot/bin/";
-std::size_t Gnuplot::m_tmpfile_num       = 0;
-const std::size_t Gnuplot::m_tmpfile_max = 27;
-#elif defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
-// UNIX-like system static variable initializations
-std::string Gnuplot::m_gnuplot_filename  = "gnuplot";
-std::string Gnuplot::m_gnuplot_path      = "/usr/local/bin/";
-std::size_t Gnuplot::m_tmpfile_num       = 0;
-const std::size_t Gnuplot::m_tmpfile_max = 64;
+    static std::string gnuplot_path = "C:/program files/gnuplot/bin/";
+#else
+    static std::string gnuplot_path = "/usr/local/bin/";
 #endif
+    return gnuplot_path;
+}
 
-Gnuplot::Gnuplot(bool _debug)
+GPCPP_INLINE Gnuplot::Gnuplot(bool _debug)
     : debug(_debug)                       // Debug is disabled.
     , gnuplot_pipe(nullptr)               // No active pipe initially
     , terminal_type(terminal_type_t::wxt) // Default terminal type is wxt
     , valid(false)                        // Invalid session by default
     , two_dim(true)                       // 2D plotting by default
     , nplots(0)                           // No plots initially
+    , xtime(false)                        // Numeric x-axis by default
     , line_width(1.0)                     // Default line width
     , plot_type(plot_type_t::lines)       // Default plot style is lines
     , smooth_type(smooth_type_t::none)    // No smoothing by default
@@ -90,17 +143,12 @@ Gnuplot::Gnuplot(bool _debug)
         return;
     }
 
-// Try to open a pipe to Gnuplot.
-#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__TOS_WIN__)
-    gnuplot_pipe = _popen((Gnuplot::m_gnuplot_path + "/" + Gnuplot::m_gnuplot_filename).c_str(), "w");
-#elif defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
-    gnuplot_pipe = popen((Gnuplot::m_gnuplot_path + "/" + Gnuplot::m_gnuplot_filename).c_str(), "w");
-#else
-    std::cerr << "Error: Unsupported platform for opening a pipe to Gnuplot.\n";
-    valid = false;
-    return;
-#endif
-    if (gnuplot_pipe == nullptr) {
+    // Detect what gnuplot supports, the probe runs only once per executable.
+    capabilities = Gnuplot::load_capabilities(Gnuplot::m_gnuplot_path() + "/" + Gnuplot::m_gnuplot_filename());
+    transport    = capabilities.best_transport();
+
+    // Try to open a pipe to Gnuplot.
+    if (!this->spawn()) {
         std::cerr << "Error: Unable to open pipe to Gnuplot.\n";
         valid = false;
         return;
@@ -133,31 +181,20 @@ Gnuplot::Gnuplot(bool _debug)
     tmpfile_list.clear();
 }
 
-Gnuplot::~Gnuplot()
+GPCPP_INLINE Gnuplot::~Gnuplot()
 {
 
     // Close the communication pipe to Gnuplot if it's open
-    if (gnuplot_pipe != nullptr) {
-#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__TOS_WIN__)
-        if (_pclose(gnuplot_pipe) == -1) {
-            std::cerr << "Warning: Problem closing communication to Gnuplot.\n";
-        }
-#elif defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
-        if (pclose(gnuplot_pipe) == -1) {
-            std::cerr << "Warning: Problem closing communication to Gnuplot.\n";
-        }
-#else
-        std::cerr << "Error: Unsupported platform for closing Gnuplot pipe.\n";
-#endif
-        // Avoid dangling pointer.
-        gnuplot_pipe = nullptr;
-    }
+    close_pipe();
+
+    // Close the channel of the frames, now that gnuplot has stopped writing to it.
+    close_frame_channel();
 
     // Remove all temporary files created during the session
     remove_tmpfiles();
 }
 
-auto Gnuplot::send_cmd(const std::string &cmdstr) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::send_cmd(const std::string &cmdstr) -> Gnuplot &
 {
     // Check if the Gnuplot session is ready.
     if (!this->is_ready()) {
@@ -165,12 +202,26 @@ auto Gnuplot::send_cmd(const std::string &cmdstr) -> Gnuplot &
         return *this;
     }
 
-    if (debug) {
-        std::cout << cmdstr.c_str() << "\n";
+    // Cache the commands drawing the current multiplot panel.
+    if (multiplot.panel >= 0) {
+        multiplot.panels[static_cast<std::size_t>(multiplot.panel)].commands += cmdstr + "\n";
     }
 
-    // Write the command to the Gnuplot pipe.
-    fprintf(gnuplot_pipe, "%s\n", cmdstr.c_str());
+    // While a panel is being updated, its commands are only cached.
+    if (!multiplot.capturing) {
+        if (debug) {
+            std::cout << cmdstr.c_str() << "\n";
+        }
+
+        // Record the command, to replay it if gnuplot has to be restarted.
+        const bool journaled = auto_respawn && this->journal_cmd(cmdstr);
+
+        // Write the command to the Gnuplot pipe, restarting gnuplot if it terminated. The recorded
+        // commands are replayed by the restart, the other ones must be sent again.
+        if (!this->write_pipe(cmdstr + "\n") && this->recover() && !journaled) {
+            this->write_pipe(cmdstr + "\n");
+        }
+    }
 
     // Check and update state based on the command type.
     if (cmdstr.find("replot") != std::string::npos) {
@@ -180,17 +231,43 @@ auto Gnuplot::send_cmd(const std::string &cmdstr) -> Gnuplot &
     else if (cmdstr.find("splot") == 0) {
         two_dim = false;
         nplots++;
+        // A new plot, the series of the previous one cannot be queried anymore.
+        spatial.series.clear();
+        // Nor are the files of the previous figure read again, unless they are panels of the same multiplot.
+        if (!multiplot.active && !multiplot.capturing) {
+            storage.figure.clear();
+        }
     }
     // Command starts with "plot".
     else if (cmdstr.find("plot") == 0) {
         two_dim = true;
         nplots++;
+        spatial.series.clear();
+        if (!multiplot.active && !multiplot.capturing) {
+            storage.figure.clear();
+        }
+    }
+
+    // The files used by the command are complete, and now belong to the current figure.
+    if (!storage.pending.empty()) {
+        this->measure_storage();
+        storage.figure.insert(storage.pending.begin(), storage.pending.end());
+        // Remember the files of the current multiplot panel, they are read again by each refresh.
+        if (multiplot.panel >= 0) {
+            std::vector<std::string> &files = multiplot.panels[static_cast<std::size_t>(multiplot.panel)].files;
+            for (const std::string &filename : storage.pending) {
+                if (std::find(files.begin(), files.end(), filename) == files.end()) {
+                    files.push_back(filename);
+                }
+            }
+        }
+        storage.pending.clear();
     }
 
     return *this;
 }
 
-auto Gnuplot::plot_vertical_line(double x) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::plot_vertical_line(double x) -> Gnuplot &
 {
     // Check if the Gnuplot session is ready.
     if (!this->is_ready()) {
@@ -225,7 +302,7 @@ auto Gnuplot::plot_vertical_line(double x) -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::plot_horizontal_line(double y) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::plot_horizontal_line(double y) -> Gnuplot &
 {
     // Check if the Gnuplot session is ready.
     if (!this->is_ready()) {
@@ -260,7 +337,7 @@ auto Gnuplot::plot_horizontal_line(double y) -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::plot_vertical_range(double x, double y_min, double y_max) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::plot_vertical_range(double x, double y_min, double y_max) -> Gnuplot &
 {
     // Check if the Gnuplot session is ready.
     if (!this->is_ready()) {
@@ -294,7 +371,7 @@ auto Gnuplot::plot_vertical_range(double x, double y_min, double y_max) -> Gnupl
     return *this;
 }
 
-auto Gnuplot::plot_horizontal_range(double y, double x_min, double x_max) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::plot_horizontal_range(double y, double x_min, double x_max) -> Gnuplot &
 {
     // Check if the Gnuplot session is ready.
     if (!this->is_ready()) {
@@ -328,7 +405,7 @@ auto Gnuplot::plot_horizontal_range(double y, double x_min, double x_max) -> Gnu
     return *this;
 }
 
-auto Gnuplot::add_label(
+GPCPP_INLINE auto Gnuplot::add_label(
     double x,
     double y,
     const std::string &label,
@@ -352,6 +429,8 @@ auto Gnuplot::add_label(
         box_style_id = id_manager_textbox_style.generate_unique_id();
         // Generate the style.
         this->send_cmd(box_style.get_declaration(box_style_id));
+        // Keep track of the style, so that it can be released with the label.
+        label_box_style_ids.push_back(box_style_id);
     }
 
     oss << "set label \"" << label << "\" at " << x << "," << y;
@@ -398,274 +477,244 @@ auto Gnuplot::add_label(
     return *this;
 }
 
-template <typename X>
-auto Gnuplot::plot_x(const X &x, const std::string &title) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::remove_labels() -> Gnuplot &
 {
-    // Check if the Gnuplot session is ready.
+    this->send_cmd("unset label");
+    // Release the textbox styles used by the labels.
+    for (const auto &box_style_id : label_box_style_ids) {
+        id_manager_textbox_style.release(box_style_id);
+    }
+    label_box_style_ids.clear();
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::plot_source(chunk_source_t &source, const std::string &using_spec, const std::string &title)
+    -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
     if (!this->is_ready()) {
-        std::cerr << "Error: Invalid Gnuplot session not ready.\n";
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
         return *this;
     }
 
-    // Check if the input vector is empty.
-    if (x.empty()) {
-        std::cerr << "Error: Input vector is empty. Cannot plot data." << '\n';
+    // Validate the source.
+    if (source.columns() == 0) {
+        std::cerr << "Error: The source provides records with no columns. Cannot plot.\n";
         return *this;
     }
 
-    // Create a temporary file for storing the data
-    std::ofstream file;
-    std::string filename = this->create_tmpfile(file);
-    if (filename.empty()) {
-        std::cerr << "Error: Temporary file filename is empty. File creation failed." << '\n';
+    // Stream the records to a binary dataset.
+    dataset_t dataset = this->write_source(source, nonfinite);
+    if (!dataset.is_valid()) {
         return *this;
     }
 
-    // Write the data to the temporary file
-    for (size_t i = 0; i < x.size(); ++i) {
-        if (!(file << x[i] << '\n')) {
-            file.close();
-            std::cerr << "Error: Failed to write data to the temporary file: " << filename << '\n';
-            return *this;
-        }
+    return this->plot_dataset(dataset, using_spec, title);
+}
+
+GPCPP_INLINE auto Gnuplot::plot_aligned(aligned_series_t &aligned, const std::vector<std::string> &titles)
+    -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
+        return *this;
     }
 
-    // Ensure the file buffer is flushed
-    file.flush();
-    if (file.fail()) {
-        file.close();
-        std::cerr << "Error: Failed to flush data to the temporary file: " << filename << '\n';
+    // Validate the series.
+    if ((aligned.count() == 0) || aligned.get_grid().empty()) {
+        std::cerr << "Error: There are no aligned series. Cannot plot.\n";
         return *this;
     }
-    file.close();
 
-    // Check if the file is available for reading.
-    if (!gpcpp::Gnuplot::file_ready(filename)) {
-        std::cerr << "Error: File " << filename << " is not available for reading." << '\n';
+    // All the series share the same file. A series is NaN outside its range, which must not drop the
+    // grid points of the other series: the values are written as they are, and each plot skips its own.
+    dataset_t dataset = this->write_source(aligned, nonfinite_policy_t::passthrough);
+    if (!dataset.is_valid()) {
+        return *this;
+    }
+    for (std::size_t k = 0; k < aligned.count(); ++k) {
+        this->plot_dataset(dataset, "1:" + std::to_string(k + 2), (k < titles.size()) ? titles[k] : "");
+    }
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::plot_samples(const sampled_function_t &samples, const std::string &title) -> Gnuplot &
+{
+    dataset_t dataset = this->write_dataset(samples.x.size(), samples.x, samples.y);
+    if (!dataset.is_valid()) {
+        return *this;
+    }
+    this->plot_dataset(dataset, "1:2", title);
+    if (spatial.enabled) {
+        this->index_series(samples.x, samples.y, static_cast<const std::vector<double> *>(nullptr));
+    }
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::plot_vector_dataset(const dataset_t &dataset, bool three_d, const std::string &title)
+    -> Gnuplot &
+{
+    if (!dataset.is_valid()) {
+        return *this;
+    }
+    if (!this->use_tmpfile(dataset.filename)) {
+        std::cerr << "Error: The dataset has been evicted to stay within the storage budget, upload it again. "
+                     "Cannot plot.\n";
         return *this;
     }
 
     std::ostringstream oss;
-    // Determine whether to use 'plot' or 'replot' based on the current plot state.
-    oss << ((nplots > 0 && two_dim) ? "replot" : "plot");
-    // Specify the file and columns for the Gnuplot command.
-    oss << " \"" << filename << "\" using 1";
-    // Add a title or specify 'notitle' if no title is provided.
-    oss << (title.empty() ? " notitle " : " title \"" + title + "\"");
-    // Specify the plot style or smoothing option.
-    if (smooth_type == smooth_type_t::none) {
-        oss << " with " << plot_type_to_string(plot_type);
+    // Determine whether to use 'plot', 'splot' or 'replot' based on the current plot state
+    if (three_d) {
+        oss << ((nplots > 0 && !two_dim) ? "replot " : "splot ");
     } else {
-        oss << " smooth " << smooth_type_to_string(smooth_type);
+        oss << ((nplots > 0 && two_dim) ? "replot " : "plot ");
     }
+    // Specify the dataset, the start of each arrow and its components
+    oss << dataset.get_declaration() << " using " << (three_d ? "1:2:3:4:5:6" : "1:2:3:4");
+    // Add a title or specify 'notitle' if no title is provided
+    oss << (title.empty() ? " notitle" : " title \"" + title + "\"");
+    oss << " with vectors";
     // Include line color if it is specified.
     if (line_color.is_set()) {
         oss << " lc rgbcolor \"" << line_color.to_string() << "\"";
     }
-    // Add line style options only if the plot style supports lines.
-    if (is_line_type(plot_type)) {
-        // Add line width if specified.
-        if (line_width > 0) {
-            oss << " lw " << line_width;
-        }
-        // Add line style if specified.
-        if (!line_type.empty()) {
-            oss << " " << line_type;
-        }
-    }
-    // Add point style and size only if the plot style supports points.
-    if (is_point_type(plot_type)) {
-        // Add point style if specified.
-        oss << " pt " << point_type_to_string(point_type);
-        // Add point size if specified.
-        if (point_size > 0) {
-            oss << " ps " << point_size;
-        }
+    // Add line width if specified.
+    if (line_width > 0) {
+        oss << " lw " << line_width;
     }
     // Send the constructed command to Gnuplot for execution
     this->send_cmd(oss.str());
-
     return *this;
 }
 
-template <typename X>
-auto Gnuplot::plot_x(const std::vector<X> &datasets, const std::vector<std::string> &titles) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::plot_candles(const ohlc_stream_t &stream, const std::string &title, candle_style_t style)
+    -> Gnuplot &
 {
     // Check if the Gnuplot session is ready
     if (!this->is_ready()) {
-        std::cerr << "Error: Invalid Gnuplot session not ready.\n";
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
         return *this;
     }
 
-    // Validate input data
-    if (datasets.empty()) {
-        std::cerr << "Error: Input datasets are empty. Cannot plot.\n";
+    const ohlc_bars_t &bars = stream.get_bars();
+    if (bars.size() == 0) {
+        std::cerr << "Error: The stream has no bars yet. Cannot plot.\n";
         return *this;
     }
 
-    if (!titles.empty() && titles.size() != datasets.size()) {
-        std::cerr << "Error: Mismatch between the number of datasets and titles.\n";
+    // The bars already in the file are kept, except the newest one, which may have changed. Inside
+    // a frame the files belong to the slot of the frame, so they are written again. The file is only
+    // rewritten once gnuplot has read it for the previous plot: either the frame following that plot
+    // has been acknowledged, or, without acknowledgements, the plot command has left the queue.
+    const bool in_frame = frames.active && (frames.fd >= 0);
+    const bool read     = (frames.fd >= 0) ? (frames.acknowledged > candles.frame)
+                                           : (outbound.buffer.empty() && outbound.chunks.empty());
+    const bool in_place = (candles.source == stream.get_id()) && (candles.written > 0) &&
+                          (candles.written <= bars.size()) && (transport != transport_t::text_file) && !in_frame &&
+                          read && storage.files.contains(candles.filename) &&
+                          (storage.evicted.count(candles.filename) == 0);
+    dataset_t dataset = in_place ? this->rewrite_candles(bars, candles.written - 1) : dataset_t();
+    if (!dataset.is_valid()) {
+        dataset = this->write_dataset(bars.size(), bars.time, bars.open, bars.low, bars.high, bars.close);
+    }
+    if (!dataset.is_valid()) {
+        candles.source = 0;
         return *this;
     }
+    // A file reduced to fit within the storage budget, or owned by a frame, cannot be updated in place.
+    const bool reusable = dataset.binary && !in_frame && (dataset.rows == bars.size()) && dataset.segments.empty();
+    candles.source      = reusable ? stream.get_id() : 0;
+    candles.filename    = dataset.filename;
+    candles.written     = reusable ? bars.size() : 0;
+    candles.frame       = frames.count;
+    return this->plot_candle_dataset(dataset, stream.get_interval(), title, style);
+}
 
-    std::vector<std::string> filenames;
-    filenames.reserve(datasets.size());
-
-    // Create temporary files for each dataset
-    for (size_t i = 0; i < datasets.size(); ++i) {
-        if (datasets[i].empty()) {
-            std::cerr << "Error: Dataset " << i + 1 << " is empty. Skipping.\n";
-            continue;
-        }
-
-        std::ofstream file;
-        std::string filename = this->create_tmpfile(file);
-        if (filename.empty()) {
-            std::cerr << "Error: Temporary file creation failed for dataset " << i + 1 << ". Skipping.\n";
-            continue;
-        }
-
-        for (const auto &value : datasets[i]) {
-            if (!(file << value << '\n')) {
-                std::cerr << "Error: Failed to write data to temporary file: " << filename << ". Skipping dataset.\n";
-                file.close();
-                continue;
-            }
-        }
-
-        file.flush();
-        if (file.fail()) {
-            std::cerr << "Error: Failed to flush data to temporary file: " << filename << ". Skipping dataset.\n";
-            file.close();
-            continue;
-        }
-        file.close();
-
-        filenames.push_back(filename);
-    }
-
-    if (filenames.empty()) {
-        std::cerr << "Error: No valid datasets to plot.\n";
+GPCPP_INLINE auto Gnuplot::plot_candle_dataset(
+    const dataset_t &dataset,
+    double bar_interval,
+    const std::string &title,
+    candle_style_t style) -> Gnuplot &
+{
+    if (!dataset.is_valid()) {
         return *this;
     }
-
-    // Check if the file is available for reading.
-    for (const auto &filename : filenames) {
-        if (!gpcpp::Gnuplot::file_ready(filename)) {
-            std::cerr << "Error: File " << filename << " is not available for reading.\n";
-            return *this;
-        }
+    if (!this->use_tmpfile(dataset.filename)) {
+        std::cerr << "Error: The dataset has been evicted to stay within the storage budget, upload it again. "
+                     "Cannot plot.\n";
+        return *this;
     }
 
     std::ostringstream oss;
-
-    // Determine the command ('plot' or 'replot')
+    // Determine whether to use 'plot' or 'replot' based on the current plot state
     oss << ((nplots > 0 && two_dim) ? "replot " : "plot ");
-
-    // Construct the plotting command for each dataset
-    for (size_t i = 0; i < filenames.size(); ++i) {
-        oss << "\"" << filenames[i] << "\" using 1";
-
-        // Add title
-        if (titles.empty() || titles[i].empty()) {
-            oss << " notitle ";
-        } else {
-            oss << " title \"" << titles[i] << "\" ";
-        }
-
-        // Specify plot style or smoothing
-        if (smooth_type == smooth_type_t::none) {
-            oss << " with " << plot_type_to_string(plot_type);
-        } else {
-            oss << " smooth " << smooth_type_to_string(smooth_type);
-        }
-
-        // Add line options if applicable
-        if (is_line_type(plot_type)) {
-            if (line_width > 0) {
-                oss << " lw " << line_width;
-            }
-            if (line_color.is_set()) {
-                oss << " lc rgbcolor \"" << line_color.to_string() << "\"";
-            }
-        }
-
-        // Add point options if applicable
-        if (is_point_type(plot_type)) {
-            oss << " pt " << point_type_to_string(point_type);
-            if (point_size > 0) {
-                oss << " ps " << point_size;
-            }
-        }
-
-        // Add a comma unless it's the last dataset
-        if (i != filenames.size() - 1) {
-            oss << ", ";
-        }
+    // Specify the dataset and the columns: time, open, low, high and close
+    oss << dataset.get_declaration() << " using 1:2:3:4:5";
+    // The boxes of the candlesticks leave some room between two bars.
+    if (style == candle_style_t::candlesticks) {
+        oss << ":(" << 0.8 * bar_interval << ")";
     }
-
-    // Send the constructed command to Gnuplot
+    // Add a title or specify 'notitle' if no title is provided
+    oss << (title.empty() ? " notitle" : " title \"" + title + "\"");
+    oss << " with " << candle_style_to_string(style);
+    // Include line color if it is specified.
+    if (line_color.is_set()) {
+        oss << " lc rgbcolor \"" << line_color.to_string() << "\"";
+    }
+    // Add line width if specified.
+    if (line_width > 0) {
+        oss << " lw " << line_width;
+    }
+    // Send the constructed command to Gnuplot for execution
     this->send_cmd(oss.str());
-
     return *this;
 }
 
-template <typename X, typename Y>
-auto Gnuplot::plot_xy(const X &x, const Y &y, const std::string &title) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::upload(chunk_source_t &source) -> dataset_t
 {
     // Check if the Gnuplot session is ready
     if (!this->is_ready()) {
-        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
-        return *this;
+        std::cerr << "Error: Invalid Gnuplot session. Cannot upload.\n";
+        return dataset_t();
     }
 
-    // Validate input vectors
-    if (x.empty() || y.empty()) {
-        std::cerr << "Error: Input vectors are empty. Cannot plot.\n";
-        return *this;
+    // Validate the source.
+    if (source.columns() == 0) {
+        std::cerr << "Error: The source provides records with no columns. Cannot upload.\n";
+        return dataset_t();
     }
+    return this->write_source(source, nonfinite);
+}
 
-    if (x.size() != y.size()) {
-        std::cerr << "Error: Mismatch between the lengths of x and y vectors.\n";
+GPCPP_INLINE auto Gnuplot::plot_dataset(
+    const dataset_t &dataset,
+    const std::string &using_spec,
+    const std::string &title) -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
         return *this;
     }
 
-    // Create a temporary file for storing the data
-    std::ofstream file;
-    std::string filename = this->create_tmpfile(file);
-    if (filename.empty()) {
-        std::cerr << "Error: Failed to create a temporary file.\n";
+    // Validate the dataset.
+    if (!dataset.is_valid()) {
+        std::cerr << "Error: Invalid dataset. Cannot plot.\n";
         return *this;
     }
-
-    // Write the data to the temporary file
-    for (size_t i = 0; i < x.size(); ++i) {
-        if (!(file << x[i] << " " << y[i] << '\n')) {
-            std::cerr << "Error: Failed to write data to the temporary file: " << filename << '\n';
-            file.close();
-            return *this;
-        }
-    }
-
-    // Flush the file buffer and close the file
-    file.flush();
-    if (file.fail()) {
-        std::cerr << "Error: Failed to flush data to the temporary file: " << filename << '\n';
-        file.close();
+    if (!this->use_tmpfile(dataset.filename)) {
+        std::cerr << "Error: The dataset has been evicted to stay within the storage budget, upload it again. "
+                     "Cannot plot.\n";
         return *this;
     }
-    file.close();
 
-    // Check if the file is available for reading
-    if (!gpcpp::Gnuplot::file_ready(filename)) {
-        std::cerr << "Error: File " << filename << " is not available for reading.\n";
-        return *this;
-    }
     std::ostringstream oss;
     // Determine whether to use 'plot' or 'replot' based on the current plot state
-    oss << ((nplots > 0 && two_dim) ? "replot" : "plot");
-    // Specify the file and columns for the Gnuplot command
-    oss << " \"" << filename << "\" using 1:2";
+    oss << ((nplots > 0 && two_dim) ? "replot " : "plot ");
+    // Specify the dataset and columns for the Gnuplot command
+    oss << dataset.get_declaration() << " using " << using_spec;
     // Add a title or specify 'notitle' if no title is provided
     oss << (title.empty() ? " notitle" : " title \"" + title + "\"");
     // Specify the plot style or smoothing option.
@@ -704,9 +753,7 @@ auto Gnuplot::plot_xy(const X &x, const Y &y, const std::string &title) -> Gnupl
     return *this;
 }
 
-template <typename X, typename Y, typename E>
-auto Gnuplot::plot_xy_erorrbar(const X &x, const Y &y, const E &dy, erorrbar_type_t style, const std::string &title)
-    -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::plot_layout(const multiplot_layout_t &layout) -> Gnuplot &
 {
     // Check if the Gnuplot session is ready
     if (!this->is_ready()) {
@@ -714,162 +761,87 @@ auto Gnuplot::plot_xy_erorrbar(const X &x, const Y &y, const E &dy, erorrbar_typ
         return *this;
     }
 
-    // Validate input vectors
-    if (x.empty() || y.empty() || dy.empty()) {
-        std::cerr << "Error: Input vectors are empty. Cannot plot.\n";
+    // Validate the layout.
+    if (!layout.is_valid()) {
+        std::cerr << "Error: The layout references an invalid dataset. Cannot plot.\n";
         return *this;
     }
 
-    if (x.size() != y.size() || x.size() != dy.size()) {
-        std::cerr << "Error: Mismatch between the lengths of x, y, and dy vectors.\n";
-        return *this;
+    // The datasets of the layout make up the new figure.
+    storage.figure.clear();
+    for (const std::string &filename : layout.get_filenames()) {
+        if (!this->use_tmpfile(filename)) {
+            std::cerr << "Error: The layout references an evicted dataset, upload it again. Cannot plot.\n";
+            return *this;
+        }
     }
 
-    // Create a temporary file for storing the data
-    std::ofstream file;
-    std::string filename = this->create_tmpfile(file);
-    if (filename.empty()) {
-        std::cerr << "Error: Failed to create a temporary file.\n";
-        return *this;
-    }
+    // Send the whole multiplot at once.
+    this->send_cmd(layout.get_commands());
+    this->flush_pipe();
 
-    // Write the data to the temporary file
-    for (size_t i = 0; i < x.size(); ++i) {
-        if (!(file << x[i] << " " << y[i] << " " << dy[i] << '\n')) {
-            std::cerr << "Error: Failed to write data to the temporary file: " << filename << '\n';
-            file.close();
-            return *this;
-        }
+    // Cache the panels, so that they can be updated with update_panel.
+    multiplot.active   = false;
+    multiplot.panel    = -1;
+    multiplot.prologue = layout.get_prologue();
+    multiplot.epilogue = layout.get_epilogue();
+    multiplot.panels.clear();
+    for (std::size_t i = 0; i < layout.size(); ++i) {
+        panel_commands_t panel = {layout.get_panel_placement(i), layout.get_panel_commands(i), false, {}, {}};
+        panel.files            = layout.get_panel_filenames(i);
+        multiplot.panels.push_back(panel);
     }
 
-    // Flush the file buffer and close the file
-    file.flush();
-    if (file.fail()) {
-        std::cerr << "Error: Failed to flush data to the temporary file: " << filename << '\n';
-        file.close();
+    // The panels must not be replotted by the next plot.
+    return this->reset_plot();
+}
+
+GPCPP_INLINE auto Gnuplot::plot_file(
+    const std::string &filename,
+    const std::string &using_spec,
+    const std::string &format,
+    const std::string &title,
+    std::uint64_t checksum) -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
         return *this;
     }
-    file.close();
 
     // Check if the file is available for reading
-    if (!gpcpp::Gnuplot::file_ready(filename)) {
+    if (!Gnuplot::file_exists(filename, 4)) {
         std::cerr << "Error: File " << filename << " is not available for reading.\n";
         return *this;
     }
 
-    std::ostringstream oss;
+    // Verify the content of the file, if requested.
+    if ((checksum != 0) && (Gnuplot::file_checksum(filename) != checksum)) {
+        std::cerr << "Error: Checksum mismatch for file " << filename << ".\n";
+        return *this;
+    }
 
+    std::ostringstream oss;
     // Determine whether to use 'plot' or 'replot' based on the current plot state
     oss << ((nplots > 0 && two_dim) ? "replot " : "plot ");
-
-    // Specify the file and columns for the Gnuplot command
-    oss << "\"" << filename << "\" using 1:2:3 with " << errorbars_to_string(style) << " ";
-
-    // Add a title or specify 'notitle' if no title is provided
-    oss << (title.empty() ? " notitle " : " title \"" + title + "\" ");
-
-    // Include line color if it is specified.
-    if (line_color.is_set()) {
-        oss << " lc rgbcolor \"" << line_color.to_string() << "\"";
-    }
-
-    // Add line width if specified.
-    if (line_width > 0) {
-        oss << " lw " << line_width;
+    // Reference the file in place, with the requested columns.
+    oss << "\"" << filename << "\" using " << using_spec;
+    // Add the format used to read the lines, if provided.
+    if (!format.empty()) {
+        oss << " \"" << format << "\"";
     }
-    // Add line style if specified.
-    if (!line_type.empty()) {
-        oss << " " << line_type;
-    }
-
-    // Add point style if specified.
-    oss << " pt " << point_type_to_string(point_type);
-    // Add point size if specified.
-    if (point_size > 0) {
-        oss << " ps " << point_size;
-    }
-
-    // Send the constructed command to Gnuplot for execution
-    this->send_cmd(oss.str());
-
-    return *this;
-}
-
-template <typename X, typename Y, typename Z>
-auto Gnuplot::plot_xyz(const X &x, const Y &y, const Z &z, const std::string &title) -> Gnuplot &
-{
-    // Check if the Gnuplot session is ready
-    if (!this->is_ready()) {
-        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
-        return *this;
-    }
-
-    // Validate input vectors
-    if (x.empty() || y.empty() || z.empty()) {
-        std::cerr << "Error: Input vectors are empty. Cannot plot.\n";
-        return *this;
-    }
-
-    if (x.size() != y.size() || x.size() != z.size()) {
-        std::cerr << "Error: Mismatch between the lengths of x, y, and z vectors.\n";
-        return *this;
-    }
-
-    // Create a temporary file for storing the data
-    std::ofstream file;
-    std::string filename = this->create_tmpfile(file);
-    if (filename.empty()) {
-        std::cerr << "Error: Failed to create a temporary file.\n";
-        return *this;
-    }
-
-    // Write the data to the temporary file
-    for (size_t i = 0; i < x.size(); ++i) {
-        if (!(file << x[i] << " " << y[i] << " " << z[i] << '\n')) {
-            std::cerr << "Error: Failed to write data to the temporary file: " << filename << '\n';
-            file.close();
-            return *this;
-        }
-    }
-
-    // Flush the file buffer and close the file
-    file.flush();
-    if (file.fail()) {
-        std::cerr << "Error: Failed to flush data to the temporary file: " << filename << '\n';
-        file.close();
-        return *this;
-    }
-    file.close();
-
-    // Check if the file is available for reading
-    if (!gpcpp::Gnuplot::file_ready(filename)) {
-        std::cerr << "Error: File " << filename << " is not available for reading.\n";
-        return *this;
-    }
-
-    std::ostringstream oss;
-
-    // Determine whether to use 'splot' or 'replot' based on the current plot state
-    oss << ((nplots > 0 && !two_dim) ? "replot" : "splot");
-
-    // Specify the file and columns for the Gnuplot command
-    oss << " \"" << filename << "\" using 1:2:3";
-
     // Add a title or specify 'notitle' if no title is provided
     oss << (title.empty() ? " notitle" : " title \"" + title + "\"");
-
     // Specify the plot style or smoothing option.
     if (smooth_type == smooth_type_t::none) {
         oss << " with " << plot_type_to_string(plot_type);
     } else {
         oss << " smooth " << smooth_type_to_string(smooth_type);
     }
-
     // Include line color if it is specified.
     if (line_color.is_set()) {
         oss << " lc rgbcolor \"" << line_color.to_string() << "\"";
     }
-
     // Add line style options only if the plot style supports lines.
     if (is_line_type(plot_type)) {
         // Add line width if specified.
@@ -881,7 +853,6 @@ auto Gnuplot::plot_xyz(const X &x, const Y &y, const Z &z, const std::string &ti
             oss << " " << line_type;
         }
     }
-
     // Add point style and size only if the plot style supports points.
     if (is_point_type(plot_type)) {
         // Add point style if specified.
@@ -891,15 +862,18 @@ auto Gnuplot::plot_xyz(const X &x, const Y &y, const Z &z, const std::string &ti
             oss << " ps " << point_size;
         }
     }
-
     // Send the constructed command to Gnuplot for execution
     this->send_cmd(oss.str());
 
     return *this;
 }
 
-template <typename X, typename Y, typename Z>
-auto Gnuplot::plot_3d_grid(const X &x, const Y &y, const Z &z, const std::string &title) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::plot_binary_file(
+    const std::string &filename,
+    const binary_layout_t &layout,
+    const std::string &using_spec,
+    const std::string &title,
+    std::uint64_t checksum) -> Gnuplot &
 {
     // Check if the Gnuplot session is ready
     if (!this->is_ready()) {
@@ -907,74 +881,52 @@ auto Gnuplot::plot_3d_grid(const X &x, const Y &y, const Z &z, const std::string
         return *this;
     }
 
-    // Validate input dimensions
-    if (x.empty() || y.empty() || z.empty()) {
-        std::cerr << "Error: Input vectors must not be empty.\n";
-        return *this;
-    }
-    if (z.size() != x.size() || z[0].size() != y.size()) {
-        std::cerr << "Error: Dimensions of z must match sizes of x and y.\n";
+    // Validate the layout.
+    if (layout.fields.empty()) {
+        std::cerr << "Error: The binary layout has no fields. Cannot plot.\n";
         return *this;
     }
 
-    // Create a temporary file for storing the grid data
-    std::ofstream file;
-    std::string filename = this->create_tmpfile(file);
-    if (filename.empty()) {
-        std::cerr << "Error: Failed to create a temporary file.\n";
+    // Check if the file is available for reading
+    if (!Gnuplot::file_exists(filename, 4)) {
+        std::cerr << "Error: File " << filename << " is not available for reading.\n";
         return *this;
     }
 
-    // Write the grid data to the temporary file
-    for (size_t i = 0; i < x.size(); ++i) {
-        for (size_t j = 0; j < y.size(); ++j) {
-            if (!(file << x[i] << " " << y[j] << " " << z[i][j] << '\n')) {
-                std::cerr << "Error: Failed to write data to the temporary file: " << filename << '\n';
-                file.close();
-                return *this;
-            }
-        }
-        file << "\n"; // Separate rows for Gnuplot
+    // Derive the number of records from the size of the file, if not provided.
+    std::size_t records = layout.records;
+    if (records == 0) {
+        const std::size_t size = Gnuplot::file_size(filename);
+        records                = (size > layout.skip) ? (size - layout.skip) / layout.record_size() : 0;
     }
-
-    // Flush and close the file
-    file.flush();
-    if (file.fail()) {
-        std::cerr << "Error: Failed to flush data to the temporary file: " << filename << '\n';
-        file.close();
+    if (records == 0) {
+        std::cerr << "Error: File " << filename << " contains no records. Cannot plot.\n";
         return *this;
     }
-    file.close();
 
-    // Check if the file is available for reading
-    if (!gpcpp::Gnuplot::file_ready(filename)) {
-        std::cerr << "Error: File " << filename << " is not available for reading.\n";
+    // Verify the content of the file, if requested.
+    if ((checksum != 0) && (Gnuplot::file_checksum(filename) != checksum)) {
+        std::cerr << "Error: Checksum mismatch for file " << filename << ".\n";
         return *this;
     }
 
     std::ostringstream oss;
-
-    // Determine whether to use 'splot' or 'replot' based on the current plot state
-    oss << ((nplots > 0 && !two_dim) ? "replot" : "splot");
-
-    // Specify the file and columns for the Gnuplot command
-    oss << " \"" << filename << "\" using 1:2:3";
-
+    // Determine whether to use 'plot' or 'replot' based on the current plot state
+    oss << ((nplots > 0 && two_dim) ? "replot " : "plot ");
+    // Reference the file in place, along with its layout and the requested columns.
+    oss << "\"" << filename << "\" " << layout.get_declaration(records) << " using " << using_spec;
     // Add a title or specify 'notitle' if no title is provided
     oss << (title.empty() ? " notitle" : " title \"" + title + "\"");
-
     // Specify the plot style or smoothing option.
     if (smooth_type == smooth_type_t::none) {
         oss << " with " << plot_type_to_string(plot_type);
     } else {
         oss << " smooth " << smooth_type_to_string(smooth_type);
     }
-
     // Include line color if it is specified.
     if (line_color.is_set()) {
         oss << " lc rgbcolor \"" << line_color.to_string() << "\"";
     }
-
     // Add line style options only if the plot style supports lines.
     if (is_line_type(plot_type)) {
         // Add line width if specified.
@@ -986,7 +938,6 @@ auto Gnuplot::plot_3d_grid(const X &x, const Y &y, const Z &z, const std::string
             oss << " " << line_type;
         }
     }
-
     // Add point style and size only if the plot style supports points.
     if (is_point_type(plot_type)) {
         // Add point style if specified.
@@ -996,13 +947,48 @@ auto Gnuplot::plot_3d_grid(const X &x, const Y &y, const Z &z, const std::string
             oss << " ps " << point_size;
         }
     }
-
     // Send the constructed command to Gnuplot for execution
     this->send_cmd(oss.str());
+
     return *this;
 }
 
-auto Gnuplot::plot_slope(const double a, const double b, const std::string &title) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::plot_mapped(
+    const mapped_array_t &array,
+    const std::string &using_spec,
+    const std::string &title) -> Gnuplot &
+{
+    // Check if an array is mapped.
+    if (!array.is_open()) {
+        std::cerr << "Error: No array is mapped. Cannot plot.\n";
+        return *this;
+    }
+    // Let gnuplot read the file directly, skipping its header.
+    return this->plot_binary_file(array.filename(), array.layout(), using_spec, title);
+}
+
+GPCPP_INLINE auto Gnuplot::file_checksum(const std::string &filename) -> std::uint64_t
+{
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open file \"" << filename << "\" to compute its checksum.\n";
+        return 0;
+    }
+    // Hash the file in chunks, using 64-bit FNV-1a.
+    std::uint64_t hash = 14695981039346656037ULL;
+    std::vector<char> buffer(1U << 20U);
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const auto count = static_cast<std::size_t>(file.gcount());
+        for (std::size_t i = 0; i < count; ++i) {
+            hash ^= static_cast<unsigned char>(buffer[i]);
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+GPCPP_INLINE auto Gnuplot::plot_slope(const double a, const double b, const std::string &title) -> Gnuplot &
 {
     std::ostringstream oss;
 
@@ -1059,7 +1045,7 @@ auto Gnuplot::plot_slope(const double a, const double b, const std::string &titl
     return *this;
 }
 
-auto Gnuplot::plot_equation(const std::string &equation, const std::string &title) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::plot_equation(const std::string &equation, const std::string &title) -> Gnuplot &
 {
     std::ostringstream oss;
 
@@ -1111,7 +1097,7 @@ auto Gnuplot::plot_equation(const std::string &equation, const std::string &titl
     return *this;
 }
 
-auto Gnuplot::plot_equation3d(const std::string &equation, const std::string &title) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::plot_equation3d(const std::string &equation, const std::string &title) -> Gnuplot &
 {
     std::ostringstream oss;
 
@@ -1167,12 +1153,17 @@ auto Gnuplot::plot_equation3d(const std::string &equation, const std::string &ti
     return *this;
 }
 
-auto Gnuplot::plot_image(
+GPCPP_INLINE auto Gnuplot::plot_image(
     const unsigned char *ucPicBuf,
     const unsigned int iWidth,
     const unsigned int iHeight,
     const std::string &title) -> Gnuplot &
 {
+    const std::size_t count = static_cast<std::size_t>(iWidth) * iHeight;
+    if (!this->report_upload(0, count)) {
+        return *this;
+    }
+
     // Create a temporary file to store image data
     std::ofstream file;
     std::string filename = create_tmpfile(file);
@@ -1192,6 +1183,12 @@ auto Gnuplot::plot_image(
                 break;
             }
         }
+        // Stop at the end of a row if the upload has been cancelled, leaving nothing behind.
+        if (!this->report_upload(static_cast<std::size_t>(iRow + 1) * iWidth, count)) {
+            file.close();
+            this->discard_tmpfile(filename);
+            return *this;
+        }
     }
 
     // Ensure all data is written to the file and the file is closed properly
@@ -1220,9 +1217,9 @@ auto Gnuplot::plot_image(
     return *this;
 }
 
-auto Gnuplot::set_gnuplot_path(const std::string &path) -> bool
+GPCPP_INLINE auto Gnuplot::set_gnuplot_path(const std::string &path) -> bool
 {
-    std::string tmp = path + "/" + Gnuplot::m_gnuplot_filename;
+    std::string tmp = path + "/" + Gnuplot::m_gnuplot_filename();
 
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__TOS_WIN__)
     if (Gnuplot::file_exists(tmp, 0)) // check existence
@@ -1230,14 +1227,14 @@ auto Gnuplot::set_gnuplot_path(const std::string &path) -> bool
     if (Gnuplot::file_exists(tmp, 1)) // check existence and execution permission
 #endif
     {
-        Gnuplot::m_gnuplot_path = path;
+        Gnuplot::m_gnuplot_path() = path;
         return true;
     }
-    Gnuplot::m_gnuplot_path.clear();
+    Gnuplot::m_gnuplot_path().clear();
     return false;
 }
 
-auto Gnuplot::set_terminal(terminal_type_t type) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_terminal(terminal_type_t type) -> Gnuplot &
 {
     // For Unix-like systems, ensure the DISPLAY variable is set when using X11.
 #if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
@@ -1279,7 +1276,7 @@ static inline void tokenize(Container &container, const std::string &in, const s
     }
 }
 
-auto Gnuplot::replot() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::replot() -> Gnuplot &
 {
     if (nplots > 0) {
         this->send_cmd("replot");
@@ -1287,65 +1284,932 @@ auto Gnuplot::replot() -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::is_ready() const -> bool { return valid && (gnuplot_pipe != nullptr); }
+GPCPP_INLINE auto Gnuplot::flush() -> Gnuplot &
+{
+    if (this->is_ready()) {
+        this->flush_pipe();
+    }
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::sync() -> bool
+{
+    if (frames.active) {
+        std::cerr << "Error: Cannot wait for the frames while a frame is being built.\n";
+        return false;
+    }
+    this->flush();
+    return (frames.count == 0) || this->wait_frame(frames.count);
+}
+
+GPCPP_INLINE auto Gnuplot::set_frame_depth(std::size_t depth) -> Gnuplot &
+{
+    if ((depth == 0) || (depth > 3)) {
+        throw std::invalid_argument("The frame depth must be between 1 and 3.");
+    }
+    if (frames.active) {
+        std::cerr << "Error: Cannot change the frame depth while a frame is being built.\n";
+        return *this;
+    }
+    // The slots change, so the files of the old ones cannot be recycled safely.
+    if (frames.count > 0) {
+        this->wait_frame(frames.count);
+    }
+    frames.depth = depth;
+    frames.files.clear();
+    frames.owners.clear();
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::begin_frame() -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot begin the frame.\n";
+        return *this;
+    }
+    if (frames.active) {
+        std::cerr << "Error: A frame is already being built.\n";
+        return *this;
+    }
+
+    // Without the acknowledgements, the files are never recycled.
+    if (frames.fd < 0) {
+        this->open_frame_channel();
+    }
+
+    ++frames.count;
+    frames.files.resize(frames.depth);
+    frames.owners.resize(frames.depth, 0);
+    frames.slot = (frames.count - 1) % frames.depth;
+
+    // When frames can be dropped, take a slot that is free or whose frame has not been sent yet,
+    // instead of waiting for gnuplot.
+    if ((outbound.policy == overload_policy_t::drop_oldest) || (outbound.policy == overload_policy_t::coalesce)) {
+        bool found = false;
+        for (std::size_t i = 0; (i < frames.depth) && !found; ++i) {
+            const std::size_t owner = frames.owners[i];
+            if ((owner <= frames.acknowledged) || (frames.dropped.erase(owner) > 0)) {
+                frames.owners[i] = 0;
+                frames.slot      = i;
+                found            = true;
+            }
+        }
+        for (std::size_t i = 0; (i < frames.depth) && !found; ++i) {
+            if (this->drop_outbound_frames(1, frames.owners[i]) > 0) {
+                ++((outbound.policy == overload_policy_t::coalesce) ? outbound.metrics.frames_coalesced
+                                                                    : outbound.metrics.frames_dropped);
+                frames.dropped.erase(frames.owners[i]);
+                frames.owners[i] = 0;
+                frames.slot      = i;
+                found            = true;
+            }
+        }
+    }
+
+    // Wait for gnuplot to consume the frame that last used this slot.
+    const std::size_t owner = frames.owners[frames.slot];
+    if ((owner > 0) && !this->wait_frame(owner)) {
+        // The old files might still be read, so the slot gets new ones.
+        frames.files[frames.slot].clear();
+    }
+    frames.owners[frames.slot] = frames.count;
+
+    frames.active    = true;
+    frames.next_file = 0;
+    budget.started   = std::chrono::steady_clock::now();
+    this->apply_detail();
+    return this->reset_plot();
+}
+
+GPCPP_INLINE auto Gnuplot::end_frame() -> Gnuplot &
+{
+    if (!frames.active) {
+        std::cerr << "Error: No frame is being built.\n";
+        return *this;
+    }
+    frames.active = false;
+
+    // The frame has been built, its transfer starts.
+    const auto now             = std::chrono::steady_clock::now();
+    frame_timing_t &timing     = budget.timings[frames.count];
+    timing.serialize_ms        = std::chrono::duration<double, std::milli>(now - budget.started).count();
+    timing.scale               = budget.applied;
+    budget.marks[frames.count] = now;
+
+    // Ask gnuplot to acknowledge the frame once it has been drawn, with the time it was drawn at.
+    if (frames.fd >= 0) {
+        this->send_cmd("print sprintf(\"gpcpp-frame %d %.6f\", " + std::to_string(frames.count) + ", time(0.0))");
+    }
+    // Queue the frame as a whole, so that the overload policy can drop it, and send what fits.
+    this->seal_outbound(frames.count);
+    if (!this->is_alive() || !this->drain_outbound(0)) {
+        this->recover();
+    }
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::is_ready() const -> bool { return valid && (gnuplot_pipe != nullptr); }
+
+GPCPP_INLINE auto Gnuplot::set_auto_respawn(bool enable) -> Gnuplot &
+{
+    auto_respawn = enable;
+    // Without restarts, nothing is replayed.
+    if (!enable) {
+        state_journal.clear();
+        plot_journal.clear();
+    }
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::is_alive() -> bool
+{
+    if (!this->is_ready()) {
+        return false;
+    }
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+    // Collect the exit status, if gnuplot has terminated.
+    if (gnuplot_pid > 0) {
+        int status = 0;
+        if (waitpid(static_cast<pid_t>(gnuplot_pid), &status, WNOHANG) == static_cast<pid_t>(gnuplot_pid)) {
+            gnuplot_pid = -1;
+            return false;
+        }
+    }
+#endif
+    return true;
+}
+
+GPCPP_INLINE auto Gnuplot::spawn() -> bool
+{
+    const std::string program = Gnuplot::m_gnuplot_path() + "/" + Gnuplot::m_gnuplot_filename();
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__TOS_WIN__)
+    gnuplot_pipe = _popen(program.c_str(), "w");
+    return gnuplot_pipe != nullptr;
+#elif defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+    // Start gnuplot ourselves rather than with popen, to know its process ID.
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    // Determined before forking, the child may only make async-signal-safe calls.
+    const long max_fd = sysconf(_SC_OPEN_MAX);
+    const pid_t pid   = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        // Child: read the commands from the pipe.
+        dup2(fds[0], STDIN_FILENO);
+        // Gnuplot must not inherit our other descriptors (the frames FIFO, the memory files, the pipes
+        // of the other sessions): it opens the files by name, and a pipe it holds is never closed.
+        for (int fd = STDERR_FILENO + 1; fd < ((max_fd > 0) ? static_cast<int>(max_fd) : 1024); ++fd) {
+            close(fd);
+        }
+        execl(program.c_str(), program.c_str(), static_cast<char *>(nullptr));
+        _exit(127);
+    }
+    close(fds[0]);
+    // Do not leak the pipe into other child processes, and never block on a full pipe.
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+    gnuplot_pipe = fdopen(fds[1], "w");
+    if (gnuplot_pipe == nullptr) {
+        close(fds[1]);
+        waitpid(pid, nullptr, 0);
+        return false;
+    }
+    gnuplot_pid = static_cast<int>(pid);
+    return true;
+#else
+    std::cerr << "Error: Unsupported platform for opening a pipe to Gnuplot.\n";
+    return false;
+#endif
+}
 
-auto Gnuplot::reset_plot() -> Gnuplot &
+GPCPP_INLINE void Gnuplot::close_pipe()
+{
+    if (gnuplot_pipe == nullptr) {
+        return;
+    }
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__TOS_WIN__)
+    if (_pclose(gnuplot_pipe) == -1) {
+        std::cerr << "Warning: Problem closing communication to Gnuplot.\n";
+    }
+#elif defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+    {
+        // Send the queued commands, gnuplot might be gone already.
+        sigpipe_guard_t guard;
+        this->seal_outbound(0);
+        this->drain_outbound(outbound.timeout_ms);
+        if (fclose(gnuplot_pipe) != 0) {
+            std::cerr << "Warning: Problem closing communication to Gnuplot.\n";
+        }
+    }
+    // The commands still queued cannot be sent anymore.
+    outbound.buffer.clear();
+    outbound.chunks.clear();
+    outbound.offset               = 0;
+    outbound.metrics.queued_bytes = 0;
+    if (gnuplot_pid > 0) {
+        waitpid(static_cast<pid_t>(gnuplot_pid), nullptr, 0);
+        gnuplot_pid = -1;
+    }
+#else
+    std::cerr << "Error: Unsupported platform for closing Gnuplot pipe.\n";
+#endif
+    // Avoid dangling pointer.
+    gnuplot_pipe = nullptr;
+}
+
+GPCPP_INLINE auto Gnuplot::write_pipe(const std::string &data, bool flush) -> bool
+{
+    if (gnuplot_pipe == nullptr) {
+        return false;
+    }
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+    // Like stdio, write in large chunks unless a flush is requested.
+    outbound.buffer += data;
+    if (flush || (outbound.buffer.size() >= 65536)) {
+        this->seal_outbound(0);
+    }
+    return this->drain_outbound(flush ? outbound.timeout_ms : 0);
+#else
+    bool written = data.empty() || (fputs(data.c_str(), gnuplot_pipe) >= 0);
+    if (written && flush) {
+        written = (fflush(gnuplot_pipe) == 0);
+    }
+    return written;
+#endif
+}
+
+GPCPP_INLINE auto Gnuplot::flush_pipe() -> bool
+{
+    if (this->is_alive() && this->write_pipe("", true)) {
+        return true;
+    }
+    return this->recover();
+}
+
+GPCPP_INLINE auto Gnuplot::seal_outbound(std::size_t frame) -> bool
+{
+    if (outbound.buffer.empty()) {
+        return true;
+    }
+    outbound_chunk_t chunk;
+    chunk.data.swap(outbound.buffer);
+    chunk.frame = frame;
+
+    // A newer frame supersedes the ones still waiting.
+    if ((outbound.policy == overload_policy_t::coalesce) && (frame > 0)) {
+        outbound.metrics.frames_coalesced += this->drop_outbound_frames(outbound.chunks.size());
+    }
+
+    // Make room for the chunk, according to the policy.
+    pipe_metrics_t &metrics = outbound.metrics;
+    if ((metrics.queued_bytes + chunk.data.size()) > outbound.max_bytes) {
+        this->drain_outbound(0);
+        if (outbound.policy == overload_policy_t::drop_oldest) {
+            while (((metrics.queued_bytes + chunk.data.size()) > outbound.max_bytes) &&
+                   (this->drop_outbound_frames(1) > 0)) {
+                ++metrics.frames_dropped;
+            }
+        }
+        if (((metrics.queued_bytes + chunk.data.size()) > outbound.max_bytes) &&
+            (outbound.policy != overload_policy_t::fail_fast)) {
+            // Wait for gnuplot to read, but not forever.
+            this->drain_outbound(outbound.timeout_ms);
+            if ((metrics.queued_bytes + chunk.data.size()) > outbound.max_bytes) {
+                ++metrics.timeouts;
+            }
+        }
+        if ((metrics.queued_bytes + chunk.data.size()) > outbound.max_bytes) {
+            ++metrics.rejected;
+            if (frame > 0) {
+                frames.dropped.insert(frame);
+            } else {
+                std::cerr << "Warning: Gnuplot is not keeping up, " << chunk.data.size()
+                          << " bytes of commands were rejected.\n";
+            }
+            return false;
+        }
+    }
+
+    metrics.queued_bytes += chunk.data.size();
+    metrics.peak_queued_bytes = (std::max)(metrics.peak_queued_bytes, metrics.queued_bytes);
+    outbound.chunks.push_back(std::move(chunk));
+    return true;
+}
+
+GPCPP_INLINE auto Gnuplot::drain_outbound(unsigned timeout_ms) -> bool
+{
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+    if (gnuplot_pipe == nullptr) {
+        return false;
+    }
+    sigpipe_guard_t guard;
+    const int fd        = fileno(gnuplot_pipe);
+    const auto start    = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::milliseconds(timeout_ms);
+    pipe_metrics_t &metrics = outbound.metrics;
+
+    while (!outbound.chunks.empty()) {
+        const outbound_chunk_t &chunk = outbound.chunks.front();
+        // Limit the frames inside gnuplot, so that the newer ones can still be dropped, and a slot
+        // stays free when they are.
+        const std::size_t in_flight =
+            ((outbound.policy == overload_policy_t::drop_oldest) || (outbound.policy == overload_policy_t::coalesce))
+                ? (std::max)(frames.depth - 1, std::size_t{1})
+                : frames.depth;
+        if ((chunk.frame > 0) && (frames.sent.size() >= in_flight) && (outbound.offset == 0) && (frames.fd >= 0)) {
+            // Collect the acknowledgements already received, then wait for more until the deadline.
+            const auto now          = std::chrono::steady_clock::now();
+            const std::size_t ahead = frames.sent.size();
+            const auto left         = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+            const int remaining     = (now < deadline) ? static_cast<int>(left) + 1 : 0;
+            this->read_frame_acks(remaining);
+            metrics.blocked_ms +=
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - now).count();
+            if ((remaining == 0) && (frames.sent.size() == ahead)) {
+                break;
+            }
+            continue;
+        }
+        const std::string &data = chunk.data;
+        const ssize_t n         = write(fd, data.data() + outbound.offset, data.size() - outbound.offset);
+        if (n > 0) {
+            outbound.offset += static_cast<std::size_t>(n);
+            metrics.queued_bytes -= static_cast<std::size_t>(n);
+            metrics.bytes_written += static_cast<std::size_t>(n);
+            if (outbound.offset == data.size()) {
+                if ((chunk.frame > 0) && (frames.fd >= 0)) {
+                    frames.sent.push_back(chunk.frame);
+                }
+                if (chunk.frame > 0) {
+                    this->frame_transferred(chunk.frame);
+                }
+                outbound.chunks.pop_front();
+                outbound.offset = 0;
+                ++metrics.chunks_written;
+            }
+        } else if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+            // The pipe is full, wait for gnuplot to read.
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                break;
+            }
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+            pollfd pfd{};
+            pfd.fd     = fd;
+            pfd.events = POLLOUT;
+            poll(&pfd, 1, static_cast<int>(left) + 1);
+            metrics.blocked_ms +=
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - now).count();
+        } else if ((n < 0) && (errno != EINTR)) {
+            // gnuplot terminated, or the pipe is broken.
+            return false;
+        }
+    }
+    return true;
+#else
+    (void)timeout_ms;
+    return true;
+#endif
+}
+
+GPCPP_INLINE auto Gnuplot::drop_outbound_frames(std::size_t limit, std::size_t frame) -> std::size_t
+{
+    std::size_t dropped = 0;
+    // The first chunk cannot be dropped once gnuplot has started reading it.
+    std::deque<outbound_chunk_t>::iterator it = outbound.chunks.begin();
+    if ((it != outbound.chunks.end()) && (outbound.offset > 0)) {
+        ++it;
+    }
+    while ((it != outbound.chunks.end()) && (dropped < limit)) {
+        if ((it->frame > 0) && ((frame == 0) || (it->frame == frame))) {
+            outbound.metrics.queued_bytes -= it->data.size();
+            frames.dropped.insert(it->frame);
+            it = outbound.chunks.erase(it);
+            ++dropped;
+        } else {
+            ++it;
+        }
+    }
+    return dropped;
+}
+
+GPCPP_INLINE auto Gnuplot::set_overload_policy(overload_policy_t policy, std::size_t max_bytes, unsigned timeout_ms)
+    -> Gnuplot &
+{
+    outbound.policy     = policy;
+    outbound.max_bytes  = max_bytes;
+    outbound.timeout_ms = timeout_ms;
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::get_pipe_metrics() const -> pipe_metrics_t { return outbound.metrics; }
+
+GPCPP_INLINE auto Gnuplot::set_storage_budget(std::size_t max_bytes, storage_policy_t policy) -> Gnuplot &
+{
+    storage.max_bytes = max_bytes;
+    storage.policy    = policy;
+    // Release the files beyond the new budget right away.
+    this->evict_storage(0);
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::get_storage_metrics() const -> storage_metrics_t { return storage.metrics; }
+
+GPCPP_INLINE auto Gnuplot::set_frame_budget(double budget_ms) -> Gnuplot &
+{
+    if (!(budget_ms >= 0) || std::isinf(budget_ms)) {
+        throw std::invalid_argument("The frame budget must be a non-negative number of milliseconds.");
+    }
+    budget.controller = lod_controller_t(budget_ms);
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::get_frame_timing() const -> frame_timing_t { return budget.controller.get_average(); }
+
+GPCPP_INLINE auto Gnuplot::get_detail_scale() const -> double { return budget.controller.get_scale(); }
+
+GPCPP_INLINE auto Gnuplot::get_capabilities() const -> const capabilities_t & { return capabilities; }
+
+GPCPP_INLINE auto Gnuplot::get_transport() const -> transport_t { return transport; }
+
+GPCPP_INLINE auto Gnuplot::set_transport(transport_t _transport) -> Gnuplot &
+{
+    if (!capabilities.supports(_transport)) {
+        std::cerr << "Error: The transport " << transport_to_string(_transport) << " is not supported by gnuplot.\n";
+        return *this;
+    }
+    transport = _transport;
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::get_nonfinite_policy() const -> nonfinite_policy_t { return nonfinite; }
+
+GPCPP_INLINE auto Gnuplot::set_nonfinite_policy(nonfinite_policy_t policy) -> Gnuplot &
+{
+    nonfinite = policy;
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::set_upload_progress(upload_progress_t progress) -> Gnuplot &
+{
+    uploads.progress = std::move(progress);
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::get_cancel_token() const -> cancel_token_t { return uploads.cancel; }
+
+GPCPP_INLINE auto Gnuplot::set_cancel_token(cancel_token_t token) -> Gnuplot &
+{
+    uploads.cancel = std::move(token);
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::set_spatial_index(bool enable) -> Gnuplot &
+{
+    spatial.enabled = enable;
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::nearest(std::size_t series, double x, double y, double x_scale, double y_scale) -> nearest_t
+{
+    if (series >= spatial.series.size()) {
+        std::cerr << "Error: Invalid series " << series << ". Cannot find the nearest sample.\n";
+        return nearest_t();
+    }
+    if (!(x_scale > 0) || !(y_scale > 0)) {
+        std::cerr << "Error: The scales of the axes must be positive.\n";
+        return nearest_t();
+    }
+    try {
+        // Waits for the index, if it is still being built.
+        const std::shared_ptr<const kd_tree_t> &tree = spatial.series[series].get();
+        return tree->nearest(x, y, x_scale, y_scale);
+    } catch (const std::exception &e) {
+        std::cerr << "Error: Failed to build the index of series " << series << ": " << e.what() << "\n";
+        return nearest_t();
+    }
+}
+
+GPCPP_INLINE auto Gnuplot::is_index_ready(std::size_t series) const -> bool
+{
+    return (series < spatial.series.size()) &&
+           (spatial.series[series].wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+}
+
+GPCPP_INLINE auto Gnuplot::load_capabilities(const std::string &program) -> capabilities_t
+{
+    // The sessions of a process share the capabilities.
+    static std::mutex mutex;
+    static std::map<std::string, capabilities_t> loaded;
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::map<std::string, capabilities_t>::const_iterator it = loaded.find(program);
+    if (it != loaded.end()) {
+        return it->second;
+    }
+
+    capabilities_t result;
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+    // The cache stays valid as long as the executable is not replaced.
+    struct stat info {};
+    if (stat(program.c_str(), &info) != 0) {
+        return result;
+    }
+    const std::string stamp = "gpcpp-capabilities 1\nprogram=" + program + "\nmtime=" + std::to_string(info.st_mtime) +
+                              "\nsize=" + std::to_string(info.st_size) + "\n";
+
+    // One cache file per executable, named after the hash of its path.
+    std::string directory;
+    const char *cache_home = getenv("XDG_CACHE_HOME");
+    const char *home       = getenv("HOME");
+    if ((cache_home != nullptr) && (cache_home[0] != '\0')) {
+        directory = cache_home;
+    } else if ((home != nullptr) && (home[0] != '\0')) {
+        directory = std::string(home) + "/.cache";
+    }
+    std::string cache;
+    if (!directory.empty()) {
+        std::uint64_t hash = 14695981039346656037ULL;
+        for (const char c : program) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        }
+        std::ostringstream oss;
+        oss << directory << "/gpcpp/capabilities-" << std::hex << hash;
+        cache = oss.str();
+    }
+
+    // Read the cache, if there is one.
+    std::string content;
+    if (!cache.empty()) {
+        std::ifstream in(cache);
+        if (in.is_open()) {
+            std::ostringstream buffer;
+            buffer << in.rdbuf();
+            content = buffer.str();
+        }
+    }
+    // Use it if it describes this executable.
+    if (content.compare(0, stamp.size(), stamp) == 0) {
+        std::istringstream lines(content.substr(stamp.size()));
+        std::string line;
+        while (std::getline(lines, line)) {
+            result.parse_line(line);
+        }
+        result.probed = true;
+    } else {
+        result = Gnuplot::probe_capabilities(program);
+        // Only a complete probe is worth keeping.
+        if (result.probed && !cache.empty()) {
+            mkdir(directory.c_str(), 0700);
+            mkdir((directory + "/gpcpp").c_str(), 0700);
+            // Write a new file and rename it, so that concurrent sessions never read a partial cache.
+            const std::string partial = cache + "." + std::to_string(getpid());
+            std::ofstream out(partial);
+            out << stamp << result.serialize();
+            out.close();
+            if (out.fail() || (std::rename(partial.c_str(), cache.c_str()) != 0)) {
+                std::remove(partial.c_str());
+            }
+        }
+    }
+#endif
+    loaded[program] = result;
+    return result;
+}
+
+GPCPP_INLINE auto Gnuplot::probe_capabilities(const std::string &program) -> capabilities_t
+{
+    capabilities_t result;
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+    // The data read by the probe: two records in a binary file, and two in a memory file.
+    std::string binary_file = "/tmp/gnuplotpXXXXXX";
+    const int binary_fd     = mkstemp(&binary_file[0]);
+    if (binary_fd == -1) {
+        return result;
+    }
+    const double values[] = {1.0, 2.0, 3.0, 4.0};
+    const bool written    = (write(binary_fd, values, sizeof(values)) == static_cast<ssize_t>(sizeof(values)));
+    close(binary_fd);
+    std::string memory_file;
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+    const int memory_fd = memfd_create("gpcpp-probe", MFD_CLOEXEC);
+    if (memory_fd != -1) {
+        const char text[] = "1 2\n3 6\n";
+        if (write(memory_fd, text, sizeof(text) - 1) == static_cast<ssize_t>(sizeof(text) - 1)) {
+            memory_file = "/proc/" + std::to_string(getpid()) + "/fd/" + std::to_string(memory_fd);
+        }
+    }
+#endif
+
+    // Each feature is checked by reading a different maximum, failed commands print nothing.
+    std::ostringstream script;
+    script << "set terminal unknown\n";
+    script << "print \"gpcpp-probe version \" . sprintf(\"%.1f\", GPVAL_VERSION) . \".\" . GPVAL_PATCHLEVEL\n";
+    script << "print \"gpcpp-probe terminals \" . GPVAL_TERMINALS\n";
+    if (written) {
+        script << "plot \"" << binary_file << "\" binary record=2 format=\"%double%double\" using 1:2\n";
+        script << "print sprintf(\"gpcpp-probe binary %g\", GPVAL_DATA_Y_MAX)\n";
+    }
+    script << "$gpcpp_probe << EOD\n1 2\n3 5\nEOD\n";
+    script << "plot $gpcpp_probe using 1:2\n";
+    script << "print sprintf(\"gpcpp-probe datablock %g\", GPVAL_DATA_Y_MAX)\n";
+    script << "reset errors\nset multiplot\nplot 1\nunset multiplot\nremultiplot\n";
+    script << "print sprintf(\"gpcpp-probe remultiplot %d\", GPVAL_ERRNO == 0)\n";
+    if (!memory_file.empty()) {
+        script << "plot \"" << memory_file << "\" using 1:2\n";
+        script << "print sprintf(\"gpcpp-probe memfd %g\", GPVAL_DATA_Y_MAX)\n";
+    }
+    script << "print \"gpcpp-probe done 1\"\nexit\n";
+
+    // Run gnuplot on the script, reading everything it prints.
+    std::string output;
+    int input[2];
+    int printed[2];
+    if ((pipe(input) == 0) && (pipe(printed) == 0)) {
+        const long max_fd = sysconf(_SC_OPEN_MAX);
+        const pid_t pid   = fork();
+        if (pid == 0) {
+            // Child: read the script, print (on stderr) to our pipe.
+            dup2(input[0], STDIN_FILENO);
+            dup2(printed[1], STDOUT_FILENO);
+            dup2(printed[1], STDERR_FILENO);
+            // Close everything else, including both ends of the pipes and the descriptors of the
+            // other sessions: a pipe held by the probe would never see its end of file.
+            for (int fd = STDERR_FILENO + 1; fd < ((max_fd > 0) ? static_cast<int>(max_fd) : 1024); ++fd) {
+                close(fd);
+            }
+            execl(program.c_str(), program.c_str(), static_cast<char *>(nullptr));
+            _exit(127);
+        }
+        close(input[0]);
+        close(printed[1]);
+        if (pid > 0) {
+            {
+                sigpipe_guard_t guard;
+                const std::string text = script.str();
+                (void)!write(input[1], text.data(), text.size());
+            }
+            close(input[1]);
+            // Do not wait forever for a gnuplot that hangs.
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            char buffer[4096];
+            for (;;) {
+                const auto remaining =
+                    std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now())
+                        .count();
+                pollfd pfd{};
+                pfd.fd     = printed[0];
+                pfd.events = POLLIN;
+                if ((remaining <= 0) || (poll(&pfd, 1, static_cast<int>(remaining)) <= 0)) {
+                    kill(pid, SIGKILL);
+                    break;
+                }
+                const ssize_t n = read(printed[0], buffer, sizeof(buffer));
+                if (n <= 0) {
+                    break;
+                }
+                output.append(buffer, static_cast<std::size_t>(n));
+            }
+            waitpid(pid, nullptr, 0);
+        } else {
+            close(input[1]);
+        }
+        close(printed[0]);
+    }
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+    if (memory_fd != -1) {
+        close(memory_fd);
+    }
+#endif
+    std::remove(binary_file.c_str());
+
+    // Parse the answers.
+    std::istringstream lines(output);
+    std::string line;
+    result.binary    = false;
+    result.datablock = false;
+    while (std::getline(lines, line)) {
+        std::istringstream fields(line);
+        std::string tag;
+        std::string key;
+        fields >> tag >> key;
+        if (tag != "gpcpp-probe") {
+            continue;
+        }
+        std::string value;
+        std::getline(fields >> std::ws, value);
+        const double number = std::strtod(value.c_str(), nullptr);
+        if (key == "version") {
+            result.set_version(value);
+        } else if (key == "terminals") {
+            result.parse_line("terminals=" + value);
+        } else if (key == "binary") {
+            result.binary = (std::abs(number - 4.0) < 1e-9);
+        } else if (key == "datablock") {
+            result.datablock = (std::abs(number - 5.0) < 1e-9);
+        } else if (key == "remultiplot") {
+            result.remultiplot = (value == "1");
+        } else if (key == "memfd") {
+            result.memfd = (std::abs(number - 6.0) < 1e-9);
+        } else if (key == "done") {
+            result.probed = true;
+        }
+    }
+    // Without an answer, keep assuming what the library always did.
+    if (!result.probed) {
+        return capabilities_t();
+    }
+#else
+    (void)program;
+#endif
+    return result;
+}
+
+GPCPP_INLINE auto Gnuplot::journal_cmd(const std::string &cmdstr) -> bool
+{
+    // Commands that start a new figure replace the recorded plots.
+    if ((cmdstr.compare(0, 4, "plot") == 0) || (cmdstr.compare(0, 5, "splot") == 0) ||
+        (cmdstr.compare(0, 13, "set multiplot") == 0)) {
+        plot_journal.assign(1, cmdstr);
+        return true;
+    }
+    // Inside a multiplot, everything belongs to the figure.
+    if (multiplot.active || (cmdstr.compare(0, 6, "replot") == 0) || (cmdstr.compare(0, 15, "unset multiplot") == 0)) {
+        plot_journal.push_back(cmdstr);
+        return true;
+    }
+    if (cmdstr == "reset") {
+        state_journal.clear();
+        plot_journal.clear();
+        return true;
+    }
+
+    // Settings are identified by their name, e.g., "xrange" or "style line 3".
+    std::istringstream iss(cmdstr);
+    std::string verb, option, token;
+    iss >> verb >> option;
+    if ((verb != "set") && (verb != "unset")) {
+        return false;
+    }
+    option = option.substr(0, option.find_first_not_of("abcdefghijklmnopqrstuvwxyz0123456789_"));
+    std::string key = option;
+    bool untagged   = false;
+    if (option == "style") {
+        iss >> token;
+        key += " " + token;
+        // Numbered styles (e.g., "style line 3").
+        if (iss >> token && (token.find_first_not_of("0123456789") == std::string::npos)) {
+            key += " " + token;
+        }
+    } else if ((option == "label") || (option == "arrow") || (option == "object") || (option == "linetype")) {
+        if (iss >> token && (token.find_first_not_of("0123456789") == std::string::npos)) {
+            key += " " + token;
+        } else if (verb == "set") {
+            // Untagged elements accumulate, each one under its own definition (e.g., "label 'a' at 1,2"),
+            // so that repeating it replaces it, and unsetting the option removes them all.
+            key      = cmdstr.substr(cmdstr.find(option));
+            untagged = true;
+        }
+    }
+
+    // Drop the previous values of the setting, including the numbered ones it covers.
+    std::vector<std::pair<std::string, std::string>>::iterator it = state_journal.begin();
+    while (it != state_journal.end()) {
+        if ((it->first == key) || (it->first.compare(0, key.size() + 1, key + " ") == 0)) {
+            it = state_journal.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    state_journal.emplace_back(key, cmdstr);
+
+    // A dashboard may add an untagged element at every frame, only the most recent ones are kept.
+    const std::size_t max_elements = 256;
+    if (untagged) {
+        std::size_t elements = 0;
+        for (const std::pair<std::string, std::string> &entry : state_journal) {
+            elements += (entry.first.compare(0, option.size() + 1, option + " ") == 0) ? 1U : 0U;
+        }
+        for (it = state_journal.begin(); (elements > max_elements) && (it != state_journal.end());) {
+            if (it->first.compare(0, option.size() + 1, option + " ") == 0) {
+                it = state_journal.erase(it);
+                --elements;
+            } else {
+                ++it;
+            }
+        }
+    }
+    return true;
+}
+
+GPCPP_INLINE auto Gnuplot::recover() -> bool
+{
+    this->close_pipe();
+    if (!auto_respawn) {
+        std::cerr << "Error: Gnuplot terminated unexpectedly.\n";
+        valid = false;
+        return false;
+    }
+    std::cerr << "Warning: Gnuplot terminated unexpectedly, restarting it.\n";
+    if (!this->spawn()) {
+        std::cerr << "Error: Unable to restart Gnuplot.\n";
+        valid = false;
+        return false;
+    }
+
+    // Restore the settings first, then redraw the last figure from the files already in place.
+    bool restored = true;
+    for (const std::pair<std::string, std::string> &entry : state_journal) {
+        restored = restored && this->write_pipe(entry.second + "\n");
+    }
+    for (const std::string &cmd : plot_journal) {
+        restored = restored && this->write_pipe(cmd + "\n");
+    }
+    if (!restored || !this->write_pipe("", true)) {
+        std::cerr << "Error: Unable to restore the state of Gnuplot.\n";
+        this->close_pipe();
+        valid = false;
+        return false;
+    }
+
+    // The terminated gnuplot will not read the files of the pending frames anymore.
+    frames.acknowledged = frames.count;
+    frames.sent.clear();
+    return true;
+}
+
+GPCPP_INLINE auto Gnuplot::reset_plot() -> Gnuplot &
 {
     nplots = 0;
     return *this;
 }
 
-auto Gnuplot::reset_all() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::reset_all() -> Gnuplot &
 {
     nplots = 0;
     this->send_cmd("reset");
     this->send_cmd("clear");
+    // Keep the acknowledgements of the frames flowing.
+    if (frames.fd >= 0) {
+        this->send_cmd("set print \"" + frames.channel + "\"");
+    }
+    xtime       = false;
     plot_type   = plot_type_t::none;
     smooth_type = smooth_type_t::none;
     id_manager_textbox_style.clear();
     id_manager_line_style.clear();
+    label_box_style_ids.clear();
+    multiplot.active = false;
+    multiplot.panel  = -1;
+    multiplot.panels.clear();
     grid_major_style_id = -1;
     grid_minor_style_id = -1;
     return *this;
 }
 
-auto Gnuplot::set_plot_type(plot_type_t style) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_plot_type(plot_type_t style) -> Gnuplot &
 {
     plot_type = style;
     return *this;
 }
 
-auto Gnuplot::set_smooth_type(smooth_type_t style) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_smooth_type(smooth_type_t style) -> Gnuplot &
 {
     smooth_type = style;
     return *this;
 }
 
-auto Gnuplot::set_line_type(line_type_t style, const std::string &custom_pattern) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_line_type(line_type_t style, const std::string &custom_pattern) -> Gnuplot &
 {
     line_type = line_type_to_string(style, custom_pattern);
     return *this;
 }
 
-auto Gnuplot::set_line_color(const std::string &color) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_line_color(const std::string &color) -> Gnuplot &
 {
     line_color = gpcpp::Color(color);
     return *this;
 }
 
-auto Gnuplot::set_line_color(int r, int g, int b) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_line_color(int r, int g, int b) -> Gnuplot &
 {
     line_color = gpcpp::Color(r, g, b);
     return *this;
 }
 
-auto Gnuplot::set_point_type(point_type_t style) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_point_type(point_type_t style) -> Gnuplot &
 {
     point_type = style;
     return *this;
 }
 
-auto Gnuplot::set_point_size(double size) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_point_size(double size) -> Gnuplot &
 {
     if (size > 0) {
         point_size = size;
@@ -1353,12 +2217,12 @@ auto Gnuplot::set_point_size(double size) -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::show() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::show() -> Gnuplot &
 {
     this->send_cmd("set output");
     this->send_cmd("set terminal " + terminal_type_to_string(terminal_type));
 
-    fflush(gnuplot_pipe);
+    this->flush_pipe();
 
     // Wait for user input before closing.
     std::cout << "Press Enter to continue..." << '\n';
@@ -1367,7 +2231,7 @@ auto Gnuplot::show() -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::set_output(const std::string &filename) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_output(const std::string &filename) -> Gnuplot &
 {
     // Set the output file where the plot will be saved
     this->send_cmd("set output \"" + filename + "\"");
@@ -1375,7 +2239,7 @@ auto Gnuplot::set_output(const std::string &filename) -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::set_legend(
+GPCPP_INLINE auto Gnuplot::set_legend(
     const std::string &position,
     const std::string &font,
     const std::string &title,
@@ -1426,26 +2290,26 @@ auto Gnuplot::set_legend(
     return *this;
 }
 
-auto Gnuplot::set_title(const std::string &title) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_title(const std::string &title) -> Gnuplot &
 {
     // Send the command to Gnuplot
     this->send_cmd("set title \"" + title + "\"");
     return *this;
 }
 
-auto Gnuplot::unset_title() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::unset_title() -> Gnuplot &
 {
     this->set_title();
     return *this;
 }
 
-auto Gnuplot::set_xlogscale(const double base) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_xlogscale(const double base) -> Gnuplot &
 {
     this->send_cmd("set logscale x " + std::to_string(base));
     return *this;
 }
 
-auto Gnuplot::set_ylogscale(const double base) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_ylogscale(const double base) -> Gnuplot &
 {
     std::ostringstream cmdstr;
 
@@ -1455,7 +2319,7 @@ auto Gnuplot::set_ylogscale(const double base) -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::set_zlogscale(const double base) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_zlogscale(const double base) -> Gnuplot &
 {
     std::ostringstream cmdstr;
 
@@ -1465,25 +2329,42 @@ auto Gnuplot::set_zlogscale(const double base) -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::unset_xlogscale() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_xtime(const std::string &format) -> Gnuplot &
+{
+    this->send_cmd("set xdata time");
+    this->send_cmd("set timefmt \"%s\"");
+    this->send_cmd("set format x \"" + format + "\"");
+    xtime = true;
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::unset_xtime() -> Gnuplot &
+{
+    this->send_cmd("set xdata");
+    this->send_cmd("set format x");
+    xtime = false;
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::unset_xlogscale() -> Gnuplot &
 {
     this->send_cmd("unset logscale x");
     return *this;
 }
 
-auto Gnuplot::unset_ylogscale() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::unset_ylogscale() -> Gnuplot &
 {
     this->send_cmd("unset logscale y");
     return *this;
 }
 
-auto Gnuplot::unset_zlogscale() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::unset_zlogscale() -> Gnuplot &
 {
     this->send_cmd("unset logscale z");
     return *this;
 }
 
-auto Gnuplot::set_line_width(double width) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_line_width(double width) -> Gnuplot &
 {
     if (width > 0) {
         line_width = width;
@@ -1492,14 +2373,14 @@ auto Gnuplot::set_line_width(double width) -> Gnuplot &
 }
 
 /// turns grid on/off
-auto Gnuplot::set_grid() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_grid() -> Gnuplot &
 {
     this->send_cmd("set grid");
     return *this;
 }
 
 /// @brief Sets the major tics for the x-axis.
-auto Gnuplot::set_xtics_major(double major_step) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_xtics_major(double major_step) -> Gnuplot &
 {
     if (major_step <= 0) {
         throw std::invalid_argument("Major step size for x-axis must be positive.");
@@ -1511,7 +2392,7 @@ auto Gnuplot::set_xtics_major(double major_step) -> Gnuplot &
 }
 
 /// @brief Sets the minor tics for the x-axis.
-auto Gnuplot::set_xtics_minor(int minor_intervals) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_xtics_minor(int minor_intervals) -> Gnuplot &
 {
     if (minor_intervals <= 0) {
         throw std::invalid_argument("Number of minor intervals for x-axis must be positive.");
@@ -1523,7 +2404,7 @@ auto Gnuplot::set_xtics_minor(int minor_intervals) -> Gnuplot &
 }
 
 /// @brief Sets the major tics for the y-axis.
-auto Gnuplot::set_ytics_major(double major_step) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_ytics_major(double major_step) -> Gnuplot &
 {
     if (major_step <= 0) {
         throw std::invalid_argument("Major step size for y-axis must be positive.");
@@ -1535,7 +2416,7 @@ auto Gnuplot::set_ytics_major(double major_step) -> Gnuplot &
 }
 
 /// @brief Sets the minor tics for the y-axis.
-auto Gnuplot::set_ytics_minor(int minor_intervals) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_ytics_minor(int minor_intervals) -> Gnuplot &
 {
     if (minor_intervals <= 0) {
         throw std::invalid_argument("Number of minor intervals for y-axis must be positive.");
@@ -1546,7 +2427,7 @@ auto Gnuplot::set_ytics_minor(int minor_intervals) -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::set_grid_line_type(
+GPCPP_INLINE auto Gnuplot::set_grid_line_type(
     grid_type_t grid_type,
     line_type_t style,
     const Color &color,
@@ -1612,7 +2493,8 @@ auto Gnuplot::set_grid_line_type(
     return *this;
 }
 
-auto Gnuplot::apply_grid(const std::string &tics, const std::string &layer, bool vertical_lines) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::apply_grid(const std::string &tics, const std::string &layer, bool vertical_lines)
+    -> Gnuplot &
 {
     std::string cmd = "set grid " + tics;
     if (layer == "front" || layer == "back") {
@@ -1634,67 +2516,191 @@ auto Gnuplot::apply_grid(const std::string &tics, const std::string &layer, bool
     return *this;
 }
 
-auto Gnuplot::unset_grid() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::unset_grid() -> Gnuplot &
 {
     this->send_cmd("unset grid");
+    // Release the grid line styles, so that their IDs can be reused.
+    if (grid_major_style_id > 0) {
+        id_manager_line_style.release(grid_major_style_id);
+        grid_major_style_id = -1;
+    }
+    if (grid_minor_style_id > 0) {
+        id_manager_line_style.release(grid_minor_style_id);
+        grid_minor_style_id = -1;
+    }
     return *this;
 }
 
-auto Gnuplot::set_multiplot() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_multiplot() -> Gnuplot &
 {
     this->send_cmd("set multiplot");
+    // Start caching the panels of the new multiplot.
+    multiplot.active   = true;
+    multiplot.panel    = -1;
+    multiplot.prologue = "set multiplot";
+    multiplot.epilogue = "unset multiplot\nset origin 0,0\nset size 1,1";
+    multiplot.panels.clear();
     return *this;
 }
 
-auto Gnuplot::unset_multiplot() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::unset_multiplot() -> Gnuplot &
 {
+    // Stop caching, the cached panels are kept for refresh_multiplot.
+    multiplot.active = false;
+    multiplot.panel  = -1;
     this->send_cmd("unset multiplot");
+    // The last panel leaves its origin and size behind, the next plots take the whole canvas.
+    this->send_cmd("set origin 0,0");
+    this->send_cmd("set size 1,1");
     return *this;
 }
 
-auto Gnuplot::set_origin_and_size(double x_origin, double y_origin, double width, double height) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_origin_and_size(double x_origin, double y_origin, double width, double height)
+    -> Gnuplot &
 {
+    const std::string origin = "set origin " + std::to_string(x_origin) + "," + std::to_string(y_origin);
+    const std::string size   = "set size " + std::to_string(width) + "," + std::to_string(height);
+
+    // In multiplot mode, the placement starts a new panel.
+    if (multiplot.active && !multiplot.capturing) {
+        panel_commands_t panel = {origin + "\n" + size + "\n", "", false, {}, {}};
+        multiplot.panels.push_back(panel);
+        multiplot.panel = -1;
+    }
+
     // Set the origin (position) of the plot in the window
-    this->send_cmd("set origin " + std::to_string(x_origin) + "," + std::to_string(y_origin));
+    this->send_cmd(origin);
 
     // Set the size of the plot area (width and height relative to the window)
-    this->send_cmd("set size " + std::to_string(width) + "," + std::to_string(height));
+    this->send_cmd(size);
+
+    if (multiplot.active && !multiplot.capturing) {
+        multiplot.panel = static_cast<int>(multiplot.panels.size()) - 1;
+        // The first plot of the panel must not replot the previous panel.
+        nplots = 0;
+    }
 
     // Return the current object for method chaining
     return *this;
 }
 
-auto Gnuplot::set_samples(const int samples) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::update_panel(std::size_t index, const std::function<void(Gnuplot &)> &draw) -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot update the panel.\n";
+        return *this;
+    }
+
+    // Validate the panel.
+    if (multiplot.active) {
+        std::cerr << "Error: The multiplot is still being drawn. Cannot update the panel.\n";
+        return *this;
+    }
+    if (index >= multiplot.panels.size()) {
+        std::cerr << "Error: Invalid panel index " << index << ". Cannot update the panel.\n";
+        return *this;
+    }
+
+    // Cache the commands issued by the callback, in place of the old ones.
+    const std::vector<std::string> superseded = multiplot.panels[index].owned;
+    multiplot.panels[index].commands.clear();
+    multiplot.panels[index].files.clear();
+    multiplot.panels[index].owned.clear();
+    multiplot.capturing = true;
+    multiplot.panel     = static_cast<int>(index);
+    nplots              = 0;
+    draw(*this);
+    multiplot.capturing = false;
+    multiplot.panel     = -1;
+    nplots              = 0;
+
+    // Release the files of the old panel that no panel reads anymore.
+    for (const std::string &filename : superseded) {
+        bool used = false;
+        for (const panel_commands_t &panel : multiplot.panels) {
+            used = used || (std::find(panel.files.begin(), panel.files.end(), filename) != panel.files.end());
+        }
+        if (!used) {
+            storage.figure.erase(filename);
+            this->discard_tmpfile(filename);
+        }
+    }
+
+    multiplot.panels[index].dirty = true;
+    return *this;
+}
+
+GPCPP_INLINE auto Gnuplot::refresh_multiplot() -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot refresh the multiplot.\n";
+        return *this;
+    }
+
+    // Nothing to do if no panel changed.
+    bool dirty = false;
+    for (const panel_commands_t &panel : multiplot.panels) {
+        dirty = dirty || panel.dirty;
+    }
+    if (!dirty) {
+        return *this;
+    }
+
+    // Replay all the panels at once, the data files are still in place, and are now the most recently used.
+    std::ostringstream oss;
+    oss << multiplot.prologue << "\n";
+    for (panel_commands_t &panel : multiplot.panels) {
+        oss << panel.placement << panel.commands;
+        panel.dirty = false;
+        for (const std::string &filename : panel.files) {
+            storage.files.touch(filename);
+        }
+    }
+    oss << multiplot.epilogue;
+    this->send_cmd(oss.str());
+    this->flush_pipe();
+
+    // The panels must not be replotted by the next plot.
+    return this->reset_plot();
+}
+
+GPCPP_INLINE auto Gnuplot::set_samples(const int samples) -> Gnuplot &
 {
+    // Under a frame budget, the samples follow the level of detail.
+    budget.samples = samples;
     std::ostringstream cmdstr;
-    cmdstr << "set samples " << samples;
+    cmdstr << "set samples " << ((samples > 0) ? Gnuplot::scale_samples(samples, budget.applied, false) : samples);
     this->send_cmd(cmdstr.str());
 
     return *this;
 }
 
-auto Gnuplot::set_isosamples(const int isolines) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_isosamples(const int isolines) -> Gnuplot &
 {
+    // Under a frame budget, the isolines follow the level of detail.
+    budget.isosamples = isolines;
     std::ostringstream cmdstr;
-    cmdstr << "set isosamples " << isolines;
+    cmdstr << "set isosamples " << ((isolines > 0) ? Gnuplot::scale_samples(isolines, budget.applied, true) : isolines);
     this->send_cmd(cmdstr.str());
 
     return *this;
 }
 
-auto Gnuplot::set_contour_type(contour_type_t type) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_contour_type(contour_type_t type) -> Gnuplot &
 {
     contour.type = type;
     return *this;
 }
 
-auto Gnuplot::set_contour_param(contour_param_t param) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_contour_param(contour_param_t param) -> Gnuplot &
 {
     contour.param = param;
     return *this;
 }
 
-auto Gnuplot::set_contour_levels(int levels) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_contour_levels(int levels) -> Gnuplot &
 {
     if (levels > 0) {
         contour.levels = levels;
@@ -1702,7 +2708,7 @@ auto Gnuplot::set_contour_levels(int levels) -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::set_contour_increment(double start, double step, double end) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_contour_increment(double start, double step, double end) -> Gnuplot &
 {
     contour.increment_start = start;
     contour.increment_step  = step;
@@ -1710,64 +2716,64 @@ auto Gnuplot::set_contour_increment(double start, double step, double end) -> Gn
     return *this;
 }
 
-auto Gnuplot::set_contour_discrete_levels(const std::vector<double> &levels) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_contour_discrete_levels(const std::vector<double> &levels) -> Gnuplot &
 {
     contour.discrete_levels = levels;
     return *this;
 }
 
-auto Gnuplot::set_hidden3d() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_hidden3d() -> Gnuplot &
 {
     this->send_cmd("set hidden3d");
     return *this;
 }
 
-auto Gnuplot::unset_hidden3d() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::unset_hidden3d() -> Gnuplot &
 {
     this->send_cmd("unset hidden3d");
     return *this;
 }
 
-auto Gnuplot::unset_contour() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::unset_contour() -> Gnuplot &
 {
     this->send_cmd("unset contour");
     return *this;
 }
 
-auto Gnuplot::set_surface() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_surface() -> Gnuplot &
 {
     this->send_cmd("set surface");
     return *this;
 }
 
-auto Gnuplot::unset_surface() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::unset_surface() -> Gnuplot &
 {
     this->send_cmd("unset surface");
     return *this;
 }
 
-auto Gnuplot::set_xautoscale() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_xautoscale() -> Gnuplot &
 {
     this->send_cmd("set xrange restore");
     this->send_cmd("set autoscale x");
     return *this;
 }
 
-auto Gnuplot::set_yautoscale() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_yautoscale() -> Gnuplot &
 {
     this->send_cmd("set yrange restore");
     this->send_cmd("set autoscale y");
     return *this;
 }
 
-auto Gnuplot::set_zautoscale() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_zautoscale() -> Gnuplot &
 {
     this->send_cmd("set zrange restore");
     this->send_cmd("set autoscale z");
     return *this;
 }
 
-auto Gnuplot::set_xlabel(const std::string &label) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_xlabel(const std::string &label) -> Gnuplot &
 {
     std::ostringstream cmdstr;
 
@@ -1777,7 +2783,7 @@ auto Gnuplot::set_xlabel(const std::string &label) -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::set_ylabel(const std::string &label) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_ylabel(const std::string &label) -> Gnuplot &
 {
     std::ostringstream cmdstr;
 
@@ -1787,7 +2793,7 @@ auto Gnuplot::set_ylabel(const std::string &label) -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::set_zlabel(const std::string &label) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_zlabel(const std::string &label) -> Gnuplot &
 {
     std::ostringstream cmdstr;
 
@@ -1797,7 +2803,7 @@ auto Gnuplot::set_zlabel(const std::string &label) -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::set_xrange(const double iFrom, const double iTo) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_xrange(const double iFrom, const double iTo) -> Gnuplot &
 {
     std::ostringstream cmdstr;
 
@@ -1807,7 +2813,7 @@ auto Gnuplot::set_xrange(const double iFrom, const double iTo) -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::set_yrange(const double iFrom, const double iTo) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_yrange(const double iFrom, const double iTo) -> Gnuplot &
 {
     std::ostringstream cmdstr;
 
@@ -1817,7 +2823,7 @@ auto Gnuplot::set_yrange(const double iFrom, const double iTo) -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::set_zrange(const double iFrom, const double iTo) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_zrange(const double iFrom, const double iTo) -> Gnuplot &
 {
     std::ostringstream cmdstr;
 
@@ -1827,7 +2833,7 @@ auto Gnuplot::set_zrange(const double iFrom, const double iTo) -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::set_cbrange(const double iFrom, const double iTo) -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::set_cbrange(const double iFrom, const double iTo) -> Gnuplot &
 {
     std::ostringstream cmdstr;
 
@@ -1837,10 +2843,10 @@ auto Gnuplot::set_cbrange(const double iFrom, const double iTo) -> Gnuplot &
     return *this;
 }
 
-auto Gnuplot::get_program_path() -> bool
+GPCPP_INLINE auto Gnuplot::get_program_path() -> bool
 {
-    // Check the first location: `Gnuplot::m_gnuplot_path`
-    std::string tmp = Gnuplot::m_gnuplot_path + "/" + Gnuplot::m_gnuplot_filename;
+    // Check the first location: `Gnuplot::m_gnuplot_path()`
+    std::string tmp = Gnuplot::m_gnuplot_path() + "/" + Gnuplot::m_gnuplot_filename();
 
     if (Gnuplot::file_exists(tmp, 1)) { // Check for existence and execution permission
         return true;
@@ -1863,19 +2869,29 @@ auto Gnuplot::get_program_path() -> bool
 
     // Search for the Gnuplot executable in each directory
     for (const auto &dir : paths) {
-        tmp = dir + "/" + Gnuplot::m_gnuplot_filename;
+        tmp = dir + "/" + Gnuplot::m_gnuplot_filename();
         if (Gnuplot::file_exists(tmp, 1)) { // Check for existence and execution permission
-            Gnuplot::m_gnuplot_path = dir;  // Set `Gnuplot::m_gnuplot_path`
+            Gnuplot::m_gnuplot_path() = dir;  // Set `Gnuplot::m_gnuplot_path()`
             return true;
         }
     }
 
     // Gnuplot was not found
-    std::cerr << "Error: Gnuplot not found in PATH or in \"" << Gnuplot::m_gnuplot_path << "\".\n";
+    std::cerr << "Error: Gnuplot not found in PATH or in \"" << Gnuplot::m_gnuplot_path() << "\".\n";
     return false;
 }
 
-auto Gnuplot::file_exists(const std::string &filename, int mode) -> bool
+GPCPP_INLINE auto Gnuplot::file_size(const std::string &filename) -> std::size_t
+{
+    std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return 0;
+    }
+    const std::streamoff size = file.tellg();
+    return (size > 0) ? static_cast<std::size_t>(size) : 0;
+}
+
+GPCPP_INLINE auto Gnuplot::file_exists(const std::string &filename, int mode) -> bool
 {
     // Validate mode argument
     if (mode < 0 || mode > 7) {
@@ -1902,7 +2918,7 @@ auto Gnuplot::file_exists(const std::string &filename, int mode) -> bool
     return false;
 }
 
-auto Gnuplot::file_ready(const std::string &filename) -> bool
+GPCPP_INLINE auto Gnuplot::file_ready(const std::string &filename) -> bool
 {
     // Check if the file exists.
     if (Gnuplot::file_exists(filename, 0)) {
@@ -1918,13 +2934,41 @@ auto Gnuplot::file_ready(const std::string &filename) -> bool
     return true;
 }
 
-auto Gnuplot::create_tmpfile(std::ofstream &tmp) -> std::string
+GPCPP_INLINE auto Gnuplot::create_tmpfile(std::ofstream &tmp, bool binary) -> std::string
 {
+    // Select the mode used to open the file.
+    const std::ios::openmode mode = binary ? (std::ios::out | std::ios::trunc | std::ios::binary)
+                                           : (std::ios::out | std::ios::trunc);
+
+    // Inside a frame, overwrite the files of the current slot, if gnuplot acknowledges the frames.
+    std::vector<std::string> *slot = nullptr;
+    if (frames.active && (frames.fd >= 0)) {
+        slot = &frames.files[frames.slot];
+        if (frames.next_file < slot->size()) {
+            const std::string &filename = (*slot)[frames.next_file++];
+            tmp.open(filename, mode);
+            if (!tmp.is_open() || tmp.bad()) {
+                std::cerr << "Error: Cannot open temporary file \"" << filename << "\" for writing.\n";
+                return std::string();
+            }
+            storage.files.touch(filename, true);
+            storage.pending.insert(filename);
+            return filename;
+        }
+    }
+
+    // Make room for the new file, evicting the least recently used ones.
+    this->evict_storage(0);
+    while ((Gnuplot::m_tmpfile_num() >= Gnuplot::m_tmpfile_max()) && this->evict_tmpfile()) {
+    }
+    // The descriptor keeping a memory file alive.
+    int resident_fd = -1;
+
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__TOS_WIN__)
     std::string filename = "gnuplotiXXXXXX.tmp";
 
-    if (Gnuplot::m_tmpfile_num >= Gnuplot::m_tmpfile_max) {
-        std::cerr << "Error: Maximum number of temporary files reached (" << Gnuplot::m_tmpfile_max
+    if (Gnuplot::m_tmpfile_num() >= Gnuplot::m_tmpfile_max()) {
+        std::cerr << "Error: Maximum number of temporary files reached (" << Gnuplot::m_tmpfile_max()
                   << "). Cannot create more files.\n";
         return std::string();
     }
@@ -1936,7 +2980,7 @@ auto Gnuplot::create_tmpfile(std::ofstream &tmp) -> std::string
     }
 
     // Open the temporary file for writing
-    tmp.open(filename, std::ios::out | std::ios::trunc);
+    tmp.open(filename, mode);
     if (!tmp.is_open() || tmp.bad()) {
         std::cerr << "Error: Cannot open temporary file \"" << filename << "\" for writing.\n";
         return std::string();
@@ -1945,28 +2989,44 @@ auto Gnuplot::create_tmpfile(std::ofstream &tmp) -> std::string
 #elif defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
     std::string filename = "/tmp/gnuplotiXXXXXX";
 
-    if (Gnuplot::m_tmpfile_num >= Gnuplot::m_tmpfile_max) {
-        std::cerr << "Error: Maximum number of temporary files reached (" << Gnuplot::m_tmpfile_max
+    if (Gnuplot::m_tmpfile_num() >= Gnuplot::m_tmpfile_max()) {
+        std::cerr << "Error: Maximum number of temporary files reached (" << Gnuplot::m_tmpfile_max()
                   << "). Cannot create more files.\n";
         return std::string();
     }
 
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+    // With the memfd transport the data stays in memory, gnuplot reads it through our descriptor.
+    const bool in_memory = (transport == transport_t::memfd);
+    const int fd         = in_memory ? memfd_create("gpcpp", MFD_CLOEXEC) : mkstemp(&filename[0]);
+    if ((fd != -1) && in_memory) {
+        filename = "/proc/" + std::to_string(getpid()) + "/fd/" + std::to_string(fd);
+    }
+#else
+    const bool in_memory = false;
     // mkstemp requires a mutable C-string
-    int fd = mkstemp(&filename[0]);
+    const int fd = mkstemp(&filename[0]);
+#endif
     if (fd == -1) {
         std::cerr << "Error: Cannot create temporary file \"" << filename << "\".\n";
         return std::string();
     }
 
     // Associate the file descriptor with ofstream
-    tmp.open(filename);
+    tmp.open(filename, mode);
     if (!tmp.is_open() || tmp.bad()) {
         std::cerr << "Error: Cannot open temporary file \"" << filename << "\" for writing.\n";
         close(fd); // Close file descriptor to prevent leaks
         return std::string();
     }
 
-    close(fd); // Close the file descriptor after associating with ofstream
+    // A memory file lives as long as its descriptor, the others can be closed now.
+    if (in_memory) {
+        memfd_list.push_back(fd);
+        resident_fd = fd;
+    } else {
+        close(fd);
+    }
 #else
     std::cerr << "Error: Unsupported platform for temporary file creation.\n";
     return std::string();
@@ -1974,13 +3034,298 @@ auto Gnuplot::create_tmpfile(std::ofstream &tmp) -> std::string
 
     // Store the temporary file name for cleanup and increment the counter
     tmpfile_list.emplace_back(filename);
-    Gnuplot::m_tmpfile_num++;
+    Gnuplot::m_tmpfile_num()++;
+
+    // Account for the file, measured once written.
+    storage.files.add(filename, resident_fd);
+    storage.evicted.erase(filename);
+    storage.pending.insert(filename);
+    storage.metrics.resident_files = storage.files.size();
+
+    // Keep the file in the slot of the current frame, or release it with the panel drawing it.
+    if (slot != nullptr) {
+        slot->emplace_back(filename);
+        ++frames.next_file;
+    } else if (multiplot.panel >= 0) {
+        multiplot.panels[static_cast<std::size_t>(multiplot.panel)].owned.push_back(filename);
+    }
 
     // Return the name of the successfully created temporary file
     return filename;
 }
 
-auto Gnuplot::apply_contour_settings() -> Gnuplot &
+GPCPP_INLINE auto Gnuplot::reserve_storage(std::size_t bytes) -> double
+{
+    if ((storage.max_bytes == 0) || this->evict_storage(bytes)) {
+        return 1.0;
+    }
+    // What is left after evicting every file not in use.
+    const std::size_t resident = storage.files.bytes();
+    const double fraction      = ((resident < storage.max_bytes) && (bytes > 0))
+                                     ? static_cast<double>(storage.max_bytes - resident) / static_cast<double>(bytes)
+                                     : 0.0;
+    if ((storage.policy == storage_policy_t::fail_fast) || !(fraction > 0)) {
+        ++storage.metrics.rejected;
+        std::cerr << "Error: The data (" << bytes << " bytes) does not fit within the storage budget ("
+                  << storage.max_bytes << " bytes, " << resident << " in use).\n";
+        return 0.0;
+    }
+    ++storage.metrics.degraded;
+    return fraction;
+}
+
+GPCPP_INLINE auto Gnuplot::evict_storage(std::size_t bytes) -> bool
+{
+    if (storage.max_bytes == 0) {
+        return true;
+    }
+    this->measure_storage();
+    while (storage.files.bytes() + bytes > storage.max_bytes) {
+        if (!this->evict_tmpfile()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+GPCPP_INLINE auto Gnuplot::evict_tmpfile() -> bool
+{
+    // The files of the current figure, and those recycled by the frames, are still read by gnuplot.
+    // After a reset, the next plot replaces the current figure, whose files are not needed anymore.
+    // The files of the cached multiplot panels are read again by each refresh, whatever the figure.
+    const bool replaced           = (nplots == 0) && !multiplot.active;
+    const resident_file_t *victim = storage.files.least_recent([this, replaced](const resident_file_t &file) {
+        if ((!replaced && (storage.figure.count(file.filename) > 0)) || (storage.pending.count(file.filename) > 0)) {
+            return false;
+        }
+        for (const std::vector<std::string> &slot : frames.files) {
+            if (std::find(slot.begin(), slot.end(), file.filename) != slot.end()) {
+                return false;
+            }
+        }
+        for (const panel_commands_t &panel : multiplot.panels) {
+            if (std::find(panel.files.begin(), panel.files.end(), file.filename) != panel.files.end()) {
+                return false;
+            }
+        }
+        return true;
+    });
+    if (victim == nullptr) {
+        return false;
+    }
+    const resident_file_t file = *victim;
+    this->release_tmpfile(file);
+    storage.evicted.insert(file.filename);
+
+    // Update the statistics.
+    ++storage.metrics.evicted_files;
+    storage.metrics.evicted_bytes += file.bytes;
+    storage.metrics.resident_bytes = storage.files.bytes();
+    storage.metrics.resident_files = storage.files.size();
+    return true;
+}
+
+GPCPP_INLINE void Gnuplot::release_tmpfile(const resident_file_t &file)
+{
+    // Memory files are released by closing them, the others are removed.
+    if (file.fd < 0) {
+        if (std::remove(file.filename.c_str()) != 0) {
+            std::cerr << "Warning: Unable to remove temporary file \"" << file.filename << "\".\n";
+        }
+    }
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+    else {
+        close(file.fd);
+        memfd_list.erase(std::remove(memfd_list.begin(), memfd_list.end(), file.fd), memfd_list.end());
+    }
+#endif
+    tmpfile_list.erase(std::remove(tmpfile_list.begin(), tmpfile_list.end(), file.filename), tmpfile_list.end());
+    Gnuplot::uncount_tmpfiles(1);
+    storage.files.remove(file.filename);
+}
+
+GPCPP_INLINE void Gnuplot::discard_tmpfile(const std::string &filename)
+{
+    storage.pending.erase(filename);
+    for (const std::vector<std::string> &slot : frames.files) {
+        if (std::find(slot.begin(), slot.end(), filename) != slot.end()) {
+            return;
+        }
+    }
+    const resident_file_t *file = storage.files.find(filename);
+    if (file == nullptr) {
+        return;
+    }
+    this->release_tmpfile(resident_file_t(*file));
+    storage.metrics.resident_bytes = storage.files.bytes();
+    storage.metrics.resident_files = storage.files.size();
+}
+
+GPCPP_INLINE auto Gnuplot::report_upload(std::size_t written, std::size_t total) -> bool
+{
+    // Number of records between two reports.
+    const std::size_t period = 4096;
+    if ((written > 0) && (written < total) && (written - uploads.reported < period)) {
+        return true;
+    }
+    uploads.reported = written;
+    if (uploads.progress) {
+        uploads.progress(written, total);
+    }
+    return !uploads.cancel.is_cancelled();
+}
+
+GPCPP_INLINE void Gnuplot::measure_storage()
+{
+    storage.files.measure([](const std::string &filename) { return Gnuplot::file_size(filename); });
+    storage.metrics.resident_bytes      = storage.files.bytes();
+    storage.metrics.resident_files      = storage.files.size();
+    storage.metrics.peak_resident_bytes = (std::max)(storage.metrics.peak_resident_bytes, storage.files.bytes());
+}
+
+GPCPP_INLINE auto Gnuplot::use_tmpfile(const std::string &filename) -> bool
+{
+    if (storage.evicted.count(filename) > 0) {
+        return false;
+    }
+    storage.files.touch(filename);
+    storage.pending.insert(filename);
+    return true;
+}
+
+GPCPP_INLINE auto Gnuplot::rewrite_candles(const ohlc_bars_t &bars, std::size_t first) -> dataset_t
+{
+    // Number of values of each bar.
+    const std::size_t ncolumns = 5;
+
+    // Open the file without truncating it, and move to the first bar to write.
+    std::ofstream file(candles.filename, std::ios::in | std::ios::out | std::ios::binary);
+    if (!file.is_open() || file.bad()) {
+        return dataset_t();
+    }
+    file.seekp(static_cast<std::streamoff>(first * ncolumns * sizeof(double)));
+
+    std::vector<double> buffer;
+    buffer.reserve((bars.size() - first) * ncolumns);
+    for (std::size_t i = first; i < bars.size(); ++i) {
+        const double record[] = {bars.time[i], bars.open[i], bars.low[i], bars.high[i], bars.close[i]};
+        buffer.insert(buffer.end(), record, record + ncolumns);
+    }
+    if (!file.good() || !Gnuplot::write_records(file, buffer, ncolumns, true, std::vector<std::size_t>())) {
+        return dataset_t();
+    }
+    file.close();
+    if (file.fail()) {
+        return dataset_t();
+    }
+    storage.files.touch(candles.filename, true);
+    return dataset_t(candles.filename, ncolumns, bars.size(), true);
+}
+
+GPCPP_INLINE auto Gnuplot::write_source(chunk_source_t &source, nonfinite_policy_t policy) -> dataset_t
+{
+    const std::size_t ncolumns = source.columns();
+
+    // Without binary support, the values are written as text.
+    const bool binary = (transport != transport_t::text_file);
+
+    if (!this->report_upload(0, 0)) {
+        return dataset_t();
+    }
+
+    // Create a temporary file for storing the data
+    std::ofstream file;
+    std::string filename = this->create_tmpfile(file, binary);
+    if (filename.empty()) {
+        std::cerr << "Error: Failed to create a temporary file.\n";
+        return dataset_t();
+    }
+
+    // Stream the chunks, keeping only one of them in memory.
+    std::vector<double> buffer;
+    std::vector<std::size_t> breaks;
+    nonfinite_splitter_t splitter(policy, ncolumns);
+    std::size_t rows = 0;
+    while (source.next_chunk(buffer)) {
+        const std::size_t records = buffer.size() / ncolumns;
+        // Ignore the values of an incomplete record.
+        buffer.resize(records * ncolumns);
+        splitter.split(buffer, breaks);
+        if (!Gnuplot::write_records(file, buffer, ncolumns, binary, breaks)) {
+            std::cerr << "Error: Failed to write data to the temporary file: " << filename << '\n';
+            file.close();
+            return dataset_t();
+        }
+        rows += records;
+        // Stop here if the upload has been cancelled, so the next upload starts from the first record.
+        if (!this->report_upload(rows, 0)) {
+            file.close();
+            this->discard_tmpfile(filename);
+            source.rewind();
+            return dataset_t();
+        }
+    }
+
+    // Flush the file buffer and close the file
+    file.flush();
+    if (file.fail()) {
+        std::cerr << "Error: Failed to flush data to the temporary file: " << filename << '\n';
+        file.close();
+        return dataset_t();
+    }
+    file.close();
+
+    // Check that the source provided at least one record.
+    if (rows == 0) {
+        std::cerr << "Error: The source provided no records. Cannot plot.\n";
+        this->discard_tmpfile(filename);
+        return dataset_t();
+    }
+    if (splitter.get_rows() == 0) {
+        std::cerr << "Error: All the records provided by the source hold non-finite values. Cannot plot.\n";
+        this->discard_tmpfile(filename);
+        return dataset_t();
+    }
+
+    // Check if the file is available for reading
+    if (!gpcpp::Gnuplot::file_ready(filename)) {
+        std::cerr << "Error: File " << filename << " is not available for reading.\n";
+        return dataset_t();
+    }
+    dataset_t dataset(filename, ncolumns, splitter.get_rows(), binary);
+    dataset.segments = splitter.get_segments();
+    return dataset;
+}
+
+GPCPP_INLINE auto Gnuplot::write_records(
+    std::ofstream &file,
+    const std::vector<double> &records,
+    std::size_t ncolumns,
+    bool binary,
+    const std::vector<std::size_t> &breaks) -> bool
+{
+    if (binary) {
+        return static_cast<bool>(file.write(
+            reinterpret_cast<const char *>(records.data()),
+            static_cast<std::streamsize>(records.size() * sizeof(double))));
+    }
+    // One record per line, with enough digits to read back the same values.
+    file << std::setprecision(std::numeric_limits<double>::max_digits10);
+    std::size_t gap = 0;
+    for (std::size_t r = 0; r < records.size() / ncolumns; ++r) {
+        // An empty line breaks the data.
+        if ((gap < breaks.size()) && (breaks[gap] == r)) {
+            file << '\n';
+            ++gap;
+        }
+        for (std::size_t c = 0; c < ncolumns; ++c) {
+            file << records[r * ncolumns + c] << (((c + 1) == ncolumns) ? '\n' : ' ');
+        }
+    }
+    return !file.fail();
+}
+
+GPCPP_INLINE auto Gnuplot::apply_contour_settings() -> Gnuplot &
 {
     // Set contour type.
     switch (contour.type) {
@@ -2029,26 +3374,248 @@ auto Gnuplot::apply_contour_settings() -> Gnuplot &
     return *this;
 }
 
-void Gnuplot::remove_tmpfiles()
+GPCPP_INLINE void Gnuplot::remove_tmpfiles()
 {
     if (tmpfile_list.empty()) {
         return; // No temporary files to remove
     }
     for (const auto &tmpfile : tmpfile_list) {
+        // The memory files are released by closing them.
+        if (tmpfile.compare(0, 6, "/proc/") == 0) {
+            continue;
+        }
         if (std::remove(tmpfile.c_str()) != 0) {
             std::cerr << "Warning: Unable to remove temporary file \"" << tmpfile << "\".\n";
         }
     }
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+    for (const int fd : memfd_list) {
+        close(fd);
+    }
+#endif
+    memfd_list.clear();
     // Adjust the global temporary file counter.
-    if (Gnuplot::m_tmpfile_num < tmpfile_list.size()) {
-        std::cerr << "We are trying to remove more tmp files than expected (curret: " << Gnuplot::m_tmpfile_num
-                  << ", to close: " << tmpfile_list.size() << ").\n";
-        Gnuplot::m_tmpfile_num = 0;
-    } else {
-        Gnuplot::m_tmpfile_num -= tmpfile_list.size();
+    if (!Gnuplot::uncount_tmpfiles(tmpfile_list.size())) {
+        std::cerr << "We are trying to remove more tmp files than expected (to close: " << tmpfile_list.size()
+                  << ").\n";
     }
     // Clear the list of temporary files
     tmpfile_list.clear();
+    storage.files.clear();
+    storage.figure.clear();
+    storage.pending.clear();
+    storage.metrics.resident_bytes = 0;
+    storage.metrics.resident_files = 0;
+    // The frames cannot recycle the removed files.
+    frames.files.clear();
+    frames.owners.clear();
+}
+
+GPCPP_INLINE auto Gnuplot::open_frame_channel() -> bool
+{
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+    // Reserve a unique name, and replace the file with a FIFO.
+    std::string channel = "/tmp/gnuplotfXXXXXX";
+    int fd              = mkstemp(&channel[0]);
+    if (fd == -1) {
+        std::cerr << "Warning: Cannot create the channel for the frames, files will not be recycled.\n";
+        return false;
+    }
+    close(fd);
+    std::remove(channel.c_str());
+    if (mkfifo(channel.c_str(), 0600) != 0) {
+        std::cerr << "Warning: Cannot create the channel for the frames, files will not be recycled.\n";
+        return false;
+    }
+
+    // Open the read end without blocking, so that gnuplot can open the write end.
+    fd = open(channel.c_str(), O_RDONLY | O_NONBLOCK);
+    if (fd == -1) {
+        std::cerr << "Warning: Cannot open the channel for the frames, files will not be recycled.\n";
+        std::remove(channel.c_str());
+        return false;
+    }
+    frames.channel = channel;
+    frames.fd      = fd;
+    frames.received.clear();
+
+    // Redirect the output of gnuplot's print command to the channel.
+    this->send_cmd("set print \"" + channel + "\"");
+    this->flush_pipe();
+    return true;
+#else
+    // There are no FIFOs, frames are sent without recycling their files.
+    return false;
+#endif
+}
+
+GPCPP_INLINE void Gnuplot::close_frame_channel()
+{
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+    if (frames.fd >= 0) {
+        close(frames.fd);
+        frames.fd = -1;
+    }
+#endif
+    if (!frames.channel.empty()) {
+        std::remove(frames.channel.c_str());
+        frames.channel.clear();
+    }
+    // The files of the slots cannot be recycled anymore.
+    frames.files.clear();
+    frames.sent.clear();
+    frames.owners.clear();
+}
+
+GPCPP_INLINE auto Gnuplot::wait_frame(std::size_t frame) -> bool
+{
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+    // Give up if gnuplot does not answer, rather than blocking forever.
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+    while (frames.acknowledged < frame) {
+        // Rather than waiting, drop the frame if it has not been sent yet.
+        if (((outbound.policy == overload_policy_t::drop_oldest) || (outbound.policy == overload_policy_t::coalesce)) &&
+            (this->drop_outbound_frames(1, frame) > 0)) {
+            ++((outbound.policy == overload_policy_t::coalesce) ? outbound.metrics.frames_coalesced
+                                                                : outbound.metrics.frames_dropped);
+        }
+        // A frame dropped before being sent will never be read.
+        if (frames.dropped.erase(frame) > 0) {
+            return true;
+        }
+        if (frames.fd < 0) {
+            return false;
+        }
+        const auto remaining =
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+            std::cerr << "Warning: gnuplot did not acknowledge frame " << frame << ".\n";
+            return false;
+        }
+        // The frame might still be queued, keep sending it while waiting.
+        this->drain_outbound(0);
+        if (!this->read_frame_acks(outbound.chunks.empty() ? static_cast<int>(remaining) : 10)) {
+            return false;
+        }
+    }
+    return true;
+#else
+    (void)frame;
+    return false;
+#endif
+}
+
+GPCPP_INLINE auto Gnuplot::read_frame_acks(int timeout_ms) -> bool
+{
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+    if (frames.fd < 0) {
+        return false;
+    }
+    pollfd pfd{};
+    pfd.fd     = frames.fd;
+    pfd.events = POLLIN;
+    if (poll(&pfd, 1, timeout_ms) <= 0) {
+        return true;
+    }
+    char buffer[256];
+    const ssize_t n = read(frames.fd, buffer, sizeof(buffer));
+    if (n > 0) {
+        frames.received.append(buffer, static_cast<std::size_t>(n));
+        // Parse the complete lines.
+        std::size_t end = 0;
+        while ((end = frames.received.find('\n')) != std::string::npos) {
+            const std::string line = frames.received.substr(0, end);
+            frames.received.erase(0, end + 1);
+            if (line.compare(0, 12, "gpcpp-frame ") == 0) {
+                char *stamp             = nullptr;
+                const std::size_t frame = static_cast<std::size_t>(std::strtoull(line.c_str() + 12, &stamp, 10));
+                frames.acknowledged     = (std::max)(frames.acknowledged, frame);
+                this->frame_rendered(frame, stamp);
+                while (!frames.sent.empty() && (frames.sent.front() <= frames.acknowledged)) {
+                    frames.sent.pop_front();
+                }
+            }
+        }
+    } else if ((n == 0) || ((errno != EAGAIN) && (errno != EINTR))) {
+        // gnuplot closed the channel.
+        std::cerr << "Warning: The channel for the frames was closed, files will not be recycled.\n";
+        this->close_frame_channel();
+        return false;
+    }
+    return true;
+#else
+    (void)timeout_ms;
+    return false;
+#endif
+}
+
+GPCPP_INLINE void Gnuplot::frame_transferred(std::size_t frame)
+{
+    const std::map<std::size_t, std::chrono::steady_clock::time_point>::iterator mark = budget.marks.find(frame);
+    if (mark == budget.marks.end()) {
+        return;
+    }
+    const auto now                    = std::chrono::steady_clock::now();
+    budget.timings[frame].transfer_ms = std::chrono::duration<double, std::milli>(now - mark->second).count();
+    mark->second                      = now;
+    // Without the acknowledgements, the rendering cannot be measured.
+    if (frames.fd < 0) {
+        this->frame_rendered(frame, "");
+    }
+}
+
+GPCPP_INLINE void Gnuplot::frame_rendered(std::size_t frame, const char *stamp)
+{
+    const std::map<std::size_t, frame_timing_t>::iterator timing = budget.timings.find(frame);
+    const std::map<std::size_t, std::chrono::steady_clock::time_point>::iterator mark = budget.marks.find(frame);
+    if ((timing != budget.timings.end()) && (mark != budget.marks.end())) {
+        std::chrono::steady_clock::time_point rendered = std::chrono::steady_clock::now();
+        // gnuplot tells when it drew the frame on the system clock, which may be long before now.
+        char *end            = nullptr;
+        const double seconds = (stamp != nullptr) ? std::strtod(stamp, &end) : 0.0;
+        if ((end != stamp) && (seconds > 0)) {
+            const double ago =
+                std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count() - seconds;
+            if (ago > 0) {
+                rendered -= std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(ago));
+            }
+        }
+        timing->second.render_ms =
+            (std::max)(0.0, std::chrono::duration<double, std::milli>(rendered - mark->second).count());
+        budget.controller.update(timing->second);
+    }
+    // The older frames have been dropped, or drawn without being measured.
+    budget.timings.erase(budget.timings.begin(), budget.timings.upper_bound(frame));
+    budget.marks.erase(budget.marks.begin(), budget.marks.upper_bound(frame));
+}
+
+GPCPP_INLINE void Gnuplot::apply_detail()
+{
+    const double scale = budget.controller.get_scale();
+    if (std::fabs(scale - budget.applied) <= 1e-3 * budget.applied) {
+        return;
+    }
+    budget.applied = scale;
+    if (budget.samples > 0) {
+        this->send_cmd("set samples " + std::to_string(Gnuplot::scale_samples(budget.samples, scale, false)));
+    }
+    if (budget.isosamples > 0) {
+        this->send_cmd("set isosamples " + std::to_string(Gnuplot::scale_samples(budget.isosamples, scale, true)));
+    }
+    // Text files are the slowest to write and to parse.
+    if ((scale < 1.0) && (transport == transport_t::text_file) &&
+        (capabilities.best_transport() != transport_t::text_file)) {
+        transport = capabilities.best_transport();
+    }
+}
+
+GPCPP_INLINE auto Gnuplot::scale_samples(int samples, double scale, bool grid) -> int
+{
+    // The cost of a grid grows with the square of its samples.
+    const double factor = grid ? std::sqrt(scale) : scale;
+    return (std::max)(2, static_cast<int>(std::ceil(static_cast<double>(samples) * factor)));
 }
 
 } // namespace gpcpp
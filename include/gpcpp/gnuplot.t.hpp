@@ -0,0 +1,1412 @@
+/// @file gnuplot.t.hpp
+/// @brief Definitions of the template functions of the Gnuplot class.
+/// @details Unlike gnuplot.i.hpp, this file is always included by gnuplot.hpp, also when linking
+/// the compiled library, which however provides the instantiations for the common containers.
+
+#pragma once
+
+#include "gnuplot.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <type_traits>
+
+namespace gpcpp
+{
+
+/// @brief Checks if the difference between two floating-point values exceeds a tolerance.
+/// @param a The first value.
+/// @param b The second value.
+/// @param tolerance The allowable difference (default is 1e-6).
+/// @returns True if the difference exceeds the tolerance, false otherwise.
+template <typename T>
+inline auto are_equal(T a, T b, T tolerance = 1e-6) -> bool
+{
+    static_assert(std::is_floating_point<T>::value, "exceeds_tolerance requires floating-point types.");
+    return std::abs(a - b) > tolerance;
+}
+
+/// @brief Converts a time point to the number of seconds since the epoch of its clock.
+/// @param t The time point.
+/// @return The number of seconds, including the fractional part.
+template <typename Clock, typename Duration>
+inline auto to_epoch_seconds(const std::chrono::time_point<Clock, Duration> &t) -> double
+{
+    return std::chrono::duration<double>(t.time_since_epoch()).count();
+}
+
+/// @brief Converts a number of seconds since the epoch to double.
+/// @param t The number of seconds.
+/// @return The number of seconds as a double.
+template <typename T>
+inline auto to_epoch_seconds(T t) -> typename std::enable_if<std::is_arithmetic<T>::value, double>::type
+{
+    return static_cast<double>(t);
+}
+
+/// @brief Read-only view of a container of timestamps, as seconds since the epoch.
+/// @tparam T The type of the container.
+template <typename T>
+struct epoch_seconds_view_t {
+    const T &data; ///< The viewed container.
+
+    /// @brief Returns the i-th timestamp as seconds since the epoch.
+    /// @param i The index of the timestamp.
+    /// @return The number of seconds.
+    auto operator[](std::size_t i) const -> double { return to_epoch_seconds(data[i]); }
+};
+
+template <typename X>
+auto Gnuplot::plot_x(const X &x, const std::string &title) -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready.
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session not ready.\n";
+        return *this;
+    }
+
+    // Check if the input vector is empty.
+    if (x.empty()) {
+        std::cerr << "Error: Input vector is empty. Cannot plot data." << '\n';
+        return *this;
+    }
+
+    if (!this->report_upload(0, x.size())) {
+        return *this;
+    }
+
+    // Create a temporary file for storing the data
+    std::ofstream file;
+    std::string filename = this->create_tmpfile(file);
+    if (filename.empty()) {
+        std::cerr << "Error: Temporary file filename is empty. File creation failed." << '\n';
+        return *this;
+    }
+
+    // Write the data to the temporary file
+    for (size_t i = 0; i < x.size(); ++i) {
+        if (!(file << x[i] << '\n')) {
+            file.close();
+            std::cerr << "Error: Failed to write data to the temporary file: " << filename << '\n';
+            return *this;
+        }
+        if (!this->report_upload(i + 1, x.size())) {
+            file.close();
+            this->discard_tmpfile(filename);
+            return *this;
+        }
+    }
+
+    // Ensure the file buffer is flushed
+    file.flush();
+    if (file.fail()) {
+        file.close();
+        std::cerr << "Error: Failed to flush data to the temporary file: " << filename << '\n';
+        return *this;
+    }
+    file.close();
+
+    // Check if the file is available for reading.
+    if (!gpcpp::Gnuplot::file_ready(filename)) {
+        std::cerr << "Error: File " << filename << " is not available for reading." << '\n';
+        return *this;
+    }
+
+    std::ostringstream oss;
+    // Determine whether to use 'plot' or 'replot' based on the current plot state.
+    oss << ((nplots > 0 && two_dim) ? "replot" : "plot");
+    // Specify the file and columns for the Gnuplot command.
+    oss << " \"" << filename << "\" using 1";
+    // Add a title or specify 'notitle' if no title is provided.
+    oss << (title.empty() ? " notitle " : " title \"" + title + "\"");
+    // Specify the plot style or smoothing option.
+    if (smooth_type == smooth_type_t::none) {
+        oss << " with " << plot_type_to_string(plot_type);
+    } else {
+        oss << " smooth " << smooth_type_to_string(smooth_type);
+    }
+    // Include line color if it is specified.
+    if (line_color.is_set()) {
+        oss << " lc rgbcolor \"" << line_color.to_string() << "\"";
+    }
+    // Add line style options only if the plot style supports lines.
+    if (is_line_type(plot_type)) {
+        // Add line width if specified.
+        if (line_width > 0) {
+            oss << " lw " << line_width;
+        }
+        // Add line style if specified.
+        if (!line_type.empty()) {
+            oss << " " << line_type;
+        }
+    }
+    // Add point style and size only if the plot style supports points.
+    if (is_point_type(plot_type)) {
+        // Add point style if specified.
+        oss << " pt " << point_type_to_string(point_type);
+        // Add point size if specified.
+        if (point_size > 0) {
+            oss << " ps " << point_size;
+        }
+    }
+    // Send the constructed command to Gnuplot for execution
+    this->send_cmd(oss.str());
+
+    return *this;
+}
+
+template <typename X>
+auto Gnuplot::plot_x(const std::vector<X> &datasets, const std::vector<std::string> &titles) -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session not ready.\n";
+        return *this;
+    }
+
+    // Validate input data
+    if (datasets.empty()) {
+        std::cerr << "Error: Input datasets are empty. Cannot plot.\n";
+        return *this;
+    }
+
+    if (!titles.empty() && titles.size() != datasets.size()) {
+        std::cerr << "Error: Mismatch between the number of datasets and titles.\n";
+        return *this;
+    }
+
+    std::vector<std::string> filenames;
+    filenames.reserve(datasets.size());
+
+    // Create temporary files for each dataset
+    bool cancelled = false;
+    for (size_t i = 0; (i < datasets.size()) && !cancelled; ++i) {
+        if (datasets[i].empty()) {
+            std::cerr << "Error: Dataset " << i + 1 << " is empty. Skipping.\n";
+            continue;
+        }
+
+        if (!this->report_upload(0, datasets[i].size())) {
+            cancelled = true;
+            break;
+        }
+
+        std::ofstream file;
+        std::string filename = this->create_tmpfile(file);
+        if (filename.empty()) {
+            std::cerr << "Error: Temporary file creation failed for dataset " << i + 1 << ". Skipping.\n";
+            continue;
+        }
+
+        for (std::size_t k = 0; (k < datasets[i].size()) && !cancelled; ++k) {
+            if (!(file << datasets[i][k] << '\n')) {
+                std::cerr << "Error: Failed to write data to temporary file: " << filename << ". Skipping dataset.\n";
+                file.close();
+                continue;
+            }
+            cancelled = !this->report_upload(k + 1, datasets[i].size());
+        }
+        if (cancelled) {
+            file.close();
+            filenames.push_back(filename);
+            break;
+        }
+
+        file.flush();
+        if (file.fail()) {
+            std::cerr << "Error: Failed to flush data to temporary file: " << filename << ". Skipping dataset.\n";
+            file.close();
+            continue;
+        }
+        file.close();
+
+        filenames.push_back(filename);
+    }
+
+    // A cancelled plot leaves no file behind.
+    if (cancelled) {
+        for (const std::string &filename : filenames) {
+            this->discard_tmpfile(filename);
+        }
+        return *this;
+    }
+
+    if (filenames.empty()) {
+        std::cerr << "Error: No valid datasets to plot.\n";
+        return *this;
+    }
+
+    // Check if the file is available for reading.
+    for (const auto &filename : filenames) {
+        if (!gpcpp::Gnuplot::file_ready(filename)) {
+            std::cerr << "Error: File " << filename << " is not available for reading.\n";
+            return *this;
+        }
+    }
+
+    std::ostringstream oss;
+
+    // Determine the command ('plot' or 'replot')
+    oss << ((nplots > 0 && two_dim) ? "replot " : "plot ");
+
+    // Construct the plotting command for each dataset
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        oss << "\"" << filenames[i] << "\" using 1";
+
+        // Add title
+        if (titles.empty() || titles[i].empty()) {
+            oss << " notitle ";
+        } else {
+            oss << " title \"" << titles[i] << "\" ";
+        }
+
+        // Specify plot style or smoothing
+        if (smooth_type == smooth_type_t::none) {
+            oss << " with " << plot_type_to_string(plot_type);
+        } else {
+            oss << " smooth " << smooth_type_to_string(smooth_type);
+        }
+
+        // Add line options if applicable
+        if (is_line_type(plot_type)) {
+            if (line_width > 0) {
+                oss << " lw " << line_width;
+            }
+            if (line_color.is_set()) {
+                oss << " lc rgbcolor \"" << line_color.to_string() << "\"";
+            }
+        }
+
+        // Add point options if applicable
+        if (is_point_type(plot_type)) {
+            oss << " pt " << point_type_to_string(point_type);
+            if (point_size > 0) {
+                oss << " ps " << point_size;
+            }
+        }
+
+        // Add a comma unless it's the last dataset
+        if (i != filenames.size() - 1) {
+            oss << ", ";
+        }
+    }
+
+    // Send the constructed command to Gnuplot
+    this->send_cmd(oss.str());
+
+    return *this;
+}
+
+template <typename X, typename Y>
+auto Gnuplot::plot_xy(const X &x, const Y &y, const std::string &title) -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
+        return *this;
+    }
+
+    // Validate input vectors
+    if (x.empty() || y.empty()) {
+        std::cerr << "Error: Input vectors are empty. Cannot plot.\n";
+        return *this;
+    }
+
+    if (x.size() != y.size()) {
+        std::cerr << "Error: Mismatch between the lengths of x and y vectors.\n";
+        return *this;
+    }
+
+    // Make room for the data, about 13 characters per value.
+    const double room = this->reserve_storage(x.size() * 2 * 13);
+    if (!(room > 0) || !this->report_upload(0, x.size())) {
+        return *this;
+    }
+
+    // Create a temporary file for storing the data
+    std::ofstream file;
+    std::string filename = this->create_tmpfile(file);
+    if (filename.empty()) {
+        std::cerr << "Error: Failed to create a temporary file.\n";
+        return *this;
+    }
+
+    // Write the data to the temporary file, only its envelope if the frames are over budget.
+    std::vector<std::size_t> kept = this->detail_indices(x.size(), &y, room);
+    std::vector<std::size_t> breaks;
+    if (!this->select_finite(x.size(), kept, breaks, x, y)) {
+        std::cerr << "Error: All the values are non-finite. Cannot plot.\n";
+        file.close();
+        this->discard_tmpfile(filename);
+        return *this;
+    }
+    const std::size_t count = kept.empty() ? x.size() : kept.size();
+    for (size_t k = 0, gap = 0; k < count; ++k) {
+        const size_t i = kept.empty() ? k : kept[k];
+        // An empty line breaks the line where non-finite values have been dropped.
+        if ((gap < breaks.size()) && (breaks[gap] == k)) {
+            file << '\n';
+            ++gap;
+        }
+        if (!(file << x[i] << " " << y[i] << '\n')) {
+            std::cerr << "Error: Failed to write data to the temporary file: " << filename << '\n';
+            file.close();
+            return *this;
+        }
+        if (!this->report_upload(k + 1, count)) {
+            file.close();
+            this->discard_tmpfile(filename);
+            return *this;
+        }
+    }
+
+    // Flush the file buffer and close the file
+    file.flush();
+    if (file.fail()) {
+        std::cerr << "Error: Failed to flush data to the temporary file: " << filename << '\n';
+        file.close();
+        return *this;
+    }
+    file.close();
+
+    // Check if the file is available for reading
+    if (!gpcpp::Gnuplot::file_ready(filename)) {
+        std::cerr << "Error: File " << filename << " is not available for reading.\n";
+        return *this;
+    }
+    std::ostringstream oss;
+    // Determine whether to use 'plot' or 'replot' based on the current plot state
+    oss << ((nplots > 0 && two_dim) ? "replot" : "plot");
+    // Specify the file and columns for the Gnuplot command
+    oss << " \"" << filename << "\" using 1:2";
+    // Add a title or specify 'notitle' if no title is provided
+    oss << (title.empty() ? " notitle" : " title \"" + title + "\"");
+    // Specify the plot style or smoothing option.
+    if (smooth_type == smooth_type_t::none) {
+        oss << " with " << plot_type_to_string(plot_type);
+    } else {
+        oss << " smooth " << smooth_type_to_string(smooth_type);
+    }
+    // Include line color if it is specified.
+    if (line_color.is_set()) {
+        oss << " lc rgbcolor \"" << line_color.to_string() << "\"";
+    }
+    // Add line style options only if the plot style supports lines.
+    if (is_line_type(plot_type)) {
+        // Add line width if specified.
+        if (line_width > 0) {
+            oss << " lw " << line_width;
+        }
+        // Add line style if specified.
+        if (!line_type.empty()) {
+            oss << " " << line_type;
+        }
+    }
+    // Add point style and size only if the plot style supports points.
+    if (is_point_type(plot_type)) {
+        // Add point style if specified.
+        oss << " pt " << point_type_to_string(point_type);
+        // Add point size if specified.
+        if (point_size > 0) {
+            oss << " ps " << point_size;
+        }
+    }
+    // Send the constructed command to Gnuplot for execution
+    this->send_cmd(oss.str());
+    if (spatial.enabled) {
+        this->index_series(x, y, static_cast<const Y *>(nullptr));
+    }
+
+    return *this;
+}
+
+template <typename X, typename Y, typename E>
+auto Gnuplot::plot_xy_erorrbar(const X &x, const Y &y, const E &dy, erorrbar_type_t style, const std::string &title)
+    -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
+        return *this;
+    }
+
+    // Validate input vectors
+    if (x.empty() || y.empty() || dy.empty()) {
+        std::cerr << "Error: Input vectors are empty. Cannot plot.\n";
+        return *this;
+    }
+
+    if (x.size() != y.size() || x.size() != dy.size()) {
+        std::cerr << "Error: Mismatch between the lengths of x, y, and dy vectors.\n";
+        return *this;
+    }
+    if (!this->report_upload(0, x.size())) {
+        return *this;
+    }
+
+    // Create a temporary file for storing the data
+    std::ofstream file;
+    std::string filename = this->create_tmpfile(file);
+    if (filename.empty()) {
+        std::cerr << "Error: Failed to create a temporary file.\n";
+        return *this;
+    }
+
+    // Write the data to the temporary file
+    std::vector<std::size_t> kept, breaks;
+    if (!this->select_finite(x.size(), kept, breaks, x, y, dy)) {
+        std::cerr << "Error: All the values are non-finite. Cannot plot.\n";
+        file.close();
+        this->discard_tmpfile(filename);
+        return *this;
+    }
+    const std::size_t count = kept.empty() ? x.size() : kept.size();
+    for (size_t k = 0, gap = 0; k < count; ++k) {
+        const size_t i = kept.empty() ? k : kept[k];
+        // An empty line breaks the line where non-finite values have been dropped.
+        if ((gap < breaks.size()) && (breaks[gap] == k)) {
+            file << '\n';
+            ++gap;
+        }
+        if (!(file << x[i] << " " << y[i] << " " << dy[i] << '\n')) {
+            std::cerr << "Error: Failed to write data to the temporary file: " << filename << '\n';
+            file.close();
+            return *this;
+        }
+        if (!this->report_upload(k + 1, count)) {
+            file.close();
+            this->discard_tmpfile(filename);
+            return *this;
+        }
+    }
+
+    // Flush the file buffer and close the file
+    file.flush();
+    if (file.fail()) {
+        std::cerr << "Error: Failed to flush data to the temporary file: " << filename << '\n';
+        file.close();
+        return *this;
+    }
+    file.close();
+
+    // Check if the file is available for reading
+    if (!gpcpp::Gnuplot::file_ready(filename)) {
+        std::cerr << "Error: File " << filename << " is not available for reading.\n";
+        return *this;
+    }
+
+    std::ostringstream oss;
+
+    // Determine whether to use 'plot' or 'replot' based on the current plot state
+    oss << ((nplots > 0 && two_dim) ? "replot " : "plot ");
+
+    // Specify the file and columns for the Gnuplot command
+    oss << "\"" << filename << "\" using 1:2:3 with " << errorbars_to_string(style) << " ";
+
+    // Add a title or specify 'notitle' if no title is provided
+    oss << (title.empty() ? " notitle " : " title \"" + title + "\" ");
+
+    // Include line color if it is specified.
+    if (line_color.is_set()) {
+        oss << " lc rgbcolor \"" << line_color.to_string() << "\"";
+    }
+
+    // Add line width if specified.
+    if (line_width > 0) {
+        oss << " lw " << line_width;
+    }
+    // Add line style if specified.
+    if (!line_type.empty()) {
+        oss << " " << line_type;
+    }
+
+    // Add point style if specified.
+    oss << " pt " << point_type_to_string(point_type);
+    // Add point size if specified.
+    if (point_size > 0) {
+        oss << " ps " << point_size;
+    }
+
+    // Send the constructed command to Gnuplot for execution
+    this->send_cmd(oss.str());
+
+    return *this;
+}
+
+template <typename X, typename Y, typename C>
+auto Gnuplot::plot_xy_color(const X &x, const Y &y, const C &colors, color_mode_t mode, const std::string &title)
+    -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
+        return *this;
+    }
+
+    // Validate input vectors
+    if (x.empty() || y.empty() || colors.empty()) {
+        std::cerr << "Error: Input vectors are empty. Cannot plot.\n";
+        return *this;
+    }
+
+    if (x.size() != y.size() || x.size() != colors.size()) {
+        std::cerr << "Error: Mismatch between the lengths of x, y, and colors vectors.\n";
+        return *this;
+    }
+
+    // Upload the points and their colors as a single binary dataset.
+    dataset_t dataset = this->write_dataset(x.size(), x, y, colors);
+    if (!dataset.is_valid()) {
+        return *this;
+    }
+
+    std::ostringstream oss;
+    // Determine whether to use 'plot' or 'replot' based on the current plot state
+    oss << ((nplots > 0 && two_dim) ? "replot " : "plot ");
+    // Specify the dataset and columns for the Gnuplot command
+    oss << dataset.get_declaration() << " using 1:2:3";
+    // Add a title or specify 'notitle' if no title is provided
+    oss << (title.empty() ? " notitle" : " title \"" + title + "\"");
+    // Per-point colors are only meaningful for points.
+    oss << " with " << (is_point_type(plot_type) ? plot_type_to_string(plot_type) : "points");
+    // Take the color from the third column.
+    oss << ((mode == color_mode_t::rgb) ? " lc rgb variable" : " lc palette");
+    // Add line style options only if the plot style supports lines.
+    if (is_line_type(plot_type)) {
+        // Add line width if specified.
+        if (line_width > 0) {
+            oss << " lw " << line_width;
+        }
+    }
+    // Add point style if specified.
+    oss << " pt " << point_type_to_string(point_type);
+    // Add point size if specified.
+    if (point_size > 0) {
+        oss << " ps " << point_size;
+    }
+    // Send the constructed command to Gnuplot for execution
+    this->send_cmd(oss.str());
+
+    return *this;
+}
+
+template <typename X, typename Y, typename S>
+auto Gnuplot::plot_xy_size(const X &x, const Y &y, const S &sizes, const std::string &title) -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
+        return *this;
+    }
+
+    // Validate input vectors
+    if (x.empty() || y.empty() || sizes.empty()) {
+        std::cerr << "Error: Input vectors are empty. Cannot plot.\n";
+        return *this;
+    }
+
+    if (x.size() != y.size() || x.size() != sizes.size()) {
+        std::cerr << "Error: Mismatch between the lengths of x, y, and sizes vectors.\n";
+        return *this;
+    }
+
+    // Upload the points and their sizes as a single binary dataset.
+    dataset_t dataset = this->write_dataset(x.size(), x, y, sizes);
+    if (!dataset.is_valid()) {
+        return *this;
+    }
+
+    std::ostringstream oss;
+    // Determine whether to use 'plot' or 'replot' based on the current plot state
+    oss << ((nplots > 0 && two_dim) ? "replot " : "plot ");
+    // Specify the dataset and columns for the Gnuplot command
+    oss << dataset.get_declaration() << " using 1:2:3";
+    // Add a title or specify 'notitle' if no title is provided
+    oss << (title.empty() ? " notitle" : " title \"" + title + "\"");
+    // Per-point sizes are only meaningful for points.
+    oss << " with " << (is_point_type(plot_type) ? plot_type_to_string(plot_type) : "points");
+    // Include line color if it is specified.
+    if (line_color.is_set()) {
+        oss << " lc rgbcolor \"" << line_color.to_string() << "\"";
+    }
+    // Add point style, and take the size from the third column.
+    oss << " pt " << point_type_to_string(point_type) << " ps variable";
+    // Send the constructed command to Gnuplot for execution
+    this->send_cmd(oss.str());
+
+    return *this;
+}
+
+template <typename X, typename Y, typename C, typename S>
+auto Gnuplot::plot_xy_color_size(
+    const X &x,
+    const Y &y,
+    const C &colors,
+    const S &sizes,
+    color_mode_t mode,
+    const std::string &title) -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
+        return *this;
+    }
+
+    // Validate input vectors
+    if (x.empty() || y.empty() || colors.empty() || sizes.empty()) {
+        std::cerr << "Error: Input vectors are empty. Cannot plot.\n";
+        return *this;
+    }
+
+    if (x.size() != y.size() || x.size() != colors.size() || x.size() != sizes.size()) {
+        std::cerr << "Error: Mismatch between the lengths of x, y, colors, and sizes vectors.\n";
+        return *this;
+    }
+
+    // Upload the points, their sizes and their colors as a single binary dataset.
+    // Gnuplot reads the variable point size before the variable color.
+    dataset_t dataset = this->write_dataset(x.size(), x, y, sizes, colors);
+    if (!dataset.is_valid()) {
+        return *this;
+    }
+
+    std::ostringstream oss;
+    // Determine whether to use 'plot' or 'replot' based on the current plot state
+    oss << ((nplots > 0 && two_dim) ? "replot " : "plot ");
+    // Specify the dataset and columns for the Gnuplot command
+    oss << dataset.get_declaration() << " using 1:2:3:4";
+    // Add a title or specify 'notitle' if no title is provided
+    oss << (title.empty() ? " notitle" : " title \"" + title + "\"");
+    // Per-point colors and sizes are only meaningful for points.
+    oss << " with " << (is_point_type(plot_type) ? plot_type_to_string(plot_type) : "points");
+    // Add point style, and take the size from the third column.
+    oss << " pt " << point_type_to_string(point_type) << " ps variable";
+    // Take the color from the fourth column.
+    oss << ((mode == color_mode_t::rgb) ? " lc rgb variable" : " lc palette");
+    // Send the constructed command to Gnuplot for execution
+    this->send_cmd(oss.str());
+
+    return *this;
+}
+
+template <typename T, typename Y>
+auto Gnuplot::plot_time_xy(const T &t, const Y &y, const std::string &title) -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
+        return *this;
+    }
+
+    // Validate input vectors
+    if (t.empty() || y.empty()) {
+        std::cerr << "Error: Input vectors are empty. Cannot plot.\n";
+        return *this;
+    }
+
+    if (t.size() != y.size()) {
+        std::cerr << "Error: Mismatch between the lengths of t and y vectors.\n";
+        return *this;
+    }
+
+    // Upload the timestamps as binary numbers of seconds.
+    dataset_t dataset = this->write_dataset(t.size(), epoch_seconds_view_t<T>{t}, y);
+    if (!dataset.is_valid()) {
+        return *this;
+    }
+
+    // Configure the time axis, only once.
+    if (!xtime) {
+        this->set_xtime();
+    }
+
+    std::ostringstream oss;
+    // Determine whether to use 'plot' or 'replot' based on the current plot state
+    oss << ((nplots > 0 && two_dim) ? "replot " : "plot ");
+    // Specify the dataset and columns, the expression makes gnuplot take the number of seconds as is.
+    oss << dataset.get_declaration() << " using ($1):2";
+    // Add a title or specify 'notitle' if no title is provided
+    oss << (title.empty() ? " notitle" : " title \"" + title + "\"");
+    // Specify the plot style or smoothing option.
+    if (smooth_type == smooth_type_t::none) {
+        oss << " with " << plot_type_to_string(plot_type);
+    } else {
+        oss << " smooth " << smooth_type_to_string(smooth_type);
+    }
+    // Include line color if it is specified.
+    if (line_color.is_set()) {
+        oss << " lc rgbcolor \"" << line_color.to_string() << "\"";
+    }
+    // Add line style options only if the plot style supports lines.
+    if (is_line_type(plot_type)) {
+        // Add line width if specified.
+        if (line_width > 0) {
+            oss << " lw " << line_width;
+        }
+        // Add line style if specified.
+        if (!line_type.empty()) {
+            oss << " " << line_type;
+        }
+    }
+    // Add point style and size only if the plot style supports points.
+    if (is_point_type(plot_type)) {
+        // Add point style if specified.
+        oss << " pt " << point_type_to_string(point_type);
+        // Add point size if specified.
+        if (point_size > 0) {
+            oss << " ps " << point_size;
+        }
+    }
+    // Send the constructed command to Gnuplot for execution
+    this->send_cmd(oss.str());
+
+    return *this;
+}
+
+template <typename X, typename Y, typename Z>
+auto Gnuplot::plot_xyz(const X &x, const Y &y, const Z &z, const std::string &title) -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
+        return *this;
+    }
+
+    // Validate input vectors
+    if (x.empty() || y.empty() || z.empty()) {
+        std::cerr << "Error: Input vectors are empty. Cannot plot.\n";
+        return *this;
+    }
+
+    if (x.size() != y.size() || x.size() != z.size()) {
+        std::cerr << "Error: Mismatch between the lengths of x, y, and z vectors.\n";
+        return *this;
+    }
+
+    // Make room for the data, about 13 characters per value.
+    const double room = this->reserve_storage(x.size() * 3 * 13);
+    if (!(room > 0) || !this->report_upload(0, x.size())) {
+        return *this;
+    }
+
+    // Create a temporary file for storing the data
+    std::ofstream file;
+    std::string filename = this->create_tmpfile(file);
+    if (filename.empty()) {
+        std::cerr << "Error: Failed to create a temporary file.\n";
+        return *this;
+    }
+
+    // Write the data to the temporary file, only some of the records if the frames are over budget.
+    std::vector<std::size_t> kept = this->detail_indices(x.size(), static_cast<const Z *>(nullptr), room);
+    std::vector<std::size_t> breaks;
+    if (!this->select_finite(x.size(), kept, breaks, x, y, z)) {
+        std::cerr << "Error: All the values are non-finite. Cannot plot.\n";
+        file.close();
+        this->discard_tmpfile(filename);
+        return *this;
+    }
+    const std::size_t count = kept.empty() ? x.size() : kept.size();
+    for (size_t k = 0, gap = 0; k < count; ++k) {
+        const size_t i = kept.empty() ? k : kept[k];
+        // An empty line breaks the line where non-finite values have been dropped.
+        if ((gap < breaks.size()) && (breaks[gap] == k)) {
+            file << '\n';
+            ++gap;
+        }
+        if (!(file << x[i] << " " << y[i] << " " << z[i] << '\n')) {
+            std::cerr << "Error: Failed to write data to the temporary file: " << filename << '\n';
+            file.close();
+            return *this;
+        }
+        if (!this->report_upload(k + 1, count)) {
+            file.close();
+            this->discard_tmpfile(filename);
+            return *this;
+        }
+    }
+
+    // Flush the file buffer and close the file
+    file.flush();
+    if (file.fail()) {
+        std::cerr << "Error: Failed to flush data to the temporary file: " << filename << '\n';
+        file.close();
+        return *this;
+    }
+    file.close();
+
+    // Check if the file is available for reading
+    if (!gpcpp::Gnuplot::file_ready(filename)) {
+        std::cerr << "Error: File " << filename << " is not available for reading.\n";
+        return *this;
+    }
+
+    std::ostringstream oss;
+
+    // Determine whether to use 'splot' or 'replot' based on the current plot state
+    oss << ((nplots > 0 && !two_dim) ? "replot" : "splot");
+
+    // Specify the file and columns for the Gnuplot command
+    oss << " \"" << filename << "\" using 1:2:3";
+
+    // Add a title or specify 'notitle' if no title is provided
+    oss << (title.empty() ? " notitle" : " title \"" + title + "\"");
+
+    // Specify the plot style or smoothing option.
+    if (smooth_type == smooth_type_t::none) {
+        oss << " with " << plot_type_to_string(plot_type);
+    } else {
+        oss << " smooth " << smooth_type_to_string(smooth_type);
+    }
+
+    // Include line color if it is specified.
+    if (line_color.is_set()) {
+        oss << " lc rgbcolor \"" << line_color.to_string() << "\"";
+    }
+
+    // Add line style options only if the plot style supports lines.
+    if (is_line_type(plot_type)) {
+        // Add line width if specified.
+        if (line_width > 0) {
+            oss << " lw " << line_width;
+        }
+        // Add line style if specified.
+        if (!line_type.empty()) {
+            oss << " " << line_type;
+        }
+    }
+
+    // Add point style and size only if the plot style supports points.
+    if (is_point_type(plot_type)) {
+        // Add point style if specified.
+        oss << " pt " << point_type_to_string(point_type);
+        // Add point size if specified.
+        if (point_size > 0) {
+            oss << " ps " << point_size;
+        }
+    }
+
+    // Send the constructed command to Gnuplot for execution
+    this->send_cmd(oss.str());
+    if (spatial.enabled) {
+        this->index_series(x, y, &z);
+    }
+
+    return *this;
+}
+
+template <typename X, typename Y, typename Z>
+auto Gnuplot::plot_3d_grid(const X &x, const Y &y, const Z &z, const std::string &title) -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
+        return *this;
+    }
+
+    // Validate input dimensions
+    if (x.empty() || y.empty() || z.empty()) {
+        std::cerr << "Error: Input vectors must not be empty.\n";
+        return *this;
+    }
+    if (z.size() != x.size() || z[0].size() != y.size()) {
+        std::cerr << "Error: Dimensions of z must match sizes of x and y.\n";
+        return *this;
+    }
+    const std::size_t count = x.size() * y.size();
+    if (!this->report_upload(0, count)) {
+        return *this;
+    }
+
+    // Create a temporary file for storing the grid data
+    std::ofstream file;
+    std::string filename = this->create_tmpfile(file);
+    if (filename.empty()) {
+        std::cerr << "Error: Failed to create a temporary file.\n";
+        return *this;
+    }
+
+    // Write the grid data to the temporary file
+    for (size_t i = 0; i < x.size(); ++i) {
+        for (size_t j = 0; j < y.size(); ++j) {
+            if (!(file << x[i] << " " << y[j] << " " << z[i][j] << '\n')) {
+                std::cerr << "Error: Failed to write data to the temporary file: " << filename << '\n';
+                file.close();
+                return *this;
+            }
+            if (!this->report_upload(i * y.size() + j + 1, count)) {
+                file.close();
+                this->discard_tmpfile(filename);
+                return *this;
+            }
+        }
+        file << "\n"; // Separate rows for Gnuplot
+    }
+
+    // Flush and close the file
+    file.flush();
+    if (file.fail()) {
+        std::cerr << "Error: Failed to flush data to the temporary file: " << filename << '\n';
+        file.close();
+        return *this;
+    }
+    file.close();
+
+    // Check if the file is available for reading
+    if (!gpcpp::Gnuplot::file_ready(filename)) {
+        std::cerr << "Error: File " << filename << " is not available for reading.\n";
+        return *this;
+    }
+
+    std::ostringstream oss;
+
+    // Determine whether to use 'splot' or 'replot' based on the current plot state
+    oss << ((nplots > 0 && !two_dim) ? "replot" : "splot");
+
+    // Specify the file and columns for the Gnuplot command
+    oss << " \"" << filename << "\" using 1:2:3";
+
+    // Add a title or specify 'notitle' if no title is provided
+    oss << (title.empty() ? " notitle" : " title \"" + title + "\"");
+
+    // Specify the plot style or smoothing option.
+    if (smooth_type == smooth_type_t::none) {
+        oss << " with " << plot_type_to_string(plot_type);
+    } else {
+        oss << " smooth " << smooth_type_to_string(smooth_type);
+    }
+
+    // Include line color if it is specified.
+    if (line_color.is_set()) {
+        oss << " lc rgbcolor \"" << line_color.to_string() << "\"";
+    }
+
+    // Add line style options only if the plot style supports lines.
+    if (is_line_type(plot_type)) {
+        // Add line width if specified.
+        if (line_width > 0) {
+            oss << " lw " << line_width;
+        }
+        // Add line style if specified.
+        if (!line_type.empty()) {
+            oss << " " << line_type;
+        }
+    }
+
+    // Add point style and size only if the plot style supports points.
+    if (is_point_type(plot_type)) {
+        // Add point style if specified.
+        oss << " pt " << point_type_to_string(point_type);
+        // Add point size if specified.
+        if (point_size > 0) {
+            oss << " ps " << point_size;
+        }
+    }
+
+    // Send the constructed command to Gnuplot for execution
+    this->send_cmd(oss.str());
+    return *this;
+}
+
+template <typename X, typename... Columns>
+auto Gnuplot::upload(const X &x, const Columns &...columns) -> dataset_t
+{
+    // Check that all the columns have the same size.
+    const std::size_t sizes[] = {x.size(), static_cast<std::size_t>(columns.size())...};
+    for (std::size_t size : sizes) {
+        if (size != x.size()) {
+            std::cerr << "Error: The columns must have the same size. Cannot upload.\n";
+            return dataset_t();
+        }
+    }
+    if (x.size() == 0) {
+        std::cerr << "Error: The columns are empty. Cannot upload.\n";
+        return dataset_t();
+    }
+    return this->write_dataset(x.size(), x, columns...);
+}
+
+template <typename F>
+auto Gnuplot::plot_function(
+    F f,
+    double xmin,
+    double xmax,
+    double tolerance,
+    const std::string &title,
+    std::size_t max_points) -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
+        return *this;
+    }
+
+    // Validate the interval and the tolerance.
+    if (!std::isfinite(xmin) || !std::isfinite(xmax) || !(xmin < xmax)) {
+        std::cerr << "Error: Invalid interval [" << xmin << ", " << xmax << "]. Cannot plot.\n";
+        return *this;
+    }
+    if (!(tolerance > 0)) {
+        std::cerr << "Error: The tolerance must be positive. Cannot plot.\n";
+        return *this;
+    }
+
+    // Sample the function, and upload only the resulting points.
+    const sampled_function_t samples = sample_adaptive(f, xmin, xmax, tolerance, max_points);
+    return this->plot_samples(samples, title);
+}
+
+template <typename F>
+auto Gnuplot::plot_function_samples(F f, double xmin, double xmax, std::size_t samples, const std::string &title)
+    -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
+        return *this;
+    }
+
+    // Validate the interval and the number of points.
+    if (!std::isfinite(xmin) || !std::isfinite(xmax) || !(xmin < xmax)) {
+        std::cerr << "Error: Invalid interval [" << xmin << ", " << xmax << "]. Cannot plot.\n";
+        return *this;
+    }
+    if (samples < 2) {
+        std::cerr << "Error: At least 2 samples are needed. Cannot plot.\n";
+        return *this;
+    }
+
+    return this->plot_samples(sample_uniform(f, xmin, xmax, samples), title);
+}
+
+template <typename X, typename Y, typename DX, typename DY>
+auto Gnuplot::plot_vectors(
+    const X &x,
+    const Y &y,
+    const DX &dx,
+    const DY &dy,
+    const std::string &title,
+    std::size_t max_arrows,
+    vector_sampling_t sampling) -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
+        return *this;
+    }
+
+    // Validate input vectors
+    if (x.size() == 0) {
+        std::cerr << "Error: Input vectors are empty. Cannot plot.\n";
+        return *this;
+    }
+    if ((x.size() != y.size()) || (x.size() != dx.size()) || (x.size() != dy.size())) {
+        std::cerr << "Error: Mismatch between the lengths of x, y, dx, and dy vectors.\n";
+        return *this;
+    }
+
+    // Choose the arrows to draw, and upload only those.
+    std::vector<std::size_t> kept;
+    const bool reduced = subsample_vectors(
+        x.size(), x, y, static_cast<const X *>(nullptr), dx, dy, static_cast<const DX *>(nullptr), max_arrows,
+        sampling, kept);
+    if (reduced && kept.empty()) {
+        std::cerr << "Error: All the arrows are non-finite. Cannot plot.\n";
+        return *this;
+    }
+    const dataset_t dataset =
+        !reduced ? this->write_dataset(x.size(), x, y, dx, dy)
+                 : this->write_dataset(
+                       kept.size(), indexed_column(x, kept), indexed_column(y, kept), indexed_column(dx, kept),
+                       indexed_column(dy, kept));
+    return this->plot_vector_dataset(dataset, false, title);
+}
+
+template <typename X, typename Y, typename Z, typename DX, typename DY, typename DZ>
+auto Gnuplot::plot_vectors_3d(
+    const X &x,
+    const Y &y,
+    const Z &z,
+    const DX &dx,
+    const DY &dy,
+    const DZ &dz,
+    const std::string &title,
+    std::size_t max_arrows,
+    vector_sampling_t sampling) -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
+        return *this;
+    }
+
+    // Validate input vectors
+    if (x.size() == 0) {
+        std::cerr << "Error: Input vectors are empty. Cannot plot.\n";
+        return *this;
+    }
+    const std::size_t sizes[] = {y.size(), z.size(), dx.size(), dy.size(), dz.size()};
+    for (std::size_t size : sizes) {
+        if (size != x.size()) {
+            std::cerr << "Error: Mismatch between the lengths of x, y, z, dx, dy, and dz vectors.\n";
+            return *this;
+        }
+    }
+
+    // Choose the arrows to draw, and upload only those.
+    std::vector<std::size_t> kept;
+    const bool reduced = subsample_vectors(x.size(), x, y, &z, dx, dy, &dz, max_arrows, sampling, kept);
+    if (reduced && kept.empty()) {
+        std::cerr << "Error: All the arrows are non-finite. Cannot plot.\n";
+        return *this;
+    }
+    const dataset_t dataset =
+        !reduced ? this->write_dataset(x.size(), x, y, z, dx, dy, dz)
+                 : this->write_dataset(
+                       kept.size(), indexed_column(x, kept), indexed_column(y, kept), indexed_column(z, kept),
+                       indexed_column(dx, kept), indexed_column(dy, kept), indexed_column(dz, kept));
+    return this->plot_vector_dataset(dataset, true, title);
+}
+
+template <typename T, typename P>
+auto Gnuplot::plot_candles(
+    const T &timestamps,
+    const P &prices,
+    double bar_interval,
+    const std::string &title,
+    candle_style_t style) -> Gnuplot &
+{
+    // Check if the Gnuplot session is ready
+    if (!this->is_ready()) {
+        std::cerr << "Error: Invalid Gnuplot session. Cannot plot.\n";
+        return *this;
+    }
+
+    // Validate input vectors
+    if (timestamps.size() == 0) {
+        std::cerr << "Error: Input vectors are empty. Cannot plot.\n";
+        return *this;
+    }
+    if (timestamps.size() != prices.size()) {
+        std::cerr << "Error: Mismatch between the lengths of timestamps and prices vectors.\n";
+        return *this;
+    }
+    if (!std::isfinite(bar_interval) || !(bar_interval > 0)) {
+        std::cerr << "Error: The bar interval must be positive. Cannot plot.\n";
+        return *this;
+    }
+
+    // Aggregate the ticks, and upload only the bars.
+    const ohlc_bars_t bars = aggregate_ohlc(timestamps, prices, bar_interval);
+    if (bars.size() == 0) {
+        std::cerr << "Error: The timestamps must be finite and in ascending order. Cannot plot.\n";
+        return *this;
+    }
+    const dataset_t dataset = this->write_dataset(bars.size(), bars.time, bars.open, bars.low, bars.high, bars.close);
+    return this->plot_candle_dataset(dataset, bar_interval, title, style);
+}
+
+template <typename... Columns>
+auto Gnuplot::write_dataset(std::size_t rows, const Columns &...columns) -> dataset_t
+{
+    // Number of records buffered before each write.
+    const std::size_t chunk_rows = 4096;
+    // Number of columns of each record.
+    const std::size_t ncolumns = sizeof...(Columns);
+
+    // Without binary support, the values are written as text.
+    const bool binary = (transport != transport_t::text_file);
+
+    // Make room for the data, with fewer records if it does not fit.
+    const double room = this->reserve_storage(rows * ncolumns * (binary ? sizeof(double) : 24));
+    const std::size_t count =
+        (room >= 1.0) ? rows : (std::min)(rows, static_cast<std::size_t>(static_cast<double>(rows) * room));
+    if ((count == 0) || !this->report_upload(0, count)) {
+        return dataset_t();
+    }
+
+    // Create a temporary file for storing the data
+    std::ofstream file;
+    std::string filename = this->create_tmpfile(file, binary);
+    if (filename.empty()) {
+        std::cerr << "Error: Failed to create a temporary file.\n";
+        return dataset_t();
+    }
+
+    // Write the records in chunks, converting every value to double. The records kept to fit
+    // within the storage budget are evenly spread.
+    const double stride = static_cast<double>(rows) / static_cast<double>(count);
+    std::vector<double> buffer;
+    std::vector<std::size_t> breaks;
+    nonfinite_splitter_t splitter(nonfinite, ncolumns);
+    buffer.reserve((std::min)(count, chunk_rows) * ncolumns);
+    for (std::size_t k = 0; k < count; ++k) {
+        const std::size_t i   = (count == rows) ? k : static_cast<std::size_t>(static_cast<double>(k) * stride);
+        const double record[] = {static_cast<double>(columns[i])...};
+        buffer.insert(buffer.end(), record, record + ncolumns);
+        if ((buffer.size() == chunk_rows * ncolumns) || (k + 1 == count)) {
+            splitter.split(buffer, breaks);
+            if (!Gnuplot::write_records(file, buffer, ncolumns, binary, breaks)) {
+                std::cerr << "Error: Failed to write data to the temporary file: " << filename << '\n';
+                file.close();
+                return dataset_t();
+            }
+            buffer.clear();
+            // Stop here if the upload has been cancelled, leaving nothing behind.
+            if (!this->report_upload(k + 1, count)) {
+                file.close();
+                this->discard_tmpfile(filename);
+                return dataset_t();
+            }
+        }
+    }
+
+    // Flush the file buffer and close the file
+    file.flush();
+    if (file.fail()) {
+        std::cerr << "Error: Failed to flush data to the temporary file: " << filename << '\n';
+        file.close();
+        return dataset_t();
+    }
+    file.close();
+
+    // Check that some records are left.
+    if (splitter.get_rows() == 0) {
+        std::cerr << "Error: All the records hold non-finite values. Cannot upload.\n";
+        this->discard_tmpfile(filename);
+        return dataset_t();
+    }
+
+    // Check if the file is available for reading
+    if (!gpcpp::Gnuplot::file_ready(filename)) {
+        std::cerr << "Error: File " << filename << " is not available for reading.\n";
+        return dataset_t();
+    }
+    dataset_t dataset(filename, ncolumns, splitter.get_rows(), binary);
+    dataset.segments = splitter.get_segments();
+    return dataset;
+}
+
+template <typename X, typename Y, typename Z>
+void Gnuplot::index_series(const X &x, const Y &y, const Z *z)
+{
+    // The copies let the caller release its data while the index is being built.
+    std::vector<double> xs(x.size()), ys(y.size()), zs((z != nullptr) ? z->size() : 0);
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        xs[i] = static_cast<double>(x[i]);
+        ys[i] = static_cast<double>(y[i]);
+    }
+    for (std::size_t i = 0; i < zs.size(); ++i) {
+        zs[i] = static_cast<double>((*z)[i]);
+    }
+    spatial.series.push_back(build_kd_tree_async(std::move(xs), std::move(ys), std::move(zs)));
+}
+
+template <typename... Columns>
+auto Gnuplot::select_finite(
+    std::size_t rows,
+    std::vector<std::size_t> &selected,
+    std::vector<std::size_t> &breaks,
+    const Columns &...columns) const -> bool
+{
+    breaks.clear();
+    if (nonfinite == nonfinite_policy_t::passthrough) {
+        return true;
+    }
+    // Most data is finite, and only needs the scan.
+    const std::vector<unsigned char> flags = nonfinite_rows(rows, columns...);
+    if (flags.empty()) {
+        return true;
+    }
+    drop_nonfinite_rows(flags, nonfinite, selected, breaks);
+    return !selected.empty();
+}
+
+template <typename Y>
+auto Gnuplot::detail_indices(std::size_t n, const Y *y, double room) const -> std::vector<std::size_t>
+{
+    std::vector<std::size_t> kept;
+    // Short series are always written in full, unless they do not fit within the storage budget.
+    std::size_t target =
+        (std::max)(std::size_t{1024}, static_cast<std::size_t>(std::ceil(static_cast<double>(n) * budget.applied)));
+    if (room < 1.0) {
+        target =
+            (std::min)(target, (std::max)(std::size_t{1}, static_cast<std::size_t>(static_cast<double>(n) * room)));
+    }
+    if (target >= n) {
+        return kept;
+    }
+    if (y == nullptr) {
+        const std::size_t stride = (n + target - 1) / target;
+        for (std::size_t i = 0; i < n; i += stride) {
+            kept.push_back(i);
+        }
+        return kept;
+    }
+    // Each bucket keeps its minimum and its maximum, in their original order.
+    const std::size_t buckets = (std::max)(target / 2, std::size_t{1});
+    const std::size_t size    = (n + buckets - 1) / buckets;
+    kept.reserve(2 * buckets);
+    for (std::size_t begin = 0; begin < n; begin += size) {
+        const std::size_t end = (std::min)(begin + size, n);
+        std::size_t lo = begin, hi = begin;
+        for (std::size_t i = begin + 1; i < end; ++i) {
+            if ((*y)[i] < (*y)[lo]) {
+                lo = i;
+            }
+            if ((*y)[i] > (*y)[hi]) {
+                hi = i;
+            }
+        }
+        kept.push_back((std::min)(lo, hi));
+        if (lo != hi) {
+            kept.push_back((std::max)(lo, hi));
+        }
+    }
+    return kept;
+}
+
+#if defined(GPCPP_COMPILED_LIB)
+/// @brief Declares, or defines when `prefix` is empty, the instantiations compiled into the library.
+/// @param prefix Either `extern` or nothing.
+/// @param T The type of the values of the containers.
+#define GPCPP_TEMPLATE_INSTANCES(prefix, T)                                                                          \
+    prefix template auto Gnuplot::plot_x(const std::vector<T> &, const std::string &) -> Gnuplot &;                 \
+    prefix template auto Gnuplot::plot_x(const std::vector<std::vector<T>> &, const std::vector<std::string> &)     \
+        -> Gnuplot &;                                                                                                \
+    prefix template auto Gnuplot::plot_xy(const std::vector<T> &, const std::vector<T> &, const std::string &)      \
+        -> Gnuplot &;                                                                                                \
+    prefix template auto Gnuplot::plot_xy_erorrbar(                                                                 \
+        const std::vector<T> &, const std::vector<T> &, const std::vector<T> &, erorrbar_type_t, const std::string &) \
+        -> Gnuplot &;                                                                                                \
+    prefix template auto Gnuplot::plot_xy_color(                                                                    \
+        const std::vector<T> &, const std::vector<T> &, const std::vector<T> &, color_mode_t, const std::string &)   \
+        -> Gnuplot &;                                                                                                \
+    prefix template auto Gnuplot::plot_xy_size(                                                                     \
+        const std::vector<T> &, const std::vector<T> &, const std::vector<T> &, const std::string &) -> Gnuplot &;  \
+    prefix template auto Gnuplot::plot_xy_color_size(                                                               \
+        const std::vector<T> &, const std::vector<T> &, const std::vector<T> &, const std::vector<T> &,             \
+        color_mode_t, const std::string &) -> Gnuplot &;                                                             \
+    prefix template auto Gnuplot::plot_xyz(                                                                         \
+        const std::vector<T> &, const std::vector<T> &, const std::vector<T> &, const std::string &) -> Gnuplot &;  \
+    prefix template auto Gnuplot::plot_3d_grid(                                                                     \
+        const std::vector<T> &, const std::vector<T> &, const std::vector<std::vector<T>> &, const std::string &)   \
+        -> Gnuplot &;                                                                                                \
+    prefix template auto Gnuplot::plot_vectors(                                                                     \
+        const std::vector<T> &, const std::vector<T> &, const std::vector<T> &, const std::vector<T> &,             \
+        const std::string &, std::size_t, vector_sampling_t) -> Gnuplot &;                                           \
+    prefix template auto Gnuplot::plot_vectors_3d(                                                                  \
+        const std::vector<T> &, const std::vector<T> &, const std::vector<T> &, const std::vector<T> &,             \
+        const std::vector<T> &, const std::vector<T> &, const std::string &, std::size_t, vector_sampling_t)        \
+        -> Gnuplot &;                                                                                                \
+    prefix template auto Gnuplot::plot_candles(                                                                     \
+        const std::vector<T> &, const std::vector<T> &, double, const std::string &, candle_style_t) -> Gnuplot &;  \
+    prefix template auto Gnuplot::upload(const std::vector<T> &, const std::vector<T> &) -> dataset_t;
+
+// The users of the compiled library do not instantiate these again.
+GPCPP_TEMPLATE_INSTANCES(extern, double)
+GPCPP_TEMPLATE_INSTANCES(extern, float)
+#endif
+
+} // namespace gpcpp
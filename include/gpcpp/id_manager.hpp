@@ -3,50 +3,149 @@
 
 #pragma once
 
-#include <unordered_set>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h> // for _BitScanForward64
+#endif
 
 namespace gpcpp
 {
 
 /// @brief A class that manages unique IDs for different style types (e.g., textbox, line styles).
+/// @details IDs are tracked in a bitmap owned by each manager, so every Gnuplot session has its own
+/// numbering. Released IDs are handed out again, always starting from the lowest free one, which keeps
+/// gnuplot's style tables dense even when styles are created and dropped many times.
 class id_manager_t
 {
 private:
-    // A set to track used IDs for a particular style
-    std::unordered_set<int> used_ids;
+    /// @brief Type of a single word of the bitmap.
+    using word_t = std::uint64_t;
+
+    /// @brief Number of IDs tracked by a single word of the bitmap.
+    static constexpr std::size_t word_bits = 64;
+
+    /// @brief Bitmap of the used IDs, bit `n` is set if ID `n + 1` is in use.
+    std::vector<word_t> used_ids;
+    /// @brief Index of the first word that might contain a free bit.
+    std::size_t first_free_word{0};
+    /// @brief Number of IDs currently in use.
+    std::size_t used_count{0};
+
+    /// @brief Returns the index of the lowest zero bit of a word that is not full.
+    /// @param word The word to inspect.
+    /// @return The index of the lowest zero bit.
+    static auto lowest_zero_bit(word_t word) -> std::size_t
+    {
+        word_t free_bits = ~word;
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::size_t>(__builtin_ctzll(free_bits));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long index = 0;
+        _BitScanForward64(&index, free_bits);
+        return static_cast<std::size_t>(index);
+#else
+        std::size_t index = 0;
+        while ((free_bits & 1U) == 0) {
+            free_bits >>= 1U;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    /// @brief Converts an ID to the position of its bit inside the bitmap.
+    /// @param id The ID to convert (must be positive).
+    /// @param word The index of the word containing the bit.
+    /// @param bit The index of the bit inside the word.
+    static void locate(int id, std::size_t &word, std::size_t &bit)
+    {
+        const auto position = static_cast<std::size_t>(id - 1);
+        word                = position / word_bits;
+        bit                 = position % word_bits;
+    }
 
 public:
-    /// @brief Generates a unique ID that hasn't been used before.
-    /// @return A unique integer ID.
+    /// @brief Generates a unique ID, reusing the lowest released one if any.
+    /// @return A unique integer ID, starting from 1.
     auto generate_unique_id() -> int
     {
-        static int id = 1; // Initialize static ID counter.
-        while (used_ids.find(id) != used_ids.end()) {
-            ++id; // Increment until a unique ID is found.
+        // Skip the words that are already full.
+        while ((first_free_word < used_ids.size()) && (used_ids[first_free_word] == ~word_t(0))) {
+            ++first_free_word;
+        }
+        // Grow the bitmap if all the words are full.
+        if (first_free_word == used_ids.size()) {
+            used_ids.push_back(0);
         }
-        this->add_id(id);
-        return id;
+        const std::size_t bit = lowest_zero_bit(used_ids[first_free_word]);
+        used_ids[first_free_word] |= (word_t(1) << bit);
+        ++used_count;
+        return static_cast<int>(first_free_word * word_bits + bit + 1);
     }
 
     /// @brief Checks if an ID has been used.
     /// @param id The ID to check.
     /// @return True if the ID is already used, false otherwise.
-    auto is_used(int id) const -> bool { return used_ids.find(id) != used_ids.end(); }
+    auto is_used(int id) const -> bool
+    {
+        if (id <= 0) {
+            return false;
+        }
+        std::size_t word = 0, bit = 0;
+        locate(id, word, bit);
+        return (word < used_ids.size()) && ((used_ids[word] >> bit) & 1U);
+    }
 
     /// @brief Adds an ID to the manager's tracking set.
-    /// @param id The ID to be added.
-    /// @return True if added successfully, false if ID was already used.
+    /// @param id The ID to be added (must be positive).
+    /// @return True if added successfully, false if ID was already used or invalid.
     auto add_id(int id) -> bool
     {
-        if (is_used(id)) {
-            return false; // ID already used.
+        if ((id <= 0) || is_used(id)) {
+            return false; // ID already used, or invalid.
+        }
+        std::size_t word = 0, bit = 0;
+        locate(id, word, bit);
+        if (word >= used_ids.size()) {
+            used_ids.resize(word + 1, 0);
+        }
+        used_ids[word] |= (word_t(1) << bit);
+        ++used_count;
+        return true;
+    }
+
+    /// @brief Releases an ID, so that it can be handed out again.
+    /// @param id The ID to release.
+    /// @return True if the ID was in use and has been released, false otherwise.
+    auto release(int id) -> bool
+    {
+        if (!is_used(id)) {
+            return false;
+        }
+        std::size_t word = 0, bit = 0;
+        locate(id, word, bit);
+        used_ids[word] &= ~(word_t(1) << bit);
+        --used_count;
+        if (word < first_free_word) {
+            first_free_word = word;
         }
-        used_ids.insert(id);
         return true;
     }
 
+    /// @brief Returns the number of IDs currently in use.
+    /// @return The number of used IDs.
+    auto size() const -> std::size_t { return used_count; }
+
     /// @brief Resets the used IDs.
-    void clear() { used_ids.clear(); }
+    void clear()
+    {
+        used_ids.clear();
+        first_free_word = 0;
+        used_count      = 0;
+    }
 };
 
 } // namespace gpcpp
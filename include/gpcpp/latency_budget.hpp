@@ -0,0 +1,112 @@
+/// @file latency_budget.hpp
+/// @brief Keeps the time spent on each frame within a budget, by lowering the level of detail.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace gpcpp
+{
+
+/// @brief The time spent on a frame, split by stage.
+struct frame_timing_t {
+    double serialize_ms{0.0}; ///< Building the frame: writing the data files and formatting the commands.
+    double transfer_ms{0.0};  ///< Writing the commands of the frame to the pipe.
+    double render_ms{0.0};    ///< From the end of the transfer until gnuplot has drawn the frame.
+    double scale{1.0};        ///< The detail scale the frame was built with.
+
+    /// @brief Returns the time spent on the frame.
+    /// @return The sum of the stages, in milliseconds.
+    auto total_ms() const -> double { return serialize_ms + transfer_ms + render_ms; }
+};
+
+/// @brief Adapts the level of detail of the frames to a time budget.
+/// @details The timings of the frames are smoothed with an exponentially weighted moving average.
+/// Each frame also gives an estimate of the cost of a frame at full detail, assuming the cost
+/// grows linearly with the detail scale, which is smoothed as well. When a frame at the current
+/// scale is predicted to exceed the budget, the scale drops to the one fitting 90% of the budget;
+/// when it is predicted to take less than 60% of the budget, the scale grows back, by at most 25%
+/// per frame. Between the two thresholds the scale does not change, so it does not oscillate.
+class lod_controller_t
+{
+public:
+    /// @brief Constructor.
+    /// @param _budget_ms The time budget of a frame in milliseconds, 0 to disable the controller.
+    /// @param _min_scale The smallest detail scale, in (0, 1].
+    /// @param _alpha The weight of the latest frame in the moving average, in (0, 1].
+    lod_controller_t(double _budget_ms = 0.0, double _min_scale = 0.001, double _alpha = 0.25)
+        : budget_ms(std::max(_budget_ms, 0.0))
+        , min_scale(std::min(std::max(_min_scale, 1e-6), 1.0))
+        , alpha(std::min(std::max(_alpha, 1e-3), 1.0))
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Checks if the controller has a budget.
+    /// @return true if a budget is set, false otherwise.
+    auto is_enabled() const -> bool { return budget_ms > 0; }
+
+    /// @brief Returns the time budget of a frame.
+    /// @return The budget, in milliseconds.
+    auto get_budget() const -> double { return budget_ms; }
+
+    /// @brief Returns the current detail scale.
+    /// @return The fraction of the full detail to use, 1 for full detail.
+    auto get_scale() const -> double { return scale; }
+
+    /// @brief Returns the smoothed timings of the recent frames.
+    /// @return The average timings.
+    auto get_average() const -> const frame_timing_t & { return average; }
+
+    /// @brief Accounts for the timings of a frame, and updates the detail scale.
+    /// @param timing The timings of the frame.
+    /// @return true if the detail scale has changed, false otherwise.
+    auto update(const frame_timing_t &timing) -> bool
+    {
+        if (frames == 0) {
+            average = timing;
+        } else {
+            average.serialize_ms += alpha * (timing.serialize_ms - average.serialize_ms);
+            average.transfer_ms += alpha * (timing.transfer_ms - average.transfer_ms);
+            average.render_ms += alpha * (timing.render_ms - average.render_ms);
+        }
+        const double full = timing.total_ms() / std::max(timing.scale, min_scale);
+        full_cost         = (frames == 0) ? full : full_cost + alpha * (full - full_cost);
+        ++frames;
+        if (!this->is_enabled() || !(full_cost > 0)) {
+            return false;
+        }
+        const double predicted = full_cost * scale;
+        const double target    = 0.9 * budget_ms / full_cost;
+        const double previous  = scale;
+        if (predicted > budget_ms) {
+            scale = target;
+        } else if (predicted < 0.6 * budget_ms) {
+            scale = std::min(target, scale * 1.25);
+        }
+        scale = std::min(std::max(scale, min_scale), 1.0);
+        return std::fabs(scale - previous) > 1e-3 * previous;
+    }
+
+    /// @brief Forgets the timings, and goes back to full detail.
+    void reset()
+    {
+        scale     = 1.0;
+        frames    = 0;
+        full_cost = 0.0;
+        average   = frame_timing_t();
+    }
+
+private:
+    double budget_ms;       ///< The time budget of a frame, in milliseconds.
+    double min_scale;       ///< The smallest detail scale.
+    double alpha;           ///< The weight of the latest frame in the moving average.
+    double scale{1.0};      ///< The current detail scale.
+    std::size_t frames{0};  ///< The number of frames accounted for.
+    double full_cost{0.0};  ///< The smoothed cost of a frame at full detail, in milliseconds.
+    frame_timing_t average; ///< The smoothed timings.
+};
+
+} // namespace gpcpp
@@ -0,0 +1,596 @@
+/// @file mapped_array.hpp
+/// @brief Memory-mapped arrays stored in NumPy (.npy) or raw binary files.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__TOS_WIN__)
+#include <windows.h> // for CreateFileMapping(), MapViewOfFile()
+#elif defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>    // for open()
+#include <sys/mman.h> // for mmap(), munmap()
+#include <sys/stat.h> // for fstat()
+#include <unistd.h>   // for close()
+#endif
+
+#include "gpcpp/binary_layout.hpp"
+
+namespace gpcpp
+{
+
+/// @brief Maps a C++ arithmetic type to the corresponding binary_type_t.
+/// @tparam T The C++ type.
+template <typename T>
+struct binary_type_of;
+
+/// @cond
+template <>
+struct binary_type_of<std::int8_t> {
+    static constexpr binary_type_t value = binary_type_t::int8;
+};
+template <>
+struct binary_type_of<std::uint8_t> {
+    static constexpr binary_type_t value = binary_type_t::uint8;
+};
+template <>
+struct binary_type_of<std::int16_t> {
+    static constexpr binary_type_t value = binary_type_t::int16;
+};
+template <>
+struct binary_type_of<std::uint16_t> {
+    static constexpr binary_type_t value = binary_type_t::uint16;
+};
+template <>
+struct binary_type_of<std::int32_t> {
+    static constexpr binary_type_t value = binary_type_t::int32;
+};
+template <>
+struct binary_type_of<std::uint32_t> {
+    static constexpr binary_type_t value = binary_type_t::uint32;
+};
+template <>
+struct binary_type_of<std::int64_t> {
+    static constexpr binary_type_t value = binary_type_t::int64;
+};
+template <>
+struct binary_type_of<std::uint64_t> {
+    static constexpr binary_type_t value = binary_type_t::uint64;
+};
+template <>
+struct binary_type_of<float> {
+    static constexpr binary_type_t value = binary_type_t::float32;
+};
+template <>
+struct binary_type_of<double> {
+    static constexpr binary_type_t value = binary_type_t::float64;
+};
+/// @endcond
+
+/// @brief Read-only, strided view over an array of values.
+/// @details It provides `empty()`, `size()` and `operator[]`, so it can be passed to the plot functions
+/// in place of a container.
+/// @tparam T The type of the values.
+template <typename T>
+class array_view_t
+{
+public:
+    /// @brief Iterator over the values of the view.
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag; ///< Iterator category.
+        using value_type        = T;                         ///< Type of the values.
+        using difference_type   = std::ptrdiff_t;            ///< Type of the distance between iterators.
+        using pointer           = const T *;                 ///< Pointer to a value.
+        using reference         = const T &;                 ///< Reference to a value.
+
+        /// @brief Constructor.
+        /// @param _ptr Pointer to the current value.
+        /// @param _stride Distance between two consecutive values, in elements.
+        const_iterator(const T *_ptr, std::size_t _stride)
+            : ptr(_ptr)
+            , stride(_stride)
+        {
+            // Nothing to do.
+        }
+
+        /// @brief Returns the current value.
+        /// @return A reference to the current value.
+        auto operator*() const -> const T & { return *ptr; }
+
+        /// @brief Moves to the next value.
+        /// @return A reference to the iterator.
+        auto operator++() -> const_iterator &
+        {
+            ptr += stride;
+            return *this;
+        }
+
+        /// @brief Compares two iterators.
+        /// @param other The other iterator.
+        /// @return true if the iterators point to the same value.
+        auto operator==(const const_iterator &other) const -> bool { return ptr == other.ptr; }
+
+        /// @brief Compares two iterators.
+        /// @param other The other iterator.
+        /// @return true if the iterators point to different values.
+        auto operator!=(const const_iterator &other) const -> bool { return ptr != other.ptr; }
+
+    private:
+        const T *ptr;       ///< Pointer to the current value.
+        std::size_t stride; ///< Distance between two consecutive values, in elements.
+    };
+
+    /// @brief Constructor.
+    /// @param _data Pointer to the first value.
+    /// @param _count The number of values.
+    /// @param _stride Distance between two consecutive values, in elements.
+    array_view_t(const T *_data = nullptr, std::size_t _count = 0, std::size_t _stride = 1)
+        : data(_data)
+        , count(_count)
+        , stride(_stride)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Checks if the view is empty.
+    /// @return true if the view contains no values.
+    auto empty() const -> bool { return count == 0; }
+
+    /// @brief Returns the number of values.
+    /// @return The number of values.
+    auto size() const -> std::size_t { return count; }
+
+    /// @brief Returns the i-th value.
+    /// @param i The index of the value.
+    /// @return A reference to the value.
+    auto operator[](std::size_t i) const -> const T & { return data[i * stride]; }
+
+    /// @brief Returns an iterator to the first value.
+    /// @return The iterator.
+    auto begin() const -> const_iterator { return const_iterator(data, stride); }
+
+    /// @brief Returns an iterator past the last value.
+    /// @return The iterator.
+    auto end() const -> const_iterator { return const_iterator(data + count * stride, stride); }
+
+private:
+    const T *data;      ///< Pointer to the first value.
+    std::size_t count;  ///< The number of values.
+    std::size_t stride; ///< Distance between two consecutive values, in elements.
+};
+
+/// @brief An array stored in a file, mapped in memory without copying or parsing it.
+/// @details Supports NumPy `.npy` files (versions 1, 2 and 3) and raw binary files described by
+/// their type, shape and header size. Arrays can be accessed through typed views, or passed
+/// directly to gnuplot by means of their binary layout (see Gnuplot::plot_mapped).
+class mapped_array_t
+{
+public:
+    /// @brief Constructor.
+    mapped_array_t() = default;
+
+    /// @brief Copy constructor.
+    /// @param other The array to copy from.
+    mapped_array_t(const mapped_array_t &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The array to move from.
+    mapped_array_t(mapped_array_t &&other) noexcept { this->take(other); }
+
+    /// @brief Copy assignment operator.
+    /// @param other The array to copy from.
+    /// @return Reference to the array.
+    auto operator=(const mapped_array_t &other) -> mapped_array_t & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The array to move from.
+    /// @return Reference to the array.
+    auto operator=(mapped_array_t &&other) noexcept -> mapped_array_t &
+    {
+        if (this != &other) {
+            this->close();
+            this->take(other);
+        }
+        return *this;
+    }
+
+    /// @brief Destructor, unmaps the file.
+    ~mapped_array_t() { this->close(); }
+
+    /// @brief Maps a NumPy `.npy` file.
+    /// @param filename The name of the file.
+    /// @return true if the file was mapped and its header understood, false otherwise.
+    auto open_npy(const std::string &filename) -> bool
+    {
+        if (!this->map(filename)) {
+            return false;
+        }
+        // Check the magic string and the version.
+        const auto *bytes = static_cast<const unsigned char *>(base);
+        if ((length < 10) || (std::memcmp(bytes, "\x93NUMPY", 6) != 0)) {
+            std::cerr << "Error: File \"" << filename << "\" is not a NumPy array.\n";
+            this->close();
+            return false;
+        }
+        // Read the length of the header.
+        std::size_t header_start = 0, header_length = 0;
+        if (bytes[6] == 1) {
+            header_start  = 10;
+            header_length = static_cast<std::size_t>(bytes[8]) | (static_cast<std::size_t>(bytes[9]) << 8U);
+        } else if ((bytes[6] == 2) || (bytes[6] == 3)) {
+            header_start  = 12;
+            header_length = static_cast<std::size_t>(bytes[8]) | (static_cast<std::size_t>(bytes[9]) << 8U) |
+                            (static_cast<std::size_t>(bytes[10]) << 16U) |
+                            (static_cast<std::size_t>(bytes[11]) << 24U);
+        } else {
+            std::cerr << "Error: Unsupported NumPy format version " << static_cast<int>(bytes[6]) << ".\n";
+            this->close();
+            return false;
+        }
+        if (header_start + header_length > length) {
+            std::cerr << "Error: Truncated NumPy header in \"" << filename << "\".\n";
+            this->close();
+            return false;
+        }
+        // Parse the header dictionary.
+        const std::string header(reinterpret_cast<const char *>(bytes + header_start), header_length);
+        if (!this->parse_npy_header(header)) {
+            std::cerr << "Error: Unsupported NumPy header in \"" << filename << "\": " << header << "\n";
+            this->close();
+            return false;
+        }
+        offset = header_start + header_length;
+        return this->check_size();
+    }
+
+    /// @brief Maps a raw binary file containing an array.
+    /// @param filename The name of the file.
+    /// @param _type The type of the elements.
+    /// @param _shape The shape of the array, in row-major (C) order.
+    /// @param _offset The number of bytes to skip at the beginning of the file.
+    /// @param _endian The byte order of the elements.
+    /// @return true if the file was mapped, false otherwise.
+    auto open_raw(
+        const std::string &filename,
+        binary_type_t _type,
+        const std::vector<std::size_t> &_shape,
+        std::size_t _offset  = 0,
+        endianness_t _endian = endianness_t::native) -> bool
+    {
+        if (!this->map(filename)) {
+            return false;
+        }
+        type          = _type;
+        shape         = _shape;
+        offset        = _offset;
+        endian        = _endian;
+        fortran_order = false;
+        return this->check_size();
+    }
+
+    /// @brief Unmaps the file.
+    void close()
+    {
+        if (base != nullptr) {
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__TOS_WIN__)
+            UnmapViewOfFile(base);
+#elif defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+            munmap(base, length);
+#endif
+        }
+        base   = nullptr;
+        length = 0;
+        offset = 0;
+        shape.clear();
+        path.clear();
+    }
+
+    /// @brief Checks if a file is mapped.
+    /// @return true if a file is mapped.
+    auto is_open() const -> bool { return base != nullptr; }
+
+    /// @brief Returns the name of the mapped file.
+    /// @return The name of the file.
+    auto filename() const -> const std::string & { return path; }
+
+    /// @brief Returns the type of the elements.
+    /// @return The type of the elements.
+    auto element_type() const -> binary_type_t { return type; }
+
+    /// @brief Returns the shape of the array.
+    /// @return The size of each dimension.
+    auto get_shape() const -> const std::vector<std::size_t> & { return shape; }
+
+    /// @brief Returns the total number of elements.
+    /// @return The number of elements.
+    auto size() const -> std::size_t
+    {
+        std::size_t count = shape.empty() ? 0 : 1;
+        for (const auto &dimension : shape) {
+            count *= dimension;
+        }
+        return count;
+    }
+
+    /// @brief Returns the number of bytes preceding the data (e.g., the NumPy header).
+    /// @return The size of the header.
+    auto header_size() const -> std::size_t { return offset; }
+
+    /// @brief Returns a view over all the elements, in storage order.
+    /// @tparam T The type of the elements, it must match the type stored in the file.
+    /// @return The view, empty if the type does not match.
+    template <typename T>
+    auto view() const -> array_view_t<T>
+    {
+        if (!this->check_view<T>()) {
+            return array_view_t<T>();
+        }
+        return array_view_t<T>(this->data<T>(), this->size());
+    }
+
+    /// @brief Returns a view over a column of a two-dimensional array.
+    /// @tparam T The type of the elements, it must match the type stored in the file.
+    /// @param column The index of the column.
+    /// @return The view, empty if the type does not match or the column does not exist.
+    template <typename T>
+    auto column(std::size_t column) const -> array_view_t<T>
+    {
+        if (!this->check_view<T>()) {
+            return array_view_t<T>();
+        }
+        if ((shape.size() != 2) || (column >= shape[1])) {
+            std::cerr << "Error: Column " << column << " is not available in \"" << path << "\".\n";
+            return array_view_t<T>();
+        }
+        if (fortran_order) {
+            return array_view_t<T>(this->data<T>() + column * shape[0], shape[0]);
+        }
+        return array_view_t<T>(this->data<T>() + column, shape[0], shape[1]);
+    }
+
+    /// @brief Returns the layout of the records, so that gnuplot can read the file directly.
+    /// @details Each row of the array is a record, the header is skipped.
+    /// @return The layout, with no fields if the array cannot be read as records (e.g., Fortran order).
+    auto layout() const -> binary_layout_t
+    {
+        if (!this->is_open() || (shape.empty()) || (shape.size() > 2) || (fortran_order && (shape.size() == 2))) {
+            std::cerr << "Error: Array \"" << path << "\" cannot be read as a sequence of records.\n";
+            return binary_layout_t();
+        }
+        const std::size_t fields = (shape.size() == 2) ? shape[1] : 1;
+        return binary_layout_t(std::vector<binary_type_t>(fields, type), offset, shape[0], endian);
+    }
+
+private:
+    /// @brief Moves the state of another array into this one.
+    /// @param other The array to move from.
+    void take(mapped_array_t &other)
+    {
+        base          = other.base;
+        length        = other.length;
+        offset        = other.offset;
+        type          = other.type;
+        shape         = other.shape;
+        endian        = other.endian;
+        fortran_order = other.fortran_order;
+        path          = other.path;
+        other.base    = nullptr;
+        other.close();
+    }
+
+    /// @brief Maps the whole file in memory, read-only.
+    /// @param filename The name of the file.
+    /// @return true on success.
+    auto map(const std::string &filename) -> bool
+    {
+        this->close();
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__TOS_WIN__)
+        HANDLE file = CreateFileA(
+            filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            std::cerr << "Error: Cannot open file \"" << filename << "\".\n";
+            return false;
+        }
+        LARGE_INTEGER file_length;
+        if (!GetFileSizeEx(file, &file_length) || (file_length.QuadPart == 0)) {
+            std::cerr << "Error: Cannot map empty file \"" << filename << "\".\n";
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr) {
+            std::cerr << "Error: Cannot map file \"" << filename << "\".\n";
+            return false;
+        }
+        base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (base == nullptr) {
+            std::cerr << "Error: Cannot map file \"" << filename << "\".\n";
+            return false;
+        }
+        length = static_cast<std::size_t>(file_length.QuadPart);
+#elif defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd == -1) {
+            std::cerr << "Error: Cannot open file \"" << filename << "\".\n";
+            return false;
+        }
+        struct stat info {};
+        if ((fstat(fd, &info) != 0) || (info.st_size == 0)) {
+            std::cerr << "Error: Cannot map empty file \"" << filename << "\".\n";
+            ::close(fd);
+            return false;
+        }
+        void *address = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED) {
+            std::cerr << "Error: Cannot map file \"" << filename << "\".\n";
+            return false;
+        }
+        base   = address;
+        length = static_cast<std::size_t>(info.st_size);
+#endif
+        path = filename;
+        return true;
+    }
+
+    /// @brief Extracts the type, the order and the shape from a NumPy header.
+    /// @param header The header dictionary (e.g., "{'descr': '<f8', 'fortran_order': False, 'shape': (3,), }").
+    /// @return true if the header is supported.
+    auto parse_npy_header(const std::string &header) -> bool
+    {
+        // Parse the description of the type (e.g., '<f8').
+        std::size_t position = header.find("'descr'");
+        if (position == std::string::npos) {
+            return false;
+        }
+        position = header.find('\'', position + 7);
+        if ((position == std::string::npos) || (position + 3 >= header.size())) {
+            return false;
+        }
+        const char order = header[position + 1];
+        const char kind  = header[position + 2];
+        const int bytes  = std::atoi(header.c_str() + position + 3);
+        if (order == '>') {
+            endian = endianness_t::big;
+        } else if (order == '<') {
+            endian = endianness_t::little;
+        } else {
+            endian = endianness_t::native;
+        }
+        if ((kind == 'f') && (bytes == 4)) {
+            type = binary_type_t::float32;
+        } else if ((kind == 'f') && (bytes == 8)) {
+            type = binary_type_t::float64;
+        } else if ((kind == 'i') && (bytes == 1)) {
+            type = binary_type_t::int8;
+        } else if ((kind == 'i') && (bytes == 2)) {
+            type = binary_type_t::int16;
+        } else if ((kind == 'i') && (bytes == 4)) {
+            type = binary_type_t::int32;
+        } else if ((kind == 'i') && (bytes == 8)) {
+            type = binary_type_t::int64;
+        } else if (((kind == 'u') || (kind == 'b')) && (bytes == 1)) {
+            type = binary_type_t::uint8;
+        } else if ((kind == 'u') && (bytes == 2)) {
+            type = binary_type_t::uint16;
+        } else if ((kind == 'u') && (bytes == 4)) {
+            type = binary_type_t::uint32;
+        } else if ((kind == 'u') && (bytes == 8)) {
+            type = binary_type_t::uint64;
+        } else {
+            return false;
+        }
+        // Parse the order.
+        position = header.find("'fortran_order'");
+        if (position == std::string::npos) {
+            return false;
+        }
+        fortran_order = header.find("True", position) < header.find(',', position);
+        // Parse the shape (e.g., (1000, 3)).
+        position = header.find("'shape'");
+        if (position == std::string::npos) {
+            return false;
+        }
+        const std::size_t open_paren  = header.find('(', position);
+        const std::size_t close_paren = header.find(')', position);
+        if ((open_paren == std::string::npos) || (close_paren == std::string::npos)) {
+            return false;
+        }
+        shape.clear();
+        std::size_t start = open_paren + 1;
+        while (start < close_paren) {
+            char *end                 = nullptr;
+            const unsigned long value = std::strtoul(header.c_str() + start, &end, 10);
+            const auto consumed       = static_cast<std::size_t>(end - (header.c_str() + start));
+            if (consumed > 0) {
+                shape.push_back(static_cast<std::size_t>(value));
+                start += consumed;
+            } else {
+                ++start;
+            }
+        }
+        // A scalar has an empty shape.
+        if (shape.empty()) {
+            shape.push_back(1);
+        }
+        return true;
+    }
+
+    /// @brief Checks that the file is big enough to contain the whole array.
+    /// @return true if the file is big enough.
+    auto check_size() -> bool
+    {
+        if (offset + this->size() * binary_type_size(type) > length) {
+            std::cerr << "Error: File \"" << path << "\" is too small for the declared array.\n";
+            this->close();
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Checks that the elements can be viewed with the given type.
+    /// @tparam T The requested type.
+    /// @return true if the elements can be viewed.
+    template <typename T>
+    auto check_view() const -> bool
+    {
+        if (!this->is_open()) {
+            std::cerr << "Error: No array is mapped.\n";
+            return false;
+        }
+        if (binary_type_of<T>::value != type) {
+            std::cerr << "Error: Requested type does not match the type stored in \"" << path << "\".\n";
+            return false;
+        }
+        if ((endian != endianness_t::native) && (endian != mapped_array_t::machine_endianness())) {
+            std::cerr << "Error: Array \"" << path << "\" has a different byte order than this machine.\n";
+            return false;
+        }
+        if ((offset % alignof(T)) != 0) {
+            std::cerr << "Error: Array \"" << path << "\" is not correctly aligned.\n";
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Returns a pointer to the first element.
+    /// @tparam T The type of the elements.
+    /// @return The pointer.
+    template <typename T>
+    auto data() const -> const T *
+    {
+        return reinterpret_cast<const T *>(static_cast<const unsigned char *>(base) + offset);
+    }
+
+    /// @brief Returns the byte order of this machine.
+    /// @return Either little or big.
+    static auto machine_endianness() -> endianness_t
+    {
+        const std::uint16_t probe = 1;
+        unsigned char first       = 0;
+        std::memcpy(&first, &probe, 1);
+        return (first == 1) ? endianness_t::little : endianness_t::big;
+    }
+
+    void *base{nullptr};                        ///< The address of the mapped file.
+    std::size_t length{0};                      ///< The size of the mapped file.
+    std::size_t offset{0};                      ///< The offset of the first element.
+    binary_type_t type{binary_type_t::float64}; ///< The type of the elements.
+    std::vector<std::size_t> shape;             ///< The shape of the array.
+    endianness_t endian{endianness_t::native};  ///< The byte order of the elements.
+    bool fortran_order{false};                  ///< Whether the array is stored in column-major order.
+    std::string path;                           ///< The name of the mapped file.
+};
+
+} // namespace gpcpp
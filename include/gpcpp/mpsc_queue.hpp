@@ -0,0 +1,89 @@
+/// @file mpsc_queue.hpp
+/// @brief A lock-free queue with many producers and a single consumer.
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace gpcpp
+{
+
+/// @brief An unbounded lock-free queue, with many producers and a single consumer.
+/// @details This is the node-based queue by Dmitry Vyukov: pushing is a single atomic exchange,
+/// so producers never wait for each other, and popping needs no atomic read-modify-write. The
+/// values pushed by the same thread are popped in the order they were pushed. A push that is in
+/// progress may not be visible to the consumer yet, even if later pushes by other threads are.
+/// @tparam T The type of the values, it must be default constructible and movable.
+template <typename T>
+class mpsc_queue_t
+{
+public:
+    /// @brief Constructor, creates an empty queue.
+    mpsc_queue_t()
+        : head(new node_t())
+        , tail(head.load(std::memory_order_relaxed))
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Destructor, destroys the values still in the queue.
+    ~mpsc_queue_t()
+    {
+        while (tail != nullptr) {
+            node_t *next = tail->next.load(std::memory_order_relaxed);
+            delete tail;
+            tail = next;
+        }
+    }
+
+    /// @brief Queues cannot be copied.
+    mpsc_queue_t(const mpsc_queue_t &) = delete;
+
+    /// @brief Queues cannot be copied.
+    /// @return A reference to the queue.
+    auto operator=(const mpsc_queue_t &) -> mpsc_queue_t & = delete;
+
+    /// @brief Adds a value at the end of the queue, can be called by any thread.
+    /// @param value The value.
+    void push(T value)
+    {
+        node_t *node = new node_t();
+        node->value  = std::move(value);
+        // Link the node after the previous head, once it is the new head.
+        node_t *previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    /// @brief Removes the value at the front of the queue, must only be called by the consumer.
+    /// @param value Receives the value.
+    /// @return true if a value has been removed, false if the queue is empty.
+    auto pop(T &value) -> bool
+    {
+        node_t *next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            return false;
+        }
+        // The node of the value becomes the new (empty) tail.
+        value = std::move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+    /// @brief Checks if the queue is empty, must only be called by the consumer.
+    /// @return true if there is nothing to pop, false otherwise.
+    auto empty() const -> bool { return tail->next.load(std::memory_order_acquire) == nullptr; }
+
+private:
+    /// @brief A node of the queue.
+    struct node_t {
+        std::atomic<node_t *> next{nullptr}; ///< The next node, nullptr for the last one.
+        T value;                              ///< The value, moved out when popped.
+    };
+
+    std::atomic<node_t *> head; ///< The last node pushed, shared by the producers.
+    node_t *tail;               ///< The node before the first value, owned by the consumer.
+};
+
+} // namespace gpcpp
@@ -0,0 +1,409 @@
+/// @file multiplot.hpp
+/// @brief Describes the layout of a multiplot, and the content of its panels.
+
+#pragma once
+
+#include "gpcpp/color.hpp"
+#include "gpcpp/dataset.hpp"
+#include "gpcpp/defines.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace gpcpp
+{
+
+/// @brief The position and size of a panel, as fractions of the whole canvas.
+struct panel_geometry_t {
+    double x;      ///< The x-coordinate of the bottom-left corner.
+    double y;      ///< The y-coordinate of the bottom-left corner.
+    double width;  ///< The width of the panel.
+    double height; ///< The height of the panel.
+};
+
+/// @brief A series drawn inside a panel, referencing an already uploaded dataset.
+struct multiplot_series_t {
+    dataset_t dataset;      ///< The dataset providing the data.
+    std::string using_spec; ///< The columns to plot, as in gnuplot's `using`.
+    std::string title;      ///< The title of the series, empty for none.
+    plot_type_t type;       ///< The style of the series.
+    Color color;            ///< The color of the series, unset to use gnuplot's default.
+    double line_width;      ///< The line width, only used by styles with lines.
+
+    /// @brief Returns the series as it should appear inside a plot command.
+    /// @return the declaration of the series.
+    auto get_declaration() const -> std::string
+    {
+        std::ostringstream oss;
+        oss << dataset.get_declaration() << " using " << using_spec;
+        oss << (title.empty() ? " notitle" : " title \"" + title + "\"");
+        oss << " with " << plot_type_to_string(type);
+        if (color.is_set()) {
+            oss << " lc rgbcolor \"" << color.to_string() << "\"";
+        }
+        if (is_line_type(type) && (line_width > 0)) {
+            oss << " lw " << line_width;
+        }
+        return oss.str();
+    }
+};
+
+/// @brief A panel of a multiplot, occupying one or more cells of the grid.
+class multiplot_panel_t
+{
+public:
+    /// @brief Constructor.
+    /// @param _row The row of the top-left cell (0 is the top row).
+    /// @param _col The column of the top-left cell (0 is the left column).
+    /// @param _rowspan The number of rows covered by the panel.
+    /// @param _colspan The number of columns covered by the panel.
+    multiplot_panel_t(std::size_t _row, std::size_t _col, std::size_t _rowspan = 1, std::size_t _colspan = 1)
+        : row(_row)
+        , col(_col)
+        , rowspan(_rowspan)
+        , colspan(_colspan)
+    {
+        if ((rowspan == 0) || (colspan == 0)) {
+            throw std::invalid_argument("A panel must span at least one row and one column.");
+        }
+    }
+
+    /// @brief Sets the title of the panel.
+    /// @param _title The title.
+    /// @return A reference to the panel.
+    auto set_title(const std::string &_title) -> multiplot_panel_t &
+    {
+        title = _title;
+        return *this;
+    }
+
+    /// @brief Sets the label of the x-axis.
+    /// @param label The label.
+    /// @return A reference to the panel.
+    auto set_xlabel(const std::string &label) -> multiplot_panel_t &
+    {
+        xlabel = label;
+        return *this;
+    }
+
+    /// @brief Sets the label of the y-axis.
+    /// @param label The label.
+    /// @return A reference to the panel.
+    auto set_ylabel(const std::string &label) -> multiplot_panel_t &
+    {
+        ylabel = label;
+        return *this;
+    }
+
+    /// @brief Adds a series to the panel.
+    /// @param dataset The dataset providing the data, it can be shared with other panels.
+    /// @param using_spec The columns to plot (default is "1:2").
+    /// @param _title The title of the series (default is an empty string).
+    /// @param type The style of the series (default is lines).
+    /// @param color The color of the series (default is gnuplot's choice).
+    /// @param line_width The line width (default is 1).
+    /// @return A reference to the panel.
+    auto add_series(
+        const dataset_t &dataset,
+        const std::string &using_spec = "1:2",
+        const std::string &_title     = "",
+        plot_type_t type              = plot_type_t::lines,
+        const Color &color            = Color(),
+        double line_width             = 1.0) -> multiplot_panel_t &
+    {
+        multiplot_series_t entry = {dataset, using_spec, _title, type, color, line_width};
+        series.push_back(entry);
+        return *this;
+    }
+
+    std::size_t row;                        ///< The row of the top-left cell.
+    std::size_t col;                        ///< The column of the top-left cell.
+    std::size_t rowspan;                    ///< The number of rows covered by the panel.
+    std::size_t colspan;                    ///< The number of columns covered by the panel.
+    std::string title;                      ///< The title of the panel.
+    std::string xlabel;                     ///< The label of the x-axis.
+    std::string ylabel;                     ///< The label of the y-axis.
+    std::vector<multiplot_series_t> series; ///< The series drawn in the panel.
+};
+
+/// @brief A grid of panels, rendered by Gnuplot::plot_layout as a single batch of commands.
+/// @details Datasets are uploaded once (see Gnuplot::upload), and the same dataset can be
+/// referenced by any number of panels. With shared axes, the tic labels and the axis labels are
+/// only drawn on the outer panels, and all the panels use the same range.
+class multiplot_layout_t
+{
+public:
+    /// @brief Constructor.
+    /// @param _rows The number of rows of the grid.
+    /// @param _cols The number of columns of the grid.
+    multiplot_layout_t(std::size_t _rows, std::size_t _cols)
+        : rows(_rows)
+        , cols(_cols)
+    {
+        if ((rows == 0) || (cols == 0)) {
+            throw std::invalid_argument("A layout must have at least one row and one column.");
+        }
+    }
+
+    /// @brief Sets the title drawn on top of the whole multiplot.
+    /// @param _title The title.
+    /// @return A reference to the layout.
+    auto set_title(const std::string &_title) -> multiplot_layout_t &
+    {
+        title = _title;
+        return *this;
+    }
+
+    /// @brief Shares the x-axis among the panels of each column.
+    /// @param enable Whether the axis is shared.
+    /// @param format The format of the tic labels on the outer panels (default is gnuplot's default).
+    /// @return A reference to the layout.
+    auto set_shared_x(bool enable = true, const std::string &format = "% h") -> multiplot_layout_t &
+    {
+        shared_x = enable;
+        xformat  = format;
+        return *this;
+    }
+
+    /// @brief Shares the y-axis among the panels of each row.
+    /// @param enable Whether the axis is shared.
+    /// @param format The format of the tic labels on the outer panels (default is gnuplot's default).
+    /// @return A reference to the layout.
+    auto set_shared_y(bool enable = true, const std::string &format = "% h") -> multiplot_layout_t &
+    {
+        shared_y = enable;
+        yformat  = format;
+        return *this;
+    }
+
+    /// @brief Sets the x range used by all the panels.
+    /// @param min The minimum value.
+    /// @param max The maximum value.
+    /// @return A reference to the layout.
+    auto set_xrange(double min, double max) -> multiplot_layout_t &
+    {
+        xrange = multiplot_layout_t::format_range(min, max);
+        return *this;
+    }
+
+    /// @brief Sets the y range used by all the panels.
+    /// @param min The minimum value.
+    /// @param max The maximum value.
+    /// @return A reference to the layout.
+    auto set_yrange(double min, double max) -> multiplot_layout_t &
+    {
+        yrange = multiplot_layout_t::format_range(min, max);
+        return *this;
+    }
+
+    /// @brief Adds a panel to the layout.
+    /// @param panel The panel, it must fit inside the grid.
+    /// @return The index of the panel.
+    auto add_panel(const multiplot_panel_t &panel) -> std::size_t
+    {
+        if (((panel.row + panel.rowspan) > rows) || ((panel.col + panel.colspan) > cols)) {
+            throw std::invalid_argument("The panel does not fit inside the layout.");
+        }
+        panels.push_back(panel);
+        return panels.size() - 1;
+    }
+
+    /// @brief Returns a panel of the layout.
+    /// @param index The index of the panel.
+    /// @return A reference to the panel.
+    auto panel(std::size_t index) -> multiplot_panel_t & { return panels.at(index); }
+
+    /// @brief Returns the number of panels.
+    /// @return The number of panels.
+    auto size() const -> std::size_t { return panels.size(); }
+
+    /// @brief Computes the position and size of a panel.
+    /// @param index The index of the panel.
+    /// @return The geometry of the panel, as fractions of the canvas.
+    auto get_geometry(std::size_t index) const -> panel_geometry_t
+    {
+        const multiplot_panel_t &p = panels.at(index);
+        // Leave room for the global title at the top of the canvas.
+        const double top = title.empty() ? 1.0 : 0.95;
+        const double cw  = 1.0 / static_cast<double>(cols);
+        const double ch  = top / static_cast<double>(rows);
+        panel_geometry_t geometry{};
+        geometry.x      = static_cast<double>(p.col) * cw;
+        geometry.y      = top - static_cast<double>(p.row + p.rowspan) * ch;
+        geometry.width  = static_cast<double>(p.colspan) * cw;
+        geometry.height = static_cast<double>(p.rowspan) * ch;
+        return geometry;
+    }
+
+    /// @brief Returns the files of the datasets referenced by a panel.
+    /// @param index The index of the panel.
+    /// @return The names of the files, once each.
+    auto get_panel_filenames(std::size_t index) const -> std::vector<std::string>
+    {
+        std::vector<std::string> filenames;
+        for (const multiplot_series_t &s : panels.at(index).series) {
+            if (std::find(filenames.begin(), filenames.end(), s.dataset.filename) == filenames.end()) {
+                filenames.push_back(s.dataset.filename);
+            }
+        }
+        return filenames;
+    }
+
+    /// @brief Returns the files of the datasets referenced by the panels.
+    /// @return The names of the files, once each.
+    auto get_filenames() const -> std::vector<std::string>
+    {
+        std::vector<std::string> filenames;
+        for (std::size_t i = 0; i < panels.size(); ++i) {
+            for (const std::string &filename : this->get_panel_filenames(i)) {
+                if (std::find(filenames.begin(), filenames.end(), filename) == filenames.end()) {
+                    filenames.push_back(filename);
+                }
+            }
+        }
+        return filenames;
+    }
+
+    /// @brief Checks that every series of every panel refers to a valid dataset.
+    /// @return true if the layout can be plotted, false otherwise.
+    auto is_valid() const -> bool
+    {
+        for (const multiplot_panel_t &p : panels) {
+            for (const multiplot_series_t &s : p.series) {
+                if (!s.dataset.is_valid()) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /// @brief Returns the commands placing a panel on the canvas.
+    /// @param index The index of the panel.
+    /// @return The commands, one per line.
+    auto get_panel_placement(std::size_t index) const -> std::string
+    {
+        const panel_geometry_t geometry = this->get_geometry(index);
+        std::ostringstream oss;
+        oss << "set origin " << geometry.x << "," << geometry.y << "\n";
+        oss << "set size " << geometry.width << "," << geometry.height << "\n";
+        return oss.str();
+    }
+
+    /// @brief Returns the commands drawing a single panel, once it has been placed.
+    /// @details Every setting touched by a panel is set explicitly, so that panels do not leak
+    /// their settings into the following ones.
+    /// @param index The index of the panel.
+    /// @return The commands, one per line.
+    auto get_panel_commands(std::size_t index) const -> std::string
+    {
+        const multiplot_panel_t &p = panels.at(index);
+        // With shared axes, only the outer panels show the tic labels and the axis labels.
+        const bool show_x = !shared_x || ((p.row + p.rowspan) == rows);
+        const bool show_y = !shared_y || (p.col == 0);
+
+        std::ostringstream oss;
+        oss << (p.title.empty() ? "unset title" : "set title \"" + p.title + "\"") << "\n";
+        oss << ((p.xlabel.empty() || !show_x) ? "unset xlabel" : "set xlabel \"" + p.xlabel + "\"") << "\n";
+        oss << ((p.ylabel.empty() || !show_y) ? "unset ylabel" : "set ylabel \"" + p.ylabel + "\"") << "\n";
+        if (shared_x) {
+            oss << "set format x \"" << (show_x ? xformat : "") << "\"\n";
+        }
+        if (shared_y) {
+            oss << "set format y \"" << (show_y ? yformat : "") << "\"\n";
+        }
+        oss << (xrange.empty() ? "set autoscale x" : "set xrange " + xrange) << "\n";
+        oss << (yrange.empty() ? "set autoscale y" : "set yrange " + yrange) << "\n";
+        if (!p.series.empty()) {
+            oss << "plot ";
+            for (std::size_t i = 0; i < p.series.size(); ++i) {
+                oss << ((i > 0) ? ", " : "") << p.series[i].get_declaration();
+            }
+            oss << "\n";
+        }
+        return oss.str();
+    }
+
+    /// @brief Returns the command entering multiplot mode.
+    /// @return The command.
+    auto get_prologue() const -> std::string
+    {
+        return title.empty() ? "set multiplot" : "set multiplot title \"" + title + "\"";
+    }
+
+    /// @brief Returns the commands leaving multiplot mode, and restoring the settings shared by the panels.
+    /// @return The commands, one per line.
+    auto get_epilogue() const -> std::string
+    {
+        std::ostringstream oss;
+        // The last panel leaves its origin and size behind, the next plots take the whole canvas.
+        oss << "unset multiplot\nset origin 0,0\nset size 1,1";
+        if (!xrange.empty()) {
+            oss << "\nset autoscale x";
+        }
+        if (!yrange.empty()) {
+            oss << "\nset autoscale y";
+        }
+        if (shared_x) {
+            oss << "\nset format x \"" << xformat << "\"";
+        }
+        if (shared_y) {
+            oss << "\nset format y \"" << yformat << "\"";
+        }
+        return oss.str();
+    }
+
+    /// @brief Returns the commands drawing the whole multiplot.
+    /// @return The commands, one per line.
+    auto get_commands() const -> std::string
+    {
+        std::ostringstream oss;
+        oss << this->get_prologue() << "\n";
+        for (std::size_t i = 0; i < panels.size(); ++i) {
+            oss << this->get_panel_placement(i) << this->get_panel_commands(i);
+        }
+        oss << this->get_epilogue();
+        return oss.str();
+    }
+
+private:
+    /// @brief Formats a range, without losing the precision of its bounds.
+    /// @param min The minimum value.
+    /// @param max The maximum value.
+    /// @return The range, as in gnuplot's `set xrange`.
+    static auto format_range(double min, double max) -> std::string
+    {
+        std::ostringstream oss;
+        oss << std::setprecision(std::numeric_limits<double>::max_digits10) << "[" << min << ":" << max << "]";
+        return oss.str();
+    }
+
+    std::size_t rows;                      ///< The number of rows of the grid.
+    std::size_t cols;                      ///< The number of columns of the grid.
+    std::string title;                     ///< The title of the whole multiplot.
+    bool shared_x{false};                  ///< Whether the x-axis is shared among the panels.
+    bool shared_y{false};                  ///< Whether the y-axis is shared among the panels.
+    std::string xformat;                   ///< The format of the x tic labels on the outer panels.
+    std::string yformat;                   ///< The format of the y tic labels on the outer panels.
+    std::string xrange;                    ///< The x range used by all the panels, empty for autoscale.
+    std::string yrange;                    ///< The y range used by all the panels, empty for autoscale.
+    std::vector<multiplot_panel_t> panels; ///< The panels of the layout.
+};
+
+/// @brief The commands drawing a panel of the current multiplot, cached so that the multiplot
+/// can be redrawn without uploading the data of its unchanged panels again.
+struct panel_commands_t {
+    std::string placement;          ///< The commands placing the panel on the canvas.
+    std::string commands;           ///< The commands drawing the panel.
+    bool dirty;                     ///< Whether the panel changed since the multiplot was last drawn.
+    std::vector<std::string> files; ///< The data files read by the commands.
+    std::vector<std::string> owned; ///< The data files written while drawing the panel, released with it.
+};
+
+} // namespace gpcpp
@@ -0,0 +1,225 @@
+/// @file nonfinite.hpp
+/// @brief Detection of the non-finite values (NaN, infinities) of the data, turned into gaps or dropped.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace gpcpp
+{
+
+/// @brief What happens to the records holding a non-finite value (NaN, or an infinity).
+enum class nonfinite_policy_t : unsigned char {
+    passthrough, ///< The records are written as they are, and gnuplot decides what to do.
+    gap,         ///< The records are dropped, and the line is broken where they were.
+    filter,      ///< The records are dropped, and the line joins the records around them.
+};
+
+/// @brief Converts a non-finite policy to a string.
+/// @param policy The policy.
+/// @return The name of the policy.
+static inline auto nonfinite_policy_to_string(nonfinite_policy_t policy) -> const char *
+{
+    switch (policy) {
+    case nonfinite_policy_t::passthrough:
+        return "passthrough";
+    case nonfinite_policy_t::gap:
+        return "gap";
+    case nonfinite_policy_t::filter:
+        return "filter";
+    }
+    return "unknown";
+}
+
+/// @brief Checks if a value is NaN or an infinity, without branches.
+/// @details The exponent bits are tested directly, so the check holds with -ffast-math too, and
+/// the loops calling it can be vectorized.
+/// @param value The value.
+/// @return 1 if the value is not finite, 0 otherwise.
+static inline auto is_nonfinite(double value) -> unsigned char
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return static_cast<unsigned char>(((bits >> 52U) & 0x7FFU) == 0x7FFU);
+}
+
+/// @brief Marks the rows where a column is not finite.
+/// @param column The column.
+/// @param rows The number of rows.
+/// @param flags The flag of each row, set to 1 if the value is not finite.
+/// @return A non-zero value if any value is not finite.
+template <typename C>
+inline auto mark_nonfinite(const C &column, std::size_t rows, unsigned char *flags) -> unsigned char
+{
+    unsigned char any = 0;
+    for (std::size_t i = 0; i < rows; ++i) {
+        const unsigned char bad = is_nonfinite(static_cast<double>(column[i]));
+        flags[i] |= bad;
+        any |= bad;
+    }
+    return any;
+}
+
+/// @brief Finds the rows of some columns holding a non-finite value.
+/// @details The columns are scanned one at a time, with branch-free loops.
+/// @param rows The number of rows.
+/// @param columns The columns.
+/// @return The flag of each row (1 if a value is not finite), empty if all the values are finite.
+template <typename... Columns>
+inline auto nonfinite_rows(std::size_t rows, const Columns &...columns) -> std::vector<unsigned char>
+{
+    std::vector<unsigned char> flags(rows, 0);
+    const unsigned char found[] = {mark_nonfinite(columns, rows, flags.data())...};
+    unsigned char any           = 0;
+    for (unsigned char bad : found) {
+        any |= bad;
+    }
+    if (any == 0) {
+        flags.clear();
+    }
+    return flags;
+}
+
+/// @brief Removes the rows holding a non-finite value from a list of rows.
+/// @details The list is compacted without branches: every row is copied, and the position only
+/// advances past the finite ones.
+/// @param flags The flag of each row (see nonfinite_rows).
+/// @param policy With gap, the positions where the line must be broken are returned.
+/// @param selected The rows to write, in order, empty for all of them. Receives the finite rows.
+/// @param breaks Receives the positions in `selected` before which the line must be broken.
+static inline void drop_nonfinite_rows(
+    const std::vector<unsigned char> &flags,
+    nonfinite_policy_t policy,
+    std::vector<std::size_t> &selected,
+    std::vector<std::size_t> &breaks)
+{
+    if (selected.empty()) {
+        selected.resize(flags.size());
+        for (std::size_t i = 0; i < flags.size(); ++i) {
+            selected[i] = i;
+        }
+    }
+    breaks.resize(selected.size());
+    std::size_t kept = 0, nbreaks = 0;
+    unsigned char previous = 0, started = 0;
+    for (std::size_t k = 0; k < selected.size(); ++k) {
+        const std::size_t i      = selected[k];
+        const unsigned char good = static_cast<unsigned char>(1U - flags[i]);
+        // A break goes before the first finite row after some non-finite ones, but not at the start.
+        breaks[nbreaks] = kept;
+        nbreaks += good & previous & started;
+        started |= good;
+        previous       = flags[i];
+        selected[kept] = i;
+        kept += good;
+    }
+    selected.resize(kept);
+    breaks.resize((policy == nonfinite_policy_t::gap) ? nbreaks : 0);
+}
+
+/// @brief Removes the non-finite records from the chunks of a dataset, and tracks the gaps they leave.
+/// @details The records are processed chunk after chunk, as they are written; a gap spanning two
+/// chunks is broken only once. A first branch-free pass over the whole chunk checks for
+/// non-finite values, so chunks without any are left untouched.
+class nonfinite_splitter_t
+{
+public:
+    /// @brief Constructor.
+    /// @param _policy What happens to the records holding a non-finite value.
+    /// @param _columns The number of values of each record.
+    nonfinite_splitter_t(nonfinite_policy_t _policy, std::size_t _columns)
+        : policy(_policy)
+        , columns((_columns > 0) ? _columns : 1)
+        , segments(1, 0)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Removes the non-finite records of a chunk, in place.
+    /// @param records The values of the records, one record after the other.
+    /// @param breaks Receives the positions of the records, in the chunk, before which the line must be broken.
+    void split(std::vector<double> &records, std::vector<std::size_t> &breaks)
+    {
+        breaks.clear();
+        const std::size_t n = records.size() / columns;
+        unsigned char any   = 0;
+        if (policy != nonfinite_policy_t::passthrough) {
+            for (double value : records) {
+                any |= is_nonfinite(value);
+            }
+        }
+        if (any == 0) {
+            // The line only needs to be broken if the previous chunk ended with non-finite records.
+            if ((n > 0) && (previous != 0) && (started != 0) && (policy == nonfinite_policy_t::gap)) {
+                breaks.push_back(0);
+            }
+            started |= static_cast<unsigned char>(n > 0);
+            previous = (n > 0) ? 0 : previous;
+            this->account(n, breaks);
+            return;
+        }
+        // Flag the records, then compact them.
+        flags.assign(n, 0);
+        for (std::size_t r = 0; r < n; ++r) {
+            for (std::size_t c = 0; c < columns; ++c) {
+                flags[r] |= is_nonfinite(records[r * columns + c]);
+            }
+        }
+        breaks.resize(n);
+        std::size_t kept = 0, nbreaks = 0;
+        for (std::size_t r = 0; r < n; ++r) {
+            const unsigned char good = static_cast<unsigned char>(1U - flags[r]);
+            breaks[nbreaks]          = kept;
+            nbreaks += good & previous & started;
+            started |= good;
+            previous = flags[r];
+            for (std::size_t c = 0; c < columns; ++c) {
+                records[kept * columns + c] = records[r * columns + c];
+            }
+            kept += good;
+        }
+        records.resize(kept * columns);
+        breaks.resize((policy == nonfinite_policy_t::gap) ? nbreaks : 0);
+        this->account(kept, breaks);
+    }
+
+    /// @brief Returns the number of records kept so far.
+    /// @return The number of records.
+    auto get_rows() const -> std::size_t { return rows; }
+
+    /// @brief Returns the number of records of each segment between two gaps.
+    /// @return The lengths of the segments, empty if there are no gaps.
+    auto get_segments() const -> std::vector<std::size_t>
+    {
+        return (segments.size() > 1) ? segments : std::vector<std::size_t>();
+    }
+
+private:
+    /// @brief Accounts for the records kept from a chunk.
+    /// @param kept The number of records kept.
+    /// @param breaks The positions of the gaps in the chunk.
+    void account(std::size_t kept, const std::vector<std::size_t> &breaks)
+    {
+        std::size_t position = 0;
+        for (std::size_t brk : breaks) {
+            segments.back() += brk - position;
+            segments.push_back(0);
+            position = brk;
+        }
+        segments.back() += kept - position;
+        rows += kept;
+    }
+
+    nonfinite_policy_t policy;         ///< What happens to the records holding a non-finite value.
+    std::size_t columns;               ///< The number of values of each record.
+    std::vector<unsigned char> flags;  ///< The flag of each record of the chunk, reused across chunks.
+    std::vector<std::size_t> segments; ///< The number of records of each segment.
+    std::size_t rows{0};               ///< The number of records kept.
+    unsigned char previous{0};         ///< Whether the last record seen was not finite.
+    unsigned char started{0};          ///< Whether a finite record has been seen.
+};
+
+} // namespace gpcpp
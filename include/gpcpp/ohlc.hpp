@@ -0,0 +1,294 @@
+/// @file ohlc.hpp
+/// @brief Aggregation of price ticks into open/high/low/close bars, at once or one tick at a time.
+
+#pragma once
+
+#include "gpcpp/workers.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <vector>
+
+namespace gpcpp
+{
+
+/// @brief How the bars of a financial plot are drawn.
+enum class candle_style_t : unsigned char {
+    candlesticks, ///< A box from the open to the close, with whiskers to the low and the high.
+    financebars,  ///< A vertical line from the low to the high, with ticks for the open and the close.
+};
+
+/// @brief Converts a candle_style_t value to its gnuplot style.
+/// @param style The style.
+/// @return The name of the gnuplot style.
+static inline auto candle_style_to_string(candle_style_t style) -> const char *
+{
+    switch (style) {
+    case candle_style_t::candlesticks:
+        return "candlesticks";
+    case candle_style_t::financebars:
+        return "financebars";
+    }
+    return "candlesticks";
+}
+
+/// @brief Open/high/low/close bars, one column per field, in ascending order of time.
+/// @details The columns are in the order expected by gnuplot's financial styles (time, open, low,
+/// high, close), so they can be uploaded as they are.
+struct ohlc_bars_t {
+    std::vector<double> time;  ///< The middle of the interval of each bar.
+    std::vector<double> open;  ///< The first price of each bar.
+    std::vector<double> low;   ///< The lowest price of each bar.
+    std::vector<double> high;  ///< The highest price of each bar.
+    std::vector<double> close; ///< The last price of each bar.
+
+    /// @brief Returns the number of bars.
+    /// @return The number of bars.
+    auto size() const -> std::size_t { return time.size(); }
+
+    /// @brief Adds a bar holding a single price.
+    /// @param _time The middle of the interval of the bar.
+    /// @param price The price.
+    void push_back(double _time, double price)
+    {
+        time.push_back(_time);
+        open.push_back(price);
+        low.push_back(price);
+        high.push_back(price);
+        close.push_back(price);
+    }
+
+    /// @brief Accounts for a later price in the last bar.
+    /// @param price The price.
+    void update_back(double price)
+    {
+        low.back()   = (std::min)(low.back(), price);
+        high.back()  = (std::max)(high.back(), price);
+        close.back() = price;
+    }
+
+    /// @brief Removes all the bars.
+    void clear()
+    {
+        time.clear();
+        open.clear();
+        low.clear();
+        high.clear();
+        close.clear();
+    }
+};
+
+/// @brief Returns the interval a timestamp falls into.
+/// @param timestamp The timestamp.
+/// @param origin The start of the first interval.
+/// @param interval The length of the intervals.
+/// @return The index of the interval.
+static inline auto ohlc_slot(double timestamp, double origin, double interval) -> std::int64_t
+{
+    return static_cast<std::int64_t>(std::floor((timestamp - origin) / interval));
+}
+
+/// @brief Aggregates price ticks into bars of a fixed interval, in a single pass split among worker threads.
+/// @details The intervals are aligned on multiples of their length, and only the intervals holding
+/// some ticks get a bar. Each worker aggregates a contiguous block of ticks; a bar split between two
+/// blocks is then merged, so the result does not depend on the number of workers. The ticks with a
+/// non-finite timestamp or price are skipped.
+/// @param timestamps The time of each tick, in ascending order.
+/// @param prices The price of each tick.
+/// @param interval The length of a bar, in the units of the timestamps.
+/// @param workers The number of worker threads, 0 for the number of hardware threads.
+/// @return The bars, empty if the timestamps are not in ascending order or no tick is finite.
+template <typename T, typename P>
+inline auto aggregate_ohlc(const T &timestamps, const P &prices, double interval, std::size_t workers = 0)
+    -> ohlc_bars_t
+{
+    // Below this number of ticks per worker, starting a thread costs more than it saves.
+    const std::size_t min_block = 65536;
+
+    // The bars of a block, with the interval of each one.
+    struct partial_t {
+        ohlc_bars_t bars;
+        std::vector<std::int64_t> slots;
+        bool ordered;
+    };
+
+    const std::size_t count =
+        (std::min)(static_cast<std::size_t>(timestamps.size()), static_cast<std::size_t>(prices.size()));
+    std::size_t first       = 0;
+    while ((first < count) && !std::isfinite(static_cast<double>(timestamps[first]))) {
+        ++first;
+    }
+    if ((first == count) || !(interval > 0)) {
+        return ohlc_bars_t();
+    }
+    const double origin = std::floor(static_cast<double>(timestamps[first]) / interval) * interval;
+
+    auto aggregate = [&timestamps, &prices, origin, interval](std::size_t begin, std::size_t end) {
+        partial_t part;
+        part.ordered    = true;
+        double previous = -std::numeric_limits<double>::infinity();
+        for (std::size_t i = begin; i < end; ++i) {
+            const double t = static_cast<double>(timestamps[i]);
+            const double p = static_cast<double>(prices[i]);
+            if (!std::isfinite(t) || !std::isfinite(p)) {
+                continue;
+            }
+            part.ordered         = part.ordered && (t >= previous);
+            previous             = t;
+            const std::int64_t s = ohlc_slot(t, origin, interval);
+            if (part.slots.empty() || (s != part.slots.back())) {
+                part.slots.push_back(s);
+                part.bars.push_back(origin + (static_cast<double>(s) + 0.5) * interval, p);
+            } else {
+                part.bars.update_back(p);
+            }
+        }
+        return part;
+    };
+
+    const std::size_t nworkers = worker_count(workers, (count - first + min_block - 1) / min_block);
+    const std::size_t block    = (count - first + nworkers - 1) / nworkers;
+    std::vector<std::future<partial_t>> pending;
+    for (std::size_t begin = first + block; begin < count; begin += block) {
+        pending.push_back(std::async(std::launch::async, aggregate, begin, (std::min)(begin + block, count)));
+    }
+    partial_t merged = aggregate(first, (std::min)(first + block, count));
+    double last      = (merged.bars.size() > 0) ? merged.bars.time.back() : -std::numeric_limits<double>::infinity();
+    for (std::future<partial_t> &worker : pending) {
+        const partial_t part = worker.get();
+        merged.ordered       = merged.ordered && part.ordered;
+        if (part.bars.size() == 0) {
+            continue;
+        }
+        merged.ordered = merged.ordered && (part.bars.time.front() >= last);
+        last           = part.bars.time.back();
+        // The first bar of the block may continue the last bar of the previous ones.
+        std::size_t k = 0;
+        if (!merged.slots.empty() && (part.slots.front() == merged.slots.back())) {
+            merged.bars.low.back()   = (std::min)(merged.bars.low.back(), part.bars.low.front());
+            merged.bars.high.back()  = (std::max)(merged.bars.high.back(), part.bars.high.front());
+            merged.bars.close.back() = part.bars.close.front();
+            k                        = 1;
+        }
+        for (; k < part.bars.size(); ++k) {
+            merged.slots.push_back(part.slots[k]);
+            merged.bars.time.push_back(part.bars.time[k]);
+            merged.bars.open.push_back(part.bars.open[k]);
+            merged.bars.low.push_back(part.bars.low[k]);
+            merged.bars.high.push_back(part.bars.high[k]);
+            merged.bars.close.push_back(part.bars.close[k]);
+        }
+    }
+    return merged.ordered ? merged.bars : ohlc_bars_t();
+}
+
+/// @brief Aggregates price ticks into bars as they arrive.
+/// @details Each tick either updates the newest bar or starts a new one, so the bars before the
+/// newest one never change, and a plot of the stream only needs to rewrite the newest bar.
+class ohlc_stream_t
+{
+public:
+    /// @brief Constructor.
+    /// @param _interval The length of a bar, in the units of the timestamps.
+    explicit ohlc_stream_t(double _interval)
+        : interval((_interval > 0) ? _interval : 1.0)
+        , id(ohlc_stream_t::next_id())
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Copy constructor, the copy gets its own identifier since its bars evolve separately.
+    /// @param other The stream to copy.
+    ohlc_stream_t(const ohlc_stream_t &other)
+        : interval(other.interval)
+        , origin(other.origin)
+        , newest(other.newest)
+        , bars(other.bars)
+        , id(ohlc_stream_t::next_id())
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Copy assignment, the stream gets a new identifier since its bars are replaced.
+    /// @param other The stream to copy.
+    /// @return A reference to this stream.
+    auto operator=(const ohlc_stream_t &other) -> ohlc_stream_t &
+    {
+        if (this != &other) {
+            interval = other.interval;
+            origin   = other.origin;
+            newest   = other.newest;
+            bars     = other.bars;
+            id       = ohlc_stream_t::next_id();
+        }
+        return *this;
+    }
+
+    /// @brief Accounts for a tick.
+    /// @param timestamp The time of the tick, not earlier than the interval of the newest bar.
+    /// @param price The price.
+    /// @return true if the tick has been accounted for, false if it is not finite or too late.
+    auto push(double timestamp, double price) -> bool
+    {
+        if (!std::isfinite(timestamp) || !std::isfinite(price)) {
+            return false;
+        }
+        if (bars.size() == 0) {
+            origin = std::floor(timestamp / interval) * interval;
+        }
+        const std::int64_t s = ohlc_slot(timestamp, origin, interval);
+        if ((bars.size() > 0) && (s < newest)) {
+            return false;
+        }
+        if ((bars.size() == 0) || (s > newest)) {
+            newest = s;
+            bars.push_back(origin + (static_cast<double>(s) + 0.5) * interval, price);
+        } else {
+            bars.update_back(price);
+        }
+        return true;
+    }
+
+    /// @brief Returns the bars.
+    /// @return The bars, in ascending order of time.
+    auto get_bars() const -> const ohlc_bars_t & { return bars; }
+
+    /// @brief Returns the length of a bar.
+    /// @return The interval, in the units of the timestamps.
+    auto get_interval() const -> double { return interval; }
+
+    /// @brief Returns the identifier of the bars.
+    /// @details The identifier is unique among the streams of the process, and changes when the bars
+    /// are cleared, so that a plot of the stream never reuses bars written before.
+    /// @return The identifier.
+    auto get_id() const -> std::uint64_t { return id; }
+
+    /// @brief Removes all the bars.
+    void clear()
+    {
+        bars.clear();
+        id = ohlc_stream_t::next_id();
+    }
+
+private:
+    /// @brief Returns a new identifier.
+    /// @return An identifier never returned before.
+    static auto next_id() -> std::uint64_t
+    {
+        static std::atomic<std::uint64_t> counter{0};
+        return ++counter;
+    }
+
+    double interval;        ///< The length of a bar.
+    double origin{0.0};     ///< The start of the interval of the first bar.
+    std::int64_t newest{0}; ///< The interval of the newest bar.
+    ohlc_bars_t bars;       ///< The bars.
+    std::uint64_t id;       ///< The identifier of the bars.
+};
+
+} // namespace gpcpp
@@ -0,0 +1,39 @@
+/// @file outbound.hpp
+/// @brief Types describing the queue of commands waiting to be written to gnuplot.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace gpcpp
+{
+
+/// @brief What to do when gnuplot cannot keep up, and the outbound queue is full.
+enum class overload_policy_t : unsigned char {
+    block,       ///< Wait for room, up to the write timeout, then reject the new data.
+    drop_oldest, ///< Drop the oldest frames that have not been sent yet.
+    coalesce,    ///< Keep only the latest frame among those that have not been sent yet.
+    fail_fast,   ///< Reject the new data immediately.
+};
+
+/// @brief Statistics about the data written to gnuplot.
+struct pipe_metrics_t {
+    std::size_t bytes_written{0};     ///< The number of bytes written to gnuplot.
+    std::size_t chunks_written{0};    ///< The number of chunks (flushes or frames) written to gnuplot.
+    std::size_t queued_bytes{0};      ///< The number of bytes waiting in the queue.
+    std::size_t peak_queued_bytes{0}; ///< The largest number of bytes ever waiting in the queue.
+    std::size_t frames_dropped{0};    ///< The number of frames dropped by the drop_oldest policy.
+    std::size_t frames_coalesced{0};  ///< The number of frames replaced by a newer one (coalesce policy).
+    std::size_t rejected{0};          ///< The number of chunks rejected because the queue was full.
+    std::size_t timeouts{0};          ///< The number of writes that timed out.
+    double blocked_ms{0.0};           ///< The time spent waiting for gnuplot to read, in milliseconds.
+};
+
+/// @brief A chunk of commands waiting to be written to gnuplot.
+struct outbound_chunk_t {
+    std::string data;  ///< The commands.
+    std::size_t frame; ///< The frame the commands belong to, 0 if they cannot be dropped.
+};
+
+} // namespace gpcpp
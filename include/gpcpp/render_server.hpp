@@ -0,0 +1,531 @@
+/// @file render_server.hpp
+/// @brief A local render daemon, owning warm gnuplot processes, and its clients.
+/// @details Clients send the commands of a figure over a Unix domain socket, while the bulk data
+/// travels through POSIX shared memory segments that gnuplot reads directly, so the data is never
+/// copied over the socket. Only available on POSIX systems providing /dev/shm (e.g., Linux).
+
+#pragma once
+
+#include "gpcpp/gnuplot.hpp"
+
+#if defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <sys/mman.h>   // for shm_open(), mmap()
+#include <sys/socket.h> // for socket(), bind(), accept()
+#include <sys/un.h>     // for sockaddr_un
+
+namespace gpcpp
+{
+
+/// @brief Sends the whole buffer over a socket.
+/// @param fd The socket.
+/// @param data The data to send.
+/// @return true if all the data has been sent, false otherwise.
+static inline auto socket_send_all(int fd, const std::string &data) -> bool
+{
+#if defined(MSG_NOSIGNAL)
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = send(fd, data.data() + sent, data.size() - sent, flags);
+        if (n > 0) {
+            sent += static_cast<std::size_t>(n);
+        } else if ((n < 0) && (errno == EINTR)) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Reads a line from a socket.
+/// @param fd The socket.
+/// @param pending The data received and not consumed yet, it is kept between calls.
+/// @param line The line, without the trailing newline.
+/// @return true if a line has been read, false if the connection was closed.
+static inline auto socket_read_line(int fd, std::string &pending, std::string &line) -> bool
+{
+    std::size_t end = 0;
+    while ((end = pending.find('\n')) == std::string::npos) {
+        char buffer[4096];
+        const ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            pending.append(buffer, static_cast<std::size_t>(n));
+        } else if ((n < 0) && (errno == EINTR)) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    line = pending.substr(0, end);
+    pending.erase(0, end + 1);
+    return true;
+}
+
+/// @brief A POSIX shared memory segment, which gnuplot can read like a regular file.
+/// @details The segment is created by the constructor, and removed by the destructor.
+class shared_segment_t
+{
+public:
+    /// @brief Constructor, creates a new segment.
+    /// @param _size The size of the segment, in bytes.
+    explicit shared_segment_t(std::size_t _size)
+        : length(_size)
+    {
+        static std::atomic<unsigned> counter{0};
+        // Pick a name that is not in use, the segment is readable only by the current user.
+        int fd = -1;
+        for (unsigned attempt = 0; (fd < 0) && (attempt < 16); ++attempt) {
+            name = "/gpcpp-" + std::to_string(getpid()) + "-" + std::to_string(counter++);
+            fd   = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+            if ((fd < 0) && (errno != EEXIST)) {
+                break;
+            }
+        }
+        if (fd < 0) {
+            std::cerr << "Error: Cannot create the shared memory segment \"" << name << "\".\n";
+            name.clear();
+            return;
+        }
+        // An empty mapping is not allowed.
+        if ((ftruncate(fd, static_cast<off_t>(length)) != 0) ||
+            ((address = mmap(nullptr, (std::max)(length, std::size_t{1}), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) ==
+             MAP_FAILED)) {
+            std::cerr << "Error: Cannot map the shared memory segment \"" << name << "\".\n";
+            address = nullptr;
+            shm_unlink(name.c_str());
+            name.clear();
+        }
+        close(fd);
+    }
+
+    /// @brief Destructor, unmaps and removes the segment.
+    ~shared_segment_t()
+    {
+        if (address != nullptr) {
+            munmap(address, (std::max)(length, std::size_t{1}));
+        }
+        if (!name.empty()) {
+            shm_unlink(name.c_str());
+        }
+    }
+
+    /// @brief Segments cannot be copied, they own the shared memory.
+    shared_segment_t(const shared_segment_t &) = delete;
+
+    /// @brief Segments cannot be copied, they own the shared memory.
+    /// @return A reference to the segment.
+    auto operator=(const shared_segment_t &) -> shared_segment_t & = delete;
+
+    /// @brief Checks if the segment has been created and mapped.
+    /// @return true if the segment is usable, false otherwise.
+    auto is_valid() const -> bool { return address != nullptr; }
+
+    /// @brief Returns the mapped memory.
+    /// @return A pointer to the first byte of the segment.
+    auto data() -> void * { return address; }
+
+    /// @brief Returns the size of the segment.
+    /// @return The size in bytes.
+    auto size() const -> std::size_t { return length; }
+
+    /// @brief Returns the path under which other processes, gnuplot included, can read the segment.
+    /// @return The path of the segment.
+    auto path() const -> std::string { return "/dev/shm" + name; }
+
+private:
+    std::string name;       ///< The name of the segment, as given to shm_open.
+    std::size_t length;     ///< The size of the segment, in bytes.
+    void *address{nullptr}; ///< The mapped memory, nullptr if not mapped.
+};
+
+/// @brief A daemon owning warm gnuplot processes, which renders the figures sent by its clients.
+/// @details Each connection is served by its own thread. A figure is a sequence of gnuplot
+/// commands terminated by an empty line; it is drawn by the first idle gnuplot of the pool, and
+/// the server answers with "ok" once gnuplot has drawn it (or with "error <reason>"). Before each
+/// figure the settings of the gnuplot are reset, but the terminal and the output are kept.
+class RenderServer
+{
+public:
+    /// @brief Constructor.
+    /// @param _socket_path The path of the Unix domain socket (default is default_socket_path()).
+    /// @param _workers The number of gnuplot processes kept warm (default is 2).
+    explicit RenderServer(const std::string &_socket_path = default_socket_path(), std::size_t _workers = 2)
+        : socket_path(_socket_path)
+        , workers((_workers > 0) ? _workers : 1)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Destructor, stops the server.
+    ~RenderServer() { this->stop(); }
+
+    /// @brief Servers cannot be copied, they own the socket and the gnuplot processes.
+    RenderServer(const RenderServer &) = delete;
+
+    /// @brief Servers cannot be copied, they own the socket and the gnuplot processes.
+    /// @return A reference to the server.
+    auto operator=(const RenderServer &) -> RenderServer & = delete;
+
+    /// @brief Returns the default path of the socket, inside XDG_RUNTIME_DIR if set.
+    /// @return The path of the socket.
+    static auto default_socket_path() -> std::string
+    {
+        const char *runtime = getenv("XDG_RUNTIME_DIR");
+        if ((runtime != nullptr) && (runtime[0] != '\0')) {
+            return std::string(runtime) + "/gpcpp.sock";
+        }
+        return "/tmp/gpcpp-" + std::to_string(getuid()) + ".sock";
+    }
+
+    /// @brief Starts the gnuplot processes, and listens for clients on a background thread.
+    /// @return true if the server is running, false otherwise.
+    auto start() -> bool
+    {
+        if (running) {
+            return true;
+        }
+        sockaddr_un address{};
+        if (socket_path.size() >= sizeof(address.sun_path)) {
+            std::cerr << "Error: The socket path \"" << socket_path << "\" is too long.\n";
+            return false;
+        }
+
+        // Warm up the pool, each gnuplot acknowledges an empty frame once it is ready.
+        for (std::size_t i = 0; i < workers; ++i) {
+            std::unique_ptr<Gnuplot> session(new Gnuplot());
+            if (!session->is_ready()) {
+                std::cerr << "Error: Cannot start the gnuplot processes of the render server.\n";
+                sessions.clear();
+                return false;
+            }
+            session->set_auto_respawn();
+            session->begin_frame().end_frame();
+            session->sync();
+            idle.push_back(session.get());
+            sessions.push_back(std::move(session));
+        }
+
+        // Replace a stale socket, left by a server that did not stop cleanly.
+        listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        address.sun_family = AF_UNIX;
+        socket_path.copy(address.sun_path, socket_path.size());
+        unlink(socket_path.c_str());
+        if ((listen_fd < 0) || (bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) ||
+            (chmod(socket_path.c_str(), S_IRUSR | S_IWUSR) != 0) || (listen(listen_fd, 16) != 0)) {
+            std::cerr << "Error: Cannot listen on the socket \"" << socket_path << "\".\n";
+            this->stop();
+            return false;
+        }
+        fcntl(listen_fd, F_SETFD, FD_CLOEXEC);
+
+        running  = true;
+        acceptor = std::thread(&RenderServer::accept_loop, this);
+        return true;
+    }
+
+    /// @brief Stops accepting clients, closes the open connections and the gnuplot processes.
+    void stop()
+    {
+        running = false;
+        available.notify_all();
+        if (acceptor.joinable()) {
+            acceptor.join();
+        }
+        if (listen_fd >= 0) {
+            close(listen_fd);
+            listen_fd = -1;
+            unlink(socket_path.c_str());
+        }
+        // Wake up the connections waiting for their clients.
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (int fd : connections) {
+                shutdown(fd, SHUT_RDWR);
+            }
+        }
+        for (std::thread &handler : handlers) {
+            handler.join();
+        }
+        handlers.clear();
+        finished.clear();
+        idle.clear();
+        sessions.clear();
+    }
+
+    /// @brief Checks if the server is accepting clients.
+    /// @return true if the server is running, false otherwise.
+    auto is_running() const -> bool { return running; }
+
+    /// @brief Returns the path of the socket.
+    /// @return The path of the socket.
+    auto get_socket_path() const -> const std::string & { return socket_path; }
+
+    /// @brief Returns the number of figures rendered so far.
+    /// @return The number of figures.
+    auto figures() const -> std::size_t { return rendered; }
+
+private:
+    /// @brief Accepts the clients, until the server is stopped.
+    void accept_loop()
+    {
+        while (running) {
+            this->join_finished();
+            // Check regularly whether the server has been stopped.
+            pollfd pfd{};
+            pfd.fd     = listen_fd;
+            pfd.events = POLLIN;
+            if (poll(&pfd, 1, 100) <= 0) {
+                continue;
+            }
+            const int fd = accept(listen_fd, nullptr, nullptr);
+            if (fd < 0) {
+                continue;
+            }
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+            std::lock_guard<std::mutex> lock(mutex);
+            connections.push_back(fd);
+            handlers.emplace_back(&RenderServer::serve, this, fd);
+        }
+    }
+
+    /// @brief Serves the figures of a client, until it disconnects.
+    /// @param fd The socket of the client.
+    void serve(int fd)
+    {
+        std::string pending;
+        std::string line;
+        std::vector<std::string> commands;
+        while (running && socket_read_line(fd, pending, line)) {
+            if (!line.empty()) {
+                commands.push_back(line);
+                continue;
+            }
+            const std::string reply = this->render(commands);
+            commands.clear();
+            if (!socket_send_all(fd, reply + "\n")) {
+                break;
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        connections.erase(std::find(connections.begin(), connections.end(), fd));
+        close(fd);
+        // The acceptor joins the thread, a long-running server does not keep one per past client.
+        finished.push_back(std::this_thread::get_id());
+    }
+
+    /// @brief Joins the threads of the clients that disconnected.
+    void join_finished()
+    {
+        std::vector<std::thread> done;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const std::thread::id &id : finished) {
+                std::vector<std::thread>::iterator it =
+                    std::find_if(handlers.begin(), handlers.end(), [&id](const std::thread &handler) {
+                        return handler.get_id() == id;
+                    });
+                if (it != handlers.end()) {
+                    done.push_back(std::move(*it));
+                    handlers.erase(it);
+                }
+            }
+            finished.clear();
+        }
+        // The threads are only returning, after releasing the lock.
+        for (std::thread &handler : done) {
+            handler.join();
+        }
+    }
+
+    /// @brief Draws a figure with the first idle gnuplot.
+    /// @param commands The commands of the figure.
+    /// @return The reply for the client.
+    auto render(const std::vector<std::string> &commands) -> std::string
+    {
+        Gnuplot *session = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this]() { return !idle.empty() || !running; });
+            if (idle.empty()) {
+                return "error the server is stopping";
+            }
+            session = idle.front();
+            idle.pop_front();
+        }
+
+        session->send_cmd("reset");
+        session->begin_frame();
+        for (const std::string &command : commands) {
+            session->send_cmd(command);
+        }
+        session->end_frame();
+        // The client may release its shared memory only once gnuplot has read it.
+        const bool drawn = session->sync();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            idle.push_back(session);
+            ++rendered;
+        }
+        available.notify_one();
+        return drawn ? "ok" : "error gnuplot did not draw the figure";
+    }
+
+    std::string socket_path;                        ///< The path of the Unix domain socket.
+    std::size_t workers;                            ///< The number of gnuplot processes.
+    std::vector<std::unique_ptr<Gnuplot>> sessions; ///< The gnuplot processes.
+    std::deque<Gnuplot *> idle;                     ///< The gnuplot processes waiting for a figure.
+    std::mutex mutex;                               ///< Protects the idle sessions and the connections.
+    std::condition_variable available;              ///< Signaled when a gnuplot becomes idle.
+    std::atomic<bool> running{false};               ///< Whether the server accepts clients.
+    std::atomic<std::size_t> rendered{0};           ///< The number of figures rendered so far.
+    int listen_fd{-1};                              ///< The listening socket, -1 if closed.
+    std::thread acceptor;                           ///< The thread accepting the clients.
+    std::vector<std::thread> handlers;              ///< The threads serving the clients.
+    std::vector<std::thread::id> finished;          ///< The threads whose client disconnected, to join.
+    std::vector<int> connections;                   ///< The sockets of the connected clients.
+};
+
+/// @brief A client of the render server.
+/// @details The data of a figure is shared through memory segments, which are released once the
+/// server has drawn the figure.
+class RenderClient
+{
+public:
+    /// @brief Constructor, connects to the server.
+    /// @param _socket_path The path of the socket of the server (default is RenderServer::default_socket_path()).
+    explicit RenderClient(const std::string &_socket_path = RenderServer::default_socket_path())
+    {
+        sockaddr_un address{};
+        if (_socket_path.size() >= sizeof(address.sun_path)) {
+            std::cerr << "Error: The socket path \"" << _socket_path << "\" is too long.\n";
+            return;
+        }
+        address.sun_family = AF_UNIX;
+        _socket_path.copy(address.sun_path, _socket_path.size());
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if ((fd < 0) || (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)) {
+            std::cerr << "Error: Cannot connect to the render server at \"" << _socket_path << "\".\n";
+            if (fd >= 0) {
+                close(fd);
+                fd = -1;
+            }
+            return;
+        }
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+
+    /// @brief Destructor, disconnects from the server.
+    ~RenderClient()
+    {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    /// @brief Clients cannot be copied, they own the connection.
+    RenderClient(const RenderClient &) = delete;
+
+    /// @brief Clients cannot be copied, they own the connection.
+    /// @return A reference to the client.
+    auto operator=(const RenderClient &) -> RenderClient & = delete;
+
+    /// @brief Checks if the client is connected to the server.
+    /// @return true if connected, false otherwise.
+    auto is_connected() const -> bool { return fd >= 0; }
+
+    /// @brief Shares the given columns with the server, as raw doubles in a shared memory segment.
+    /// @details The segment lives until the next call to render().
+    /// @param x The first column.
+    /// @param columns The other columns, they must have the same size of the first one.
+    /// @return The description of the dataset, to be used in the commands of the figure (see
+    /// dataset_t::get_declaration), invalid if the data could not be shared.
+    template <typename X, typename... Columns>
+    auto share(const X &x, const Columns &...columns) -> dataset_t
+    {
+        const std::size_t ncolumns = 1 + sizeof...(Columns);
+        const std::size_t rows     = x.size();
+        const std::size_t sizes[]  = {columns.size()...};
+        for (std::size_t size : sizes) {
+            if (size != rows) {
+                std::cerr << "Error: The columns to share must have the same size.\n";
+                return dataset_t();
+            }
+        }
+        std::unique_ptr<shared_segment_t> segment(new shared_segment_t(rows * ncolumns * sizeof(double)));
+        if (!segment->is_valid()) {
+            return dataset_t();
+        }
+        // Store the records one after the other, as written by Gnuplot::upload.
+        double *out = static_cast<double *>(segment->data());
+        for (std::size_t i = 0; i < rows; ++i) {
+            const double record[] = {static_cast<double>(x[i]), static_cast<double>(columns[i])...};
+            std::copy(record, record + ncolumns, out + i * ncolumns);
+        }
+        dataset_t dataset(segment->path(), ncolumns, rows, true);
+        segments.push_back(std::move(segment));
+        return dataset;
+    }
+
+    /// @brief Adds a command to the current figure.
+    /// @param cmd The gnuplot command, on a single line.
+    /// @return A reference to the client.
+    auto send_cmd(const std::string &cmd) -> RenderClient &
+    {
+        if (cmd.find('\n') != std::string::npos) {
+            throw std::invalid_argument("The commands sent to the render server must be on a single line.");
+        }
+        // Empty lines terminate the figures.
+        if (!cmd.empty()) {
+            figure += cmd + "\n";
+        }
+        return *this;
+    }
+
+    /// @brief Sends the current figure, waits until it is drawn, then releases its shared data.
+    /// @return true if the figure has been drawn, false otherwise.
+    auto render() -> bool
+    {
+        if (fd < 0) {
+            std::cerr << "Error: Not connected to the render server. Cannot render the figure.\n";
+            return false;
+        }
+        std::string reply;
+        const bool sent = socket_send_all(fd, figure + "\n") && socket_read_line(fd, pending, reply);
+        figure.clear();
+        segments.clear();
+        if (!sent) {
+            std::cerr << "Error: The connection to the render server was lost.\n";
+            close(fd);
+            fd = -1;
+            return false;
+        }
+        if (reply != "ok") {
+            std::cerr << "Error: The render server replied \"" << reply << "\".\n";
+            return false;
+        }
+        return true;
+    }
+
+private:
+    int fd{-1};                                              ///< The socket connected to the server, -1 if closed.
+    std::string figure;                                      ///< The commands of the current figure.
+    std::string pending;                                     ///< Data received and not consumed yet.
+    std::vector<std::unique_ptr<shared_segment_t>> segments; ///< The data shared for the current figure.
+};
+
+} // namespace gpcpp
+
+#endif
@@ -0,0 +1,255 @@
+/// @file resample.hpp
+/// @brief Resampling of series onto a common x axis, so that they can share a single dataset.
+
+#pragma once
+
+#include "gpcpp/chunk_source.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace gpcpp
+{
+
+/// @brief How a series is evaluated between its samples.
+enum class interpolation_t : unsigned char {
+    nearest, ///< The value of the closest sample.
+    linear,  ///< The straight line joining the two samples around the point.
+};
+
+/// @brief Creates a grid of evenly spaced points.
+/// @param from The first point.
+/// @param to The last point.
+/// @param count The number of points.
+/// @return The points, in ascending order if `from` is smaller than `to`.
+static inline auto linear_grid(double from, double to, std::size_t count) -> std::vector<double>
+{
+    std::vector<double> grid(count);
+    const double step = (count > 1) ? (to - from) / static_cast<double>(count - 1) : 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        grid[i] = from + step * static_cast<double>(i);
+    }
+    return grid;
+}
+
+/// @brief Merges the sorted x values of several series into a single sorted grid, without duplicates.
+/// @details The series are merge-joined with a heap holding the next value of each one, so the
+/// cost is O(N log K) for N values spread over K series. Aligning the series onto this grid keeps
+/// every original sample.
+/// @param xs The x values of each series, each one sorted in ascending order.
+/// @return The grid.
+template <typename X>
+inline auto union_grid(const std::vector<X> &xs) -> std::vector<double>
+{
+    // The heap holds the next value of each series, with the index of the series.
+    typedef std::pair<double, std::size_t> head_t;
+    std::priority_queue<head_t, std::vector<head_t>, std::greater<head_t>> heads;
+    std::vector<std::size_t> positions(xs.size(), 0);
+    std::size_t total = 0;
+    for (std::size_t k = 0; k < xs.size(); ++k) {
+        total += xs[k].size();
+        if (xs[k].size() > 0) {
+            heads.push(head_t(static_cast<double>(xs[k][0]), k));
+        }
+    }
+    std::vector<double> grid;
+    grid.reserve(total);
+    while (!heads.empty()) {
+        const head_t head = heads.top();
+        heads.pop();
+        // The values come out sorted, so a duplicate is never greater than the last one.
+        if (grid.empty() || (head.first > grid.back())) {
+            grid.push_back(head.first);
+        }
+        const std::size_t k = head.second;
+        if (++positions[k] < xs[k].size()) {
+            heads.push(head_t(static_cast<double>(xs[k][positions[k]]), k));
+        }
+    }
+    return grid;
+}
+
+/// @brief Evaluates a series on the points of a grid.
+/// @details Block by block, a first pass merge-joins the grid with the x values, and stores for each
+/// point the two samples around it and its relative position between them. A second pass computes
+/// the values with a branch-free loop over contiguous arrays, which the compiler can vectorize. The points
+/// outside the range of the series are NaN, which gnuplot treats as missing values.
+/// @param x The x values of the series, sorted in ascending order.
+/// @param y The y values of the series.
+/// @param grid The points, sorted in ascending order for a linear-time join (any order is accepted).
+/// @param interpolation How the series is evaluated between its samples.
+/// @param output Receives the value of the series on each point of the grid.
+template <typename X, typename Y>
+inline void resample(
+    const X &x,
+    const Y &y,
+    const std::vector<double> &grid,
+    interpolation_t interpolation,
+    std::vector<double> &output)
+{
+    const double nan    = std::numeric_limits<double>::quiet_NaN();
+    const std::size_t n = std::min<std::size_t>(x.size(), y.size());
+    const std::size_t m = grid.size();
+    output.assign(m, nan);
+    if (n == 0) {
+        return;
+    }
+    const double first = static_cast<double>(x[0]);
+    const double last  = static_cast<double>(x[n - 1]);
+
+    // The points are processed in blocks, so that the arrays shared by the two passes stay in cache.
+    const std::size_t block = 1024;
+    double left[block], right[block], weight[block];
+    std::size_t j = 0;
+    for (std::size_t begin = 0; begin < m; begin += block) {
+        const std::size_t count = std::min(block, m - begin);
+
+        // First pass: the samples around each point, and the relative position of the point.
+        for (std::size_t b = 0; b < count; ++b) {
+            const std::size_t i = begin + b;
+            const double g      = grid[i];
+            if (!(g >= first) || !(g <= last)) {
+                left[b]   = nan;
+                right[b]  = nan;
+                weight[b] = 0.0;
+                continue;
+            }
+            if (n == 1) {
+                left[b]   = static_cast<double>(y[0]);
+                right[b]  = left[b];
+                weight[b] = 0.0;
+                continue;
+            }
+            if ((i > 0) && (g < grid[i - 1])) {
+                // The grid went backwards, find the samples again with a binary search.
+                std::size_t lo = 0, hi = n - 1;
+                while (hi - lo > 1) {
+                    const std::size_t mid = lo + (hi - lo) / 2;
+                    if (static_cast<double>(x[mid]) <= g) {
+                        lo = mid;
+                    } else {
+                        hi = mid;
+                    }
+                }
+                j = lo;
+            }
+            // Advance until x[j] <= g < x[j + 1], without going past the last pair of samples.
+            while ((j + 2 < n) && (static_cast<double>(x[j + 1]) <= g)) {
+                ++j;
+            }
+            const double xa   = static_cast<double>(x[j]);
+            const double span = static_cast<double>(x[j + 1]) - xa;
+            left[b]           = static_cast<double>(y[j]);
+            right[b]          = static_cast<double>(y[j + 1]);
+            weight[b]         = (span > 0) ? std::min(std::max((g - xa) / span, 0.0), 1.0) : 0.0;
+        }
+
+        // Second pass: the values, without branches.
+        double *out = output.data() + begin;
+        if (interpolation == interpolation_t::linear) {
+            for (std::size_t b = 0; b < count; ++b) {
+                out[b] = left[b] + weight[b] * (right[b] - left[b]);
+            }
+        } else {
+            for (std::size_t b = 0; b < count; ++b) {
+                out[b] = (weight[b] < 0.5) ? left[b] : right[b];
+            }
+        }
+    }
+}
+
+/// @brief Evaluates a series on the points of a grid.
+/// @param x The x values of the series, sorted in ascending order.
+/// @param y The y values of the series.
+/// @param grid The points, sorted in ascending order for a linear-time join.
+/// @param interpolation How the series is evaluated between its samples (default is linear).
+/// @return The value of the series on each point of the grid, NaN outside the range of the series.
+template <typename X, typename Y>
+inline auto resample(
+    const X &x,
+    const Y &y,
+    const std::vector<double> &grid,
+    interpolation_t interpolation = interpolation_t::linear) -> std::vector<double>
+{
+    std::vector<double> output;
+    resample(x, y, grid, interpolation, output);
+    return output;
+}
+
+/// @brief Several series aligned onto the same x grid.
+/// @details As a chunk source, it provides records made of the x value followed by the value of
+/// each series, so all the series can be uploaded as a single dataset, with one column each. After
+/// the last chunk, the source starts again from the first record.
+class aligned_series_t : public chunk_source_t
+{
+public:
+    /// @brief Constructor.
+    /// @param _grid The common x values, sorted in ascending order (see linear_grid and union_grid).
+    explicit aligned_series_t(std::vector<double> _grid)
+        : grid(std::move(_grid))
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Resamples a series onto the grid, and adds it as a new column.
+    /// @param x The x values of the series, sorted in ascending order.
+    /// @param y The y values of the series.
+    /// @param interpolation How the series is evaluated between its samples (default is linear).
+    /// @return A reference to the aligned series.
+    template <typename X, typename Y>
+    auto add(const X &x, const Y &y, interpolation_t interpolation = interpolation_t::linear) -> aligned_series_t &
+    {
+        series.push_back(std::vector<double>());
+        resample(x, y, grid, interpolation, series.back());
+        return *this;
+    }
+
+    /// @brief Returns the common x values.
+    /// @return The grid.
+    auto get_grid() const -> const std::vector<double> & { return grid; }
+
+    /// @brief Returns the values of a series on the grid.
+    /// @param index The index of the series, in the order they were added.
+    /// @return The values.
+    auto get_series(std::size_t index) const -> const std::vector<double> & { return series.at(index); }
+
+    /// @brief Returns the number of series.
+    /// @return The number of series.
+    auto count() const -> std::size_t { return series.size(); }
+
+    auto columns() const -> std::size_t override { return 1 + series.size(); }
+
+    auto next_chunk(std::vector<double> &buffer) -> bool override
+    {
+        // Number of records of each chunk.
+        const std::size_t chunk_rows = 4096;
+        buffer.clear();
+        if (position >= grid.size()) {
+            position = 0;
+            return false;
+        }
+        const std::size_t end = std::min(position + chunk_rows, grid.size());
+        buffer.reserve((end - position) * this->columns());
+        for (; position < end; ++position) {
+            buffer.push_back(grid[position]);
+            for (const std::vector<double> &values : series) {
+                buffer.push_back(values[position]);
+            }
+        }
+        return true;
+    }
+
+    void rewind() override { position = 0; }
+
+private:
+    std::vector<double> grid;                ///< The common x values.
+    std::vector<std::vector<double>> series; ///< The values of each series on the grid.
+    std::size_t position{0};                 ///< The next record to provide.
+};
+
+} // namespace gpcpp
@@ -0,0 +1,269 @@
+/// @file shared_session.hpp
+/// @brief A gnuplot session that can be used by several threads at the same time.
+
+#pragma once
+
+#include "gpcpp/gnuplot.hpp"
+#include "gpcpp/mpsc_queue.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace gpcpp
+{
+
+/// @brief A thread-safe facade over a Gnuplot session.
+/// @details Any thread can submit operations, which are pushed on a lock-free queue and executed,
+/// one at a time, by the owner thread of the session, the only one touching the Gnuplot object.
+/// The owner drains the queue in batches and flushes the pipe once per batch, so many small
+/// operations end up in a single write. The operations submitted by the same thread are executed
+/// in the order they were submitted; the operations of different threads are interleaved.
+/// Operations that must appear together (e.g., all the plots of a figure) must be submitted as a
+/// single frame, with submit_frame(). The bytes held by the queued operations (e.g., the copies of
+/// the data made by plot_xy) can be limited: past the limit, the producers wait for the owner.
+class SharedSession
+{
+public:
+    /// @brief An operation executed by the owner thread on the Gnuplot session.
+    using operation_t = std::function<void(Gnuplot &)>;
+
+    /// @brief Constructor, opens the gnuplot session and starts the owner thread.
+    /// @param _debug Enables debug mode for the Gnuplot session.
+    /// @param _max_batch The maximum number of operations executed between two flushes.
+    /// @param _max_pending_bytes The maximum number of bytes held by the queued operations, 0 for no limit.
+    SharedSession(bool _debug = false, std::size_t _max_batch = 256, std::size_t _max_pending_bytes = 0)
+        : gnuplot(_debug)
+        , queue()
+        , mutex()
+        , wakeup()
+        , waiting(false)
+        , running(true)
+        , max_batch((_max_batch > 0) ? _max_batch : 1)
+        , max_pending_bytes(_max_pending_bytes)
+        , budget_mutex()
+        , released()
+        , n_pending_bytes(0)
+        , n_operations(0)
+        , n_batches(0)
+        , owner(&SharedSession::run, this)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Destructor, executes the operations still in the queue and stops the owner thread.
+    ~SharedSession()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running.store(false);
+        }
+        wakeup.notify_one();
+        if (owner.joinable()) {
+            owner.join();
+        }
+    }
+
+    /// @brief Sessions cannot be copied.
+    SharedSession(const SharedSession &) = delete;
+
+    /// @brief Sessions cannot be copied.
+    /// @return A reference to the session.
+    auto operator=(const SharedSession &) -> SharedSession & = delete;
+
+    /// @brief Submits an operation, executed later by the owner thread.
+    /// @details If the operation holds some bytes and the queued operations already hold as many
+    /// as allowed, waits until the owner has executed enough of them. It must not be called from
+    /// an operation, as the owner thread would wait for itself.
+    /// @param operation The operation, it must not call the methods of the session.
+    /// @param bytes The bytes held by the operation, counted until it is executed (default is 0).
+    /// @return A reference to the session.
+    auto submit(operation_t operation, std::size_t bytes = 0) -> SharedSession &
+    {
+        if (!operation) {
+            std::cerr << "Error: Cannot submit an empty operation.\n";
+            return *this;
+        }
+        this->acquire(bytes);
+        queue.push(pending_t{std::move(operation), bytes});
+        // Wake up the owner only if it is sleeping. Both sides update the flag with an exchange:
+        // either the owner sees the new operation, or this thread sees that the owner is waiting.
+        if (waiting.exchange(false)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            wakeup.notify_one();
+        }
+        return *this;
+    }
+
+    /// @brief Submits a whole frame, drawn between a begin_frame() and an end_frame().
+    /// @details The operations of other threads cannot end up in the middle of the frame.
+    /// @param draw The operation drawing the frame.
+    /// @return A reference to the session.
+    auto submit_frame(operation_t draw) -> SharedSession &
+    {
+        if (!draw) {
+            std::cerr << "Error: Cannot submit an empty frame.\n";
+            return *this;
+        }
+        return this->submit([draw](Gnuplot &gp) {
+            gp.begin_frame();
+            draw(gp);
+            gp.end_frame();
+        });
+    }
+
+    /// @brief Submits a command.
+    /// @param cmdstr The command.
+    /// @return A reference to the session.
+    auto send_cmd(const std::string &cmdstr) -> SharedSession &
+    {
+        return this->submit([cmdstr](Gnuplot &gp) { gp.send_cmd(cmdstr); });
+    }
+
+    /// @brief Submits a plot of y against x, the data is copied.
+    /// @details The copies are counted against the limit of pending bytes.
+    /// @param x The x values.
+    /// @param y The y values.
+    /// @param title The title of the plot.
+    /// @return A reference to the session.
+    template <typename X, typename Y>
+    auto plot_xy(const X &x, const Y &y, const std::string &title = "") -> SharedSession &
+    {
+        const std::size_t bytes = x.size() * sizeof(x[0]) + y.size() * sizeof(y[0]);
+        return this->submit([x, y, title](Gnuplot &gp) { gp.plot_xy(x, y, title); }, bytes);
+    }
+
+    /// @brief Waits until the owner thread has executed, and flushed, all the operations submitted so far by
+    /// this thread.
+    /// @details It must not be called from an operation, as the owner thread would wait for itself.
+    /// @return true if the gnuplot session is still valid, false otherwise.
+    auto wait() -> bool
+    {
+        auto done = std::make_shared<std::promise<bool>>();
+        std::future<bool> result = done->get_future();
+        this->submit([done](Gnuplot &gp) {
+            gp.flush();
+            done->set_value(gp.is_ready());
+        });
+        return result.get();
+    }
+
+    /// @brief Returns the number of operations executed so far.
+    /// @return The number of operations.
+    auto operations() const -> std::size_t { return n_operations.load(); }
+
+    /// @brief Returns the number of batches (i.e., flushes) executed so far.
+    /// @return The number of batches.
+    auto batches() const -> std::size_t { return n_batches.load(); }
+
+    /// @brief Returns the bytes held by the operations waiting to be executed.
+    /// @return The number of bytes.
+    auto pending_bytes() const -> std::size_t { return n_pending_bytes.load(); }
+
+private:
+    /// @brief An operation waiting to be executed, with the bytes it holds.
+    struct pending_t {
+        operation_t operation; ///< The operation.
+        std::size_t bytes;     ///< The bytes held by the operation.
+    };
+
+    /// @brief Waits until some bytes fit within the limit of pending bytes, then counts them.
+    /// @details An operation larger than the limit is accepted once the queue holds nothing else.
+    /// @param bytes The bytes.
+    void acquire(std::size_t bytes)
+    {
+        if ((bytes == 0) || (max_pending_bytes == 0)) {
+            n_pending_bytes += bytes;
+            return;
+        }
+        std::unique_lock<std::mutex> lock(budget_mutex);
+        released.wait(lock, [this, bytes] {
+            const std::size_t held = n_pending_bytes.load();
+            return (held == 0) || (held + bytes <= max_pending_bytes);
+        });
+        n_pending_bytes += bytes;
+    }
+
+    /// @brief Stops counting the bytes of an executed operation, and wakes up the waiting producers.
+    /// @param bytes The bytes.
+    void release(std::size_t bytes)
+    {
+        if (bytes == 0) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(budget_mutex);
+            n_pending_bytes -= bytes;
+        }
+        released.notify_all();
+    }
+
+    /// @brief The loop of the owner thread.
+    void run()
+    {
+        for (;;) {
+            const std::size_t executed = this->drain();
+            if (executed > 0) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            waiting.exchange(true);
+            // A producer may have pushed before seeing the flag, so check again before sleeping.
+            if (queue.empty() && running.load()) {
+                wakeup.wait(lock);
+            }
+            waiting.store(false);
+            if (!running.load() && queue.empty()) {
+                break;
+            }
+        }
+        // Execute the operations submitted while stopping.
+        while (this->drain() > 0) {
+        }
+    }
+
+    /// @brief Executes a batch of operations, then flushes the pipe.
+    /// @return The number of operations executed.
+    auto drain() -> std::size_t
+    {
+        pending_t pending;
+        std::size_t executed = 0;
+        while ((executed < max_batch) && queue.pop(pending)) {
+            try {
+                pending.operation(gnuplot);
+            } catch (const std::exception &e) {
+                std::cerr << "Error: An operation of the shared session failed: " << e.what() << "\n";
+            }
+            pending.operation = nullptr;
+            this->release(pending.bytes);
+            ++executed;
+            ++n_operations;
+        }
+        if (executed > 0) {
+            gnuplot.flush();
+            ++n_batches;
+        }
+        return executed;
+    }
+
+    Gnuplot gnuplot;                          ///< The session, only used by the owner thread.
+    mpsc_queue_t<pending_t> queue;            ///< The operations waiting to be executed.
+    std::mutex mutex;                         ///< Protects the sleep of the owner thread.
+    std::condition_variable wakeup;           ///< Wakes up the owner thread.
+    std::atomic<bool> waiting;                ///< Whether the owner thread is about to sleep.
+    std::atomic<bool> running;                ///< Whether the owner thread must keep running.
+    const std::size_t max_batch;              ///< The maximum number of operations between two flushes.
+    const std::size_t max_pending_bytes;      ///< The maximum number of bytes held by the queued operations.
+    std::mutex budget_mutex;                  ///< Protects the wait of the producers over the limit.
+    std::condition_variable released;         ///< Wakes up the producers when bytes are released.
+    std::atomic<std::size_t> n_pending_bytes; ///< The bytes held by the queued operations.
+    std::atomic<std::size_t> n_operations;    ///< The number of operations executed.
+    std::atomic<std::size_t> n_batches;       ///< The number of batches executed.
+    std::thread owner;                        ///< The owner thread, started last.
+};
+
+} // namespace gpcpp
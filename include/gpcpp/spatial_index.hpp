@@ -0,0 +1,239 @@
+/// @file spatial_index.hpp
+/// @brief A k-d tree answering nearest-point queries on the samples of a series.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace gpcpp
+{
+
+/// @brief The result of a nearest-point query.
+struct nearest_t {
+    bool found{false};                                         ///< Whether a sample has been found.
+    std::size_t index{0};                                      ///< The index of the sample in the series.
+    double x{0.0};                                             ///< The x value of the sample.
+    double y{0.0};                                             ///< The y value of the sample.
+    double z{std::numeric_limits<double>::quiet_NaN()};        ///< The z value of the sample, NaN for 2D series.
+    double distance{std::numeric_limits<double>::infinity()}; ///< The (scaled) distance from the queried position.
+};
+
+/// @brief A two-dimensional k-d tree over the x and y values of a series.
+/// @details The samples are stored in tree order, in a single array: each node is the median of
+/// its range along the axis with the largest spread, and small ranges are scanned linearly. The
+/// samples with a non-finite x or y cannot be found, and are left out.
+class kd_tree_t
+{
+public:
+    /// @brief Constructor, creates an empty tree.
+    kd_tree_t() = default;
+
+    /// @brief Constructor, builds the tree.
+    /// @details The first levels of the tree are built by parallel tasks.
+    /// @param x The x values.
+    /// @param y The y values, as many as the x values.
+    /// @param z The z values, either empty or as many as the x values.
+    kd_tree_t(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &z = {})
+    {
+        const std::size_t n = std::min(x.size(), y.size());
+        points.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (std::isfinite(x[i]) && std::isfinite(y[i])) {
+                const double value = (i < z.size()) ? z[i] : std::numeric_limits<double>::quiet_NaN();
+                points.push_back(point_t{x[i], y[i], value, i});
+            }
+        }
+        axes.resize(points.size(), 0);
+        this->build(0, points.size(), 0);
+    }
+
+    /// @brief Returns the number of samples in the tree.
+    /// @return The number of samples.
+    auto size() const -> std::size_t { return points.size(); }
+
+    /// @brief Finds the sample closest to a position.
+    /// @details The distance along each axis is divided by the scale of the axis, so that passing
+    /// the size of a pixel (in data units) measures the distances on screen.
+    /// @param x The x coordinate of the position.
+    /// @param y The y coordinate of the position.
+    /// @param x_scale The scale of the x axis, must be positive.
+    /// @param y_scale The scale of the y axis, must be positive.
+    /// @return The closest sample, not found if the tree is empty.
+    auto nearest(double x, double y, double x_scale = 1.0, double y_scale = 1.0) const -> nearest_t
+    {
+        nearest_t result;
+        if (points.empty() || !std::isfinite(x) || !std::isfinite(y) || !(x_scale > 0) || !(y_scale > 0)) {
+            return result;
+        }
+        query_t query{x, y, 1.0 / x_scale, 1.0 / y_scale, std::numeric_limits<double>::infinity(), 0};
+        this->search(0, points.size(), query);
+        const point_t &point = points[query.best];
+        result.found         = true;
+        result.index         = point.index;
+        result.x             = point.x;
+        result.y             = point.y;
+        result.z             = point.z;
+        result.distance      = std::sqrt(query.best_distance);
+        return result;
+    }
+
+private:
+    /// @brief A sample of the series.
+    struct point_t {
+        double x;          ///< The x value.
+        double y;          ///< The y value.
+        double z;          ///< The z value, NaN for 2D series.
+        std::size_t index; ///< The index of the sample in the series.
+    };
+
+    /// @brief The state of a query.
+    struct query_t {
+        double x;             ///< The x coordinate of the position.
+        double y;             ///< The y coordinate of the position.
+        double x_weight;      ///< The inverse of the scale of the x axis.
+        double y_weight;      ///< The inverse of the scale of the y axis.
+        double best_distance; ///< The squared distance of the closest sample found so far.
+        std::size_t best;     ///< The closest sample found so far, in tree order.
+    };
+
+    /// @brief Ranges up to this size are not split, and are scanned linearly.
+    static constexpr std::size_t leaf_size = 8;
+    /// @brief Ranges larger than this are split by two parallel tasks.
+    static constexpr std::size_t parallel_size = 1U << 16U;
+    /// @brief The number of levels that can be split by parallel tasks.
+    static constexpr unsigned parallel_depth = 3;
+
+    /// @brief Builds the subtree of a range of samples.
+    /// @param lo The first sample of the range.
+    /// @param hi The end of the range.
+    /// @param depth The depth of the subtree.
+    void build(std::size_t lo, std::size_t hi, unsigned depth)
+    {
+        if (hi - lo <= leaf_size) {
+            return;
+        }
+        // Split along the axis with the largest spread.
+        double min_x = points[lo].x, max_x = points[lo].x, min_y = points[lo].y, max_y = points[lo].y;
+        for (std::size_t i = lo + 1; i < hi; ++i) {
+            min_x = std::min(min_x, points[i].x);
+            max_x = std::max(max_x, points[i].x);
+            min_y = std::min(min_y, points[i].y);
+            max_y = std::max(max_y, points[i].y);
+        }
+        const unsigned char axis = ((max_y - min_y) > (max_x - min_x)) ? 1 : 0;
+        const std::size_t mid    = lo + (hi - lo) / 2;
+        std::nth_element(
+            points.begin() + static_cast<std::ptrdiff_t>(lo), points.begin() + static_cast<std::ptrdiff_t>(mid),
+            points.begin() + static_cast<std::ptrdiff_t>(hi), [axis](const point_t &a, const point_t &b) {
+                return (axis == 0) ? (a.x < b.x) : (a.y < b.y);
+            });
+        axes[mid] = axis;
+        // The two halves are disjoint, so they can be built at the same time.
+        if ((hi - lo > parallel_size) && (depth < parallel_depth)) {
+            std::future<void> left = std::async(std::launch::async, &kd_tree_t::build, this, lo, mid, depth + 1);
+            this->build(mid + 1, hi, depth + 1);
+            left.get();
+        } else {
+            this->build(lo, mid, depth + 1);
+            this->build(mid + 1, hi, depth + 1);
+        }
+    }
+
+    /// @brief Checks if a sample is closer than the closest one found so far.
+    /// @param i The sample, in tree order.
+    /// @param query The state of the query.
+    void visit(std::size_t i, query_t &query) const
+    {
+        const double dx       = (points[i].x - query.x) * query.x_weight;
+        const double dy       = (points[i].y - query.y) * query.y_weight;
+        const double distance = dx * dx + dy * dy;
+        if (distance < query.best_distance) {
+            query.best_distance = distance;
+            query.best          = i;
+        }
+    }
+
+    /// @brief Searches the subtree of a range of samples.
+    /// @param lo The first sample of the range.
+    /// @param hi The end of the range.
+    /// @param query The state of the query.
+    void search(std::size_t lo, std::size_t hi, query_t &query) const
+    {
+        if (hi - lo <= leaf_size) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                this->visit(i, query);
+            }
+            return;
+        }
+        const std::size_t mid = lo + (hi - lo) / 2;
+        this->visit(mid, query);
+        // Visit the side of the position first, and the other side only if it can be closer.
+        const double delta = (axes[mid] == 0) ? (query.x - points[mid].x) * query.x_weight
+                                              : (query.y - points[mid].y) * query.y_weight;
+        if (delta < 0) {
+            this->search(lo, mid, query);
+            if (delta * delta < query.best_distance) {
+                this->search(mid + 1, hi, query);
+            }
+        } else {
+            this->search(mid + 1, hi, query);
+            if (delta * delta < query.best_distance) {
+                this->search(lo, mid, query);
+            }
+        }
+    }
+
+    std::vector<point_t> points;     ///< The samples, in tree order.
+    std::vector<unsigned char> axes;   ///< The split axis of each node (0 for x, 1 for y).
+};
+
+/// @brief Builds a k-d tree, to be called by a background task.
+/// @param x The x values.
+/// @param y The y values.
+/// @param z The z values, possibly empty.
+/// @return The tree.
+static inline auto build_kd_tree(std::vector<double> x, std::vector<double> y, std::vector<double> z)
+    -> std::shared_ptr<const kd_tree_t>
+{
+    return std::make_shared<const kd_tree_t>(x, y, z);
+}
+
+/// @brief Builds a k-d tree on a background thread.
+/// @details Unlike with std::async, the thread is detached: dropping the future of a tree still
+/// being built does not wait for it, so a new plot never stalls behind the index of the previous one.
+/// @param x The x values.
+/// @param y The y values.
+/// @param z The z values, possibly empty.
+/// @return The future tree.
+static inline auto build_kd_tree_async(std::vector<double> x, std::vector<double> y, std::vector<double> z)
+    -> std::shared_future<std::shared_ptr<const kd_tree_t>>
+{
+    std::promise<std::shared_ptr<const kd_tree_t>> promise;
+    std::shared_future<std::shared_ptr<const kd_tree_t>> tree = promise.get_future().share();
+    std::thread(
+        [](std::promise<std::shared_ptr<const kd_tree_t>> result, std::vector<double> xs, std::vector<double> ys,
+           std::vector<double> zs) {
+            try {
+                result.set_value(build_kd_tree(std::move(xs), std::move(ys), std::move(zs)));
+            } catch (...) {
+                result.set_exception(std::current_exception());
+            }
+        },
+        std::move(promise),
+        std::move(x),
+        std::move(y),
+        std::move(z))
+        .detach();
+    return tree;
+}
+
+} // namespace gpcpp
@@ -0,0 +1,154 @@
+/// @file storage_budget.hpp
+/// @brief Accounting of the temporary files holding the data, evicted by least recent use.
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace gpcpp
+{
+
+/// @brief What the writers do when the data does not fit within the storage budget.
+enum class storage_policy_t : unsigned char {
+    degrade,   ///< Write fewer records, evenly spread, so that the data fits.
+    fail_fast, ///< Reject the data.
+};
+
+/// @brief Statistics about the temporary files holding the data.
+struct storage_metrics_t {
+    std::size_t resident_bytes{0};      ///< The bytes held by the temporary files.
+    std::size_t peak_resident_bytes{0}; ///< The largest number of bytes ever held by the temporary files.
+    std::size_t resident_files{0};      ///< The number of temporary files.
+    std::size_t evicted_files{0};       ///< The number of files evicted to make room.
+    std::size_t evicted_bytes{0};       ///< The bytes released by the evicted files.
+    std::size_t degraded{0};            ///< The number of writes reduced to fit within the budget.
+    std::size_t rejected{0};            ///< The number of writes rejected because the budget was exhausted.
+};
+
+/// @brief A temporary file holding data.
+struct resident_file_t {
+    std::string filename; ///< The name of the file.
+    int fd;               ///< The descriptor keeping a memory file alive, -1 for regular files.
+    std::size_t bytes;    ///< The size of the file, once measured.
+    bool measured;        ///< Whether the file has been measured since it was last written.
+};
+
+/// @brief The temporary files of a session, from the least to the most recently used.
+/// @details A list keeps the order of use, and a hash map finds the entry of a file, so
+/// adding, using and removing a file are constant-time operations. The size of a file is
+/// measured after it has been written, as the writers do not know it in advance.
+class resident_set_t
+{
+public:
+    /// @brief Adds a new file, as the most recently used one.
+    /// @param filename The name of the file.
+    /// @param fd The descriptor keeping a memory file alive, -1 for regular files.
+    void add(const std::string &filename, int fd)
+    {
+        this->remove(filename);
+        files.push_back(resident_file_t{filename, fd, 0, false});
+        index[filename] = std::prev(files.end());
+    }
+
+    /// @brief Marks a file as the most recently used one.
+    /// @param filename The name of the file.
+    /// @param rewritten Whether the file has been written again, and must be measured again.
+    /// @return true if the file is resident, false otherwise.
+    auto touch(const std::string &filename, bool rewritten = false) -> bool
+    {
+        auto it = index.find(filename);
+        if (it == index.end()) {
+            return false;
+        }
+        files.splice(files.end(), files, it->second);
+        if (rewritten) {
+            it->second->measured = false;
+        }
+        return true;
+    }
+
+    /// @brief Checks if a file is resident.
+    /// @param filename The name of the file.
+    /// @return true if the file is resident, false otherwise.
+    auto contains(const std::string &filename) const -> bool { return index.count(filename) > 0; }
+
+    /// @brief Finds a file.
+    /// @param filename The name of the file.
+    /// @return The file, nullptr if it is not resident.
+    auto find(const std::string &filename) const -> const resident_file_t *
+    {
+        auto it = index.find(filename);
+        return (it != index.end()) ? &*it->second : nullptr;
+    }
+
+    /// @brief Measures the files written since they were last measured.
+    /// @param size_of Returns the size of a file.
+    template <typename SizeOf>
+    void measure(SizeOf size_of)
+    {
+        for (resident_file_t &file : files) {
+            if (!file.measured) {
+                total -= file.bytes;
+                file.bytes    = size_of(file.filename);
+                file.measured = true;
+                total += file.bytes;
+            }
+        }
+    }
+
+    /// @brief Finds the least recently used file that can be evicted.
+    /// @param evictable Tells whether a file can be evicted.
+    /// @return The file, nullptr if none can be evicted.
+    template <typename Evictable>
+    auto least_recent(Evictable evictable) const -> const resident_file_t *
+    {
+        for (const resident_file_t &file : files) {
+            if (evictable(file)) {
+                return &file;
+            }
+        }
+        return nullptr;
+    }
+
+    /// @brief Forgets a file.
+    /// @param filename The name of the file.
+    void remove(const std::string &filename)
+    {
+        auto it = index.find(filename);
+        if (it != index.end()) {
+            total -= it->second->bytes;
+            files.erase(it->second);
+            index.erase(it);
+        }
+    }
+
+    /// @brief Forgets all the files.
+    void clear()
+    {
+        files.clear();
+        index.clear();
+        total = 0;
+    }
+
+    /// @brief Returns the bytes held by the measured files.
+    /// @return The number of bytes.
+    auto bytes() const -> std::size_t { return total; }
+
+    /// @brief Returns the number of files.
+    /// @return The number of files.
+    auto size() const -> std::size_t { return files.size(); }
+
+private:
+    /// @brief The files, from the least to the most recently used.
+    std::list<resident_file_t> files;
+    /// @brief The entry of each file.
+    std::unordered_map<std::string, std::list<resident_file_t>::iterator> index;
+    /// @brief The bytes held by the measured files.
+    std::size_t total{0};
+};
+
+} // namespace gpcpp
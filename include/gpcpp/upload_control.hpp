@@ -0,0 +1,46 @@
+/// @file upload_control.hpp
+/// @brief Progress reporting and cancellation of the uploads, for the callers that cannot wait for them.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace gpcpp
+{
+
+/// @brief Called while an upload is written, with the number of records written so far and the
+/// total number of records (0 if it is not known in advance, as for chunked sources).
+using upload_progress_t = std::function<void(std::size_t written, std::size_t total)>;
+
+/// @brief A flag cancelling the uploads of a session, shared by all its copies.
+/// @details The session checks it between chunks of records, from the thread running the upload,
+/// while another thread (e.g., the UI one) cancels it through its own copy. Once cancelled, it
+/// cancels every upload until it is reset.
+class cancel_token_t
+{
+public:
+    /// @brief Constructor, the token is not cancelled.
+    cancel_token_t()
+        : flag(std::make_shared<std::atomic<bool>>(false))
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Cancels the uploads in progress, and the following ones.
+    void cancel() { flag->store(true); }
+
+    /// @brief Allows the uploads again.
+    void reset() { flag->store(false); }
+
+    /// @brief Checks if the token has been cancelled.
+    /// @return true if the token has been cancelled, false otherwise.
+    auto is_cancelled() const -> bool { return flag->load(); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag; ///< The flag shared by the copies of the token.
+};
+
+} // namespace gpcpp
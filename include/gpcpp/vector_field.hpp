@@ -0,0 +1,231 @@
+/// @file vector_field.hpp
+/// @brief Subsampling of vector fields, so that a large field is drawn with a readable number of arrows.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace gpcpp
+{
+
+/// @brief How the arrows of a vector field are chosen, when there are too many of them.
+enum class vector_sampling_t : unsigned char {
+    stride,    ///< Every k-th arrow, in the order of the data. The cheapest, suited to data without spatial order.
+    grid,      ///< The arrow closest to the center of each cell of a regular grid, evenly covering the field.
+    magnitude, ///< The longest arrow of each cell of a regular grid, so the strongest flow of each region is kept.
+};
+
+/// @brief Converts a vector sampling mode to a string.
+/// @param sampling The sampling mode.
+/// @return The name of the mode.
+static inline auto vector_sampling_to_string(vector_sampling_t sampling) -> const char *
+{
+    switch (sampling) {
+    case vector_sampling_t::stride:
+        return "stride";
+    case vector_sampling_t::grid:
+        return "grid";
+    case vector_sampling_t::magnitude:
+        return "magnitude";
+    }
+    return "unknown";
+}
+
+/// @brief A view on some rows of a column, so that they can be written without copying them.
+/// @tparam C The type of the column.
+template <typename C>
+class indexed_column_t
+{
+public:
+    /// @brief Constructor.
+    /// @param _column The column.
+    /// @param _rows The rows of the column seen through the view, in order.
+    indexed_column_t(const C &_column, const std::vector<std::size_t> &_rows)
+        : column(&_column)
+        , rows(&_rows)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns a value of the view.
+    /// @param k The position in the view.
+    /// @return The value of the column on the k-th row of the view.
+    auto operator[](std::size_t k) const -> double { return static_cast<double>((*column)[(*rows)[k]]); }
+
+    /// @brief Returns the number of rows of the view.
+    /// @return The number of rows.
+    auto size() const -> std::size_t { return rows->size(); }
+
+private:
+    const C *column;                      ///< The column.
+    const std::vector<std::size_t> *rows; ///< The rows seen through the view.
+};
+
+/// @brief Creates a view on some rows of a column.
+/// @param column The column.
+/// @param rows The rows of the column seen through the view, in order.
+/// @return The view.
+template <typename C>
+inline auto indexed_column(const C &column, const std::vector<std::size_t> &rows) -> indexed_column_t<C>
+{
+    return indexed_column_t<C>(column, rows);
+}
+
+/// @brief Chooses the arrows of a vector field to draw, so that there are at most a given number.
+/// @details With stride, every k-th arrow is kept. With grid and magnitude, the bounding box of
+/// the field is split into at most `max_arrows` cells of the same size (the longest axis gets the
+/// most cells), and a single pass keeps one arrow per cell: the one closest to the center of the
+/// cell, or the longest one. The cost is linear, with one entry per cell, so fields of millions of
+/// arrows are reduced without sorting them. The arrows holding a non-finite value are never chosen.
+/// @param count The number of arrows.
+/// @param x The x coordinates of the arrows.
+/// @param y The y coordinates of the arrows.
+/// @param z The z coordinates of the arrows, nullptr for 2D fields.
+/// @param dx The x components of the arrows.
+/// @param dy The y components of the arrows.
+/// @param dz The z components of the arrows, nullptr for 2D fields.
+/// @param max_arrows The largest number of arrows, 0 for no limit.
+/// @param sampling How the arrows are chosen.
+/// @param kept Receives the chosen arrows, in ascending order.
+/// @return `false` if all the arrows are kept (`kept` is then empty), `true` if only the arrows in
+/// `kept` are, which may be none of them if no arrow is finite.
+template <typename X, typename Y, typename Z, typename DX, typename DY, typename DZ>
+inline auto subsample_vectors(
+    std::size_t count,
+    const X &x,
+    const Y &y,
+    const Z *z,
+    const DX &dx,
+    const DY &dy,
+    const DZ *dz,
+    std::size_t max_arrows,
+    vector_sampling_t sampling,
+    std::vector<std::size_t> &kept) -> bool
+{
+    kept.clear();
+    if ((max_arrows == 0) || (count <= max_arrows)) {
+        return false;
+    }
+    auto position = [&x, &y, z](std::size_t i, std::size_t axis) {
+        return (axis == 0) ? static_cast<double>(x[i])
+                           : ((axis == 1) ? static_cast<double>(y[i]) : static_cast<double>((*z)[i]));
+    };
+    auto finite = [&position, &dx, &dy, dz](std::size_t i, std::size_t axes) {
+        bool ok = std::isfinite(static_cast<double>(dx[i])) && std::isfinite(static_cast<double>(dy[i]));
+        ok      = ok && ((dz == nullptr) || std::isfinite(static_cast<double>((*dz)[i])));
+        for (std::size_t axis = 0; axis < axes; ++axis) {
+            ok = ok && std::isfinite(position(i, axis));
+        }
+        return ok;
+    };
+    const std::size_t axes = (z != nullptr) ? 3 : 2;
+
+    if (sampling == vector_sampling_t::stride) {
+        const std::size_t step = (count + max_arrows - 1) / max_arrows;
+        kept.reserve(max_arrows);
+        for (std::size_t i = 0; i < count; i += step) {
+            if (finite(i, axes)) {
+                kept.push_back(i);
+            }
+        }
+        return true;
+    }
+
+    // The bounding box of the field.
+    double lower[3] = {0.0, 0.0, 0.0}, upper[3] = {0.0, 0.0, 0.0};
+    bool found = false;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!finite(i, axes)) {
+            continue;
+        }
+        for (std::size_t axis = 0; axis < axes; ++axis) {
+            const double p = position(i, axis);
+            lower[axis]    = found ? (std::min)(lower[axis], p) : p;
+            upper[axis]    = found ? (std::max)(upper[axis], p) : p;
+        }
+        found = true;
+    }
+    if (!found) {
+        return true;
+    }
+
+    // Cells of the same size along every axis, at most `max_arrows` of them. An axis thinner than
+    // a cell gets a single one, and the size is computed again over the other axes.
+    bool spread[3] = {false, false, false};
+    for (std::size_t axis = 0; axis < axes; ++axis) {
+        spread[axis] = upper[axis] > lower[axis];
+    }
+    double side = 1.0;
+    for (bool changed = true; changed;) {
+        double volume     = 1.0;
+        std::size_t spans = 0;
+        for (std::size_t axis = 0; axis < axes; ++axis) {
+            if (spread[axis]) {
+                volume *= upper[axis] - lower[axis];
+                ++spans;
+            }
+        }
+        side    = (spans > 0) ? std::pow(volume / static_cast<double>(max_arrows), 1.0 / static_cast<double>(spans))
+                              : 1.0;
+        changed = false;
+        for (std::size_t axis = 0; axis < axes; ++axis) {
+            if (spread[axis] && (upper[axis] - lower[axis] < side)) {
+                spread[axis] = false;
+                changed      = true;
+            }
+        }
+    }
+    std::size_t cells[3] = {1, 1, 1};
+    for (std::size_t axis = 0; axis < axes; ++axis) {
+        if (spread[axis]) {
+            cells[axis] = (std::max)(std::size_t{1}, static_cast<std::size_t>((upper[axis] - lower[axis]) / side));
+        }
+    }
+
+    // A single pass keeps the best arrow of each cell.
+    const std::size_t none  = std::numeric_limits<std::size_t>::max();
+    const std::size_t total = cells[0] * cells[1] * cells[2];
+    std::vector<std::size_t> best(total, none);
+    std::vector<double> score(total, 0.0);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!finite(i, axes)) {
+            continue;
+        }
+        std::size_t cell = 0;
+        double offset    = 0.0;
+        for (std::size_t axis = axes; axis-- > 0;) {
+            const double extent = upper[axis] - lower[axis];
+            const double f      = spread[axis]
+                                      ? (position(i, axis) - lower[axis]) / extent * static_cast<double>(cells[axis])
+                                      : 0.0;
+            const std::size_t c = (std::min)(cells[axis] - 1, static_cast<std::size_t>(f));
+            const double d      = spread[axis] ? f - static_cast<double>(c) - 0.5 : 0.0;
+            cell                = cell * cells[axis] + c;
+            offset += d * d;
+        }
+        double value = -offset;
+        if (sampling == vector_sampling_t::magnitude) {
+            const double u = static_cast<double>(dx[i]), v = static_cast<double>(dy[i]);
+            const double w = (dz != nullptr) ? static_cast<double>((*dz)[i]) : 0.0;
+            value          = u * u + v * v + w * w;
+        }
+        if ((best[cell] == none) || (value > score[cell])) {
+            best[cell]  = i;
+            score[cell] = value;
+        }
+    }
+    kept.reserve(total);
+    for (std::size_t i : best) {
+        if (i != none) {
+            kept.push_back(i);
+        }
+    }
+    std::sort(kept.begin(), kept.end());
+    return true;
+}
+
+} // namespace gpcpp
@@ -0,0 +1,25 @@
+/// @file workers.hpp
+/// @brief Sizing of the pools of worker threads splitting a computation into blocks.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+
+namespace gpcpp
+{
+
+/// @brief Returns the number of workers to use.
+/// @param workers The requested number of workers, 0 for the number of hardware threads.
+/// @param tasks The number of independent tasks.
+/// @return The number of workers, between 1 and the number of tasks.
+static inline auto worker_count(std::size_t workers, std::size_t tasks) -> std::size_t
+{
+    if (workers == 0) {
+        workers = (std::max)(1U, std::thread::hardware_concurrency());
+    }
+    return (std::max)(std::size_t{1}, (std::min)(workers, tasks));
+}
+
+} // namespace gpcpp
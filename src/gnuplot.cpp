@@ -0,0 +1,18 @@
+/// @file gnuplot.cpp
+/// @brief Compiles the gpcpp library, with the instantiations of the templates for the common containers.
+/// @copyright Copyright (c) 2025 Enrico Fraccaroli <enry.frak@gmail.com>
+
+#if !defined(GPCPP_COMPILED_LIB)
+#error "GPCPP_COMPILED_LIB must be defined when compiling the library."
+#endif
+
+#include "gpcpp/gnuplot.hpp"
+#include "gpcpp/gnuplot.i.hpp"
+
+namespace gpcpp
+{
+
+GPCPP_TEMPLATE_INSTANCES(, double)
+GPCPP_TEMPLATE_INSTANCES(, float)
+
+} // namespace gpcpp